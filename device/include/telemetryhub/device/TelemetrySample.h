@@ -1,17 +1,40 @@
 #pragma once
 
-#include <chrono>
 #include <cstdint>
-#include <string>
+#include <type_traits>
+#include "telemetryhub/device/Timestamp.h"
+#include "telemetryhub/device/UnitRegistry.h"
 
 namespace telemetryhub::device {
 
+// Measurements are bulk traffic. Status items report a device state change
+// (the new DeviceState, as a number, in `value`) and ride the gateway queue's
+// priority lane, overtaking any queued measurements.
+enum class SampleKind : std::uint8_t
+{
+    Measurement,
+    Status
+};
+
+// 32 bytes and trivially copyable: a copy through the queue, latest_ or a
+// pool job is a memcpy, never an allocation. The unit is an interned id
+// (see UnitRegistry); `s.unit = "V"`, `s.unit == "V"` and `os << s.unit`
+// work as they did with a string, `s.unit.str()` gives the name.
 struct TelemetrySample
 {
-    std::chrono::system_clock::time_point timestamp{};
+    // Wall clock, ns since the Unix epoch (wall_ns(); to_system_time() converts)
+    std::int64_t timestamp_ns = 0;
     double value = 0.0;
-    std::string unit{"unitless"};
     std::uint32_t sequence_id = 0;
+    // Source identity; (device_id, channel) is the key a conflating queue
+    // keeps only the latest value for.
+    std::uint32_t device_id = 0;
+    std::uint16_t channel = 0;
+    Unit unit{};
+    SampleKind kind = SampleKind::Measurement;
 };
 
+static_assert(std::is_trivially_copyable_v<TelemetrySample>);
+static_assert(sizeof(TelemetrySample) <= 32);
+
 } // namespace telemetryhub::device
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TELEMETRYHUB_HAS_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define TELEMETRYHUB_HAS_TSC 0
+#endif
+
+namespace telemetryhub::device {
+
+enum class TimestampSource : std::uint8_t
+{
+    Tsc,        ///< Invariant TSC scaled to ns, re-anchored to steady_clock
+    SteadyClock ///< No usable TSC: plain steady_clock / system_clock reads
+};
+
+/**
+ * @brief Cheap int64 nanosecond timestamps for samples and pipeline stamps
+ *
+ * mono_ns() is on the steady_clock epoch, so it can be compared with
+ * steady_clock deadlines; wall_ns() is nanoseconds since the Unix epoch.
+ *
+ * On x86 with an invariant TSC a read is one rdtsc plus a multiply (no
+ * syscall, no vDSO call). The tick rate is calibrated against steady_clock
+ * on first use and re-anchored about once a second: the scale is refined
+ * over the whole run and any drift is slewed out over the next interval, so
+ * mono_ns() stays continuous and monotonic. The wall-clock offset is
+ * refreshed at the same anchors, so wall_ns() follows NTP within a second.
+ * Everywhere else both functions fall back to the std clocks.
+ */
+inline std::int64_t mono_ns();
+inline std::int64_t wall_ns();
+TimestampSource timestamp_source();
+const char* to_string(TimestampSource source);
+
+inline std::chrono::system_clock::time_point to_system_time(std::int64_t wall_ns)
+{
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(wall_ns)));
+}
+
+namespace detail {
+
+inline std::int64_t steady_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline std::int64_t system_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+enum : std::uint8_t { kModeUninit = 0, kModeTsc = 1, kModeSteady = 2 };
+
+// Anchor parameters, published under a seqlock so readers never see a base
+// from one anchor paired with a scale from another.
+struct TimestampState {
+    std::atomic<std::uint8_t> mode{kModeUninit};
+    std::atomic<std::uint32_t> seq{0};
+    std::atomic<std::uint64_t> base_tsc{0};
+    std::atomic<std::int64_t> base_ns{0};
+    std::atomic<double> ns_per_tick{0.0};
+    std::atomic<std::int64_t> wall_offset_ns{0};
+    std::atomic<std::uint64_t> next_anchor_tsc{0};
+};
+extern TimestampState g_timestamp_state;
+
+// Calibrates on first use, re-anchors when due, or reads the std clock.
+std::int64_t mono_ns_slow();
+
+#if TELEMETRYHUB_HAS_TSC
+inline std::uint64_t read_tsc() { return __rdtsc(); }
+
+inline std::int64_t tsc_to_ns(const TimestampState& st, std::uint64_t tsc)
+{
+    for (;;) {
+        const std::uint32_t s1 = st.seq.load(std::memory_order_acquire);
+        const std::uint64_t base_tsc = st.base_tsc.load(std::memory_order_relaxed);
+        const std::int64_t base_ns = st.base_ns.load(std::memory_order_relaxed);
+        const double scale = st.ns_per_tick.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((s1 & 1u) == 0 && st.seq.load(std::memory_order_relaxed) == s1) {
+            // A core whose TSC read lands just before the anchor counts as the anchor
+            const std::uint64_t ticks = tsc > base_tsc ? tsc - base_tsc : 0;
+            return base_ns + static_cast<std::int64_t>(static_cast<double>(ticks) * scale);
+        }
+    }
+}
+#endif
+
+} // namespace detail
+
+inline std::int64_t mono_ns()
+{
+#if TELEMETRYHUB_HAS_TSC
+    const auto& st = detail::g_timestamp_state;
+    if (st.mode.load(std::memory_order_acquire) == detail::kModeTsc) {
+        const std::uint64_t tsc = detail::read_tsc();
+        if (tsc < st.next_anchor_tsc.load(std::memory_order_relaxed)) {
+            return detail::tsc_to_ns(st, tsc);
+        }
+    }
+    return detail::mono_ns_slow();
+#else
+    return detail::steady_ns();
+#endif
+}
+
+inline std::int64_t wall_ns()
+{
+#if TELEMETRYHUB_HAS_TSC
+    const auto& st = detail::g_timestamp_state;
+    if (st.mode.load(std::memory_order_acquire) == detail::kModeTsc) {
+        const std::int64_t mono = mono_ns();
+        return mono + st.wall_offset_ns.load(std::memory_order_relaxed);
+    }
+#endif
+    return detail::system_ns();
+}
+
+} // namespace telemetryhub::device
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace telemetryhub::device {
+
+/**
+ * @brief Process-wide table of unit names, interned to small integer ids
+ *
+ * Samples carry a 16-bit Unit id instead of a std::string, which keeps
+ * TelemetrySample trivially copyable (no heap traffic on queue hops or
+ * pool submits). Re-interning a known name is lock-free and allocation-free
+ * for the first kFastScan units (a scan of the published names); beyond
+ * that it takes the mutex for a heterogeneous map lookup, and only a new
+ * name allocates. Name lookups are lock-free. Names are never removed, so a
+ * reference returned by name() stays valid for the life of the process.
+ *
+ * Id 0 is "unitless". Throws std::length_error past kMaxUnits names.
+ */
+class UnitRegistry
+{
+public:
+    static constexpr std::uint16_t kMaxUnits = 1024;
+    // Ids checked without the lock before falling back to the map
+    static constexpr std::size_t kFastScan = 32;
+
+    static UnitRegistry& instance();
+
+    std::uint16_t intern(std::string_view name);
+    const std::string& name(std::uint16_t id) const;
+    std::size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    UnitRegistry();
+
+    // Lets ids_.find() take a string_view without building a std::string
+    struct NameHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::uint16_t, NameHash, std::equal_to<>> ids_;
+    std::array<std::atomic<const std::string*>, kMaxUnits> names_{};
+    std::atomic<std::size_t> count_{0};
+};
+
+/**
+ * @brief Interned unit id; two bytes, trivially copyable
+ *
+ * Assigning or constructing from a string interns it. Hot paths that stamp
+ * the same unit on every sample should keep a Unit around and copy it.
+ */
+class Unit
+{
+public:
+    constexpr Unit() = default;
+    explicit Unit(std::string_view name) : id_(UnitRegistry::instance().intern(name)) {}
+
+    Unit& operator=(std::string_view name)
+    {
+        id_ = UnitRegistry::instance().intern(name);
+        return *this;
+    }
+    Unit& operator=(const char* name) { return *this = std::string_view(name); }
+    Unit& operator=(const std::string& name) { return *this = std::string_view(name); }
+
+    static constexpr Unit from_id(std::uint16_t id)
+    {
+        Unit u;
+        u.id_ = id;
+        return u;
+    }
+
+    std::uint16_t id() const { return id_; }
+    const std::string& str() const { return UnitRegistry::instance().name(id_); }
+
+    friend bool operator==(Unit a, Unit b) { return a.id_ == b.id_; }
+    friend bool operator==(Unit a, std::string_view name) { return a.str() == name; }
+
+private:
+    std::uint16_t id_ = 0; // "unitless"
+};
+
+inline std::ostream& operator<<(std::ostream& os, Unit unit)
+{
+    return os << unit.str();
+}
+
+} // namespace telemetryhub::device
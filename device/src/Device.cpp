@@ -13,6 +13,7 @@ struct Device::Impl
     std::uint32_t sequence = 0;
     std::mt19937_64 rng{std::random_device{}()}; // random number generator
     std::normal_distribution<double> noise_dist{0.0, 0.1}; // Gaussian noise
+    Unit unit{"arb.units"}; // interned once, copied onto every sample
     std::uniform_real_distribution<double> error_dist{0.0, 1.0}; // For random errors
 
     // Fault simulation - deterministic threshold
@@ -32,14 +33,12 @@ struct Device::Impl
 
     TelemetrySample make_sample()
     {
-        using clock = std::chrono::system_clock;
-
         TelemetrySample s;
-        s.timestamp = clock::now();
+        s.timestamp_ns = wall_ns();
         // Simple fake waveform: 42 + small sine + random noise
         const double t = static_cast<double>(sequence) / 10.0;
         s.value = 42.0 + std::sin(t) + noise_dist(rng);
-        s.unit = "arb.units";
+        s.unit = unit;
         s.sequence_id = sequence++;
         return s;
     }
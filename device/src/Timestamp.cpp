@@ -0,0 +1,175 @@
+#include "telemetryhub/device/Timestamp.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if TELEMETRYHUB_HAS_TSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace telemetryhub::device {
+
+namespace detail {
+TimestampState g_timestamp_state;
+}
+
+namespace {
+
+using detail::g_timestamp_state;
+
+constexpr std::int64_t kAnchorIntervalNs = 1'000'000'000; // re-anchor about once a second
+constexpr std::int64_t kStepThresholdNs = 10'000'000;     // larger drift: step, don't slew
+
+std::mutex g_anchor_mutex;
+// First calibration point; the scale is refined over the whole baseline
+std::uint64_t g_origin_tsc = 0;
+std::int64_t g_origin_ns = 0;
+
+#if TELEMETRYHUB_HAS_TSC
+bool invariant_tsc()
+{
+    // TELEMETRYHUB_TIMESTAMPS=steady forces the fallback (VMs with an unstable TSC)
+    if (const char* env = std::getenv("TELEMETRYHUB_TIMESTAMPS"); env && std::string(env) == "steady") {
+        return false;
+    }
+    // CPUID 0x80000007, EDX bit 8: TSC ticks at a constant rate in all P/C-states
+#if defined(_MSC_VER)
+    int regs[4] = {};
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+        return false;
+    }
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) {
+        return false;
+    }
+    __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#endif
+}
+
+// Caller holds g_anchor_mutex.
+void publish(std::uint64_t base_tsc, std::int64_t base_ns, double scale, std::int64_t wall_offset)
+{
+    auto& st = g_timestamp_state;
+    const std::uint32_t s = st.seq.load(std::memory_order_relaxed);
+    st.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    st.base_tsc.store(base_tsc, std::memory_order_relaxed);
+    st.base_ns.store(base_ns, std::memory_order_relaxed);
+    st.ns_per_tick.store(scale, std::memory_order_relaxed);
+    st.wall_offset_ns.store(wall_offset, std::memory_order_relaxed);
+    st.seq.store(s + 2, std::memory_order_release);
+    st.next_anchor_tsc.store(base_tsc + static_cast<std::uint64_t>(kAnchorIntervalNs / scale),
+                             std::memory_order_relaxed);
+}
+
+// Caller holds g_anchor_mutex. Two-point calibration over ~2 ms; the first
+// re-anchor a second later already uses a 500x longer baseline.
+void calibrate()
+{
+    const std::uint64_t t0 = detail::read_tsc();
+    const std::int64_t n0 = detail::steady_ns();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    const std::uint64_t t1 = detail::read_tsc();
+    const std::int64_t n1 = detail::steady_ns();
+    if (t1 <= t0 || n1 <= n0) {
+        g_timestamp_state.mode.store(detail::kModeSteady, std::memory_order_release);
+        return;
+    }
+    g_origin_tsc = t0;
+    g_origin_ns = n0;
+    const double scale = static_cast<double>(n1 - n0) / static_cast<double>(t1 - t0);
+    publish(t1, n1, scale, detail::system_ns() - n1);
+    g_timestamp_state.mode.store(detail::kModeTsc, std::memory_order_release);
+}
+
+// Caller holds g_anchor_mutex.
+void reanchor(std::uint64_t tsc)
+{
+    auto& st = g_timestamp_state;
+    if (tsc < st.next_anchor_tsc.load(std::memory_order_relaxed)) {
+        return; // another thread got here first
+    }
+    const std::int64_t steady = detail::steady_ns();
+    const std::int64_t wall = detail::system_ns();
+    const std::int64_t current = detail::tsc_to_ns(st, tsc); // keeps the timeline continuous
+
+    double scale = st.ns_per_tick.load(std::memory_order_relaxed);
+    if (tsc > g_origin_tsc && steady > g_origin_ns) {
+        scale = static_cast<double>(steady - g_origin_ns) / static_cast<double>(tsc - g_origin_tsc);
+    }
+    std::int64_t base = current;
+    const std::int64_t error = steady - current;
+    if (error > kStepThresholdNs) {
+        base = steady; // e.g. after a suspend; only ever step forwards
+    } else {
+        // Slew: run slightly fast/slow so the error is gone by the next anchor
+        const double slew = std::clamp(static_cast<double>(error) / kAnchorIntervalNs, -0.01, 0.01);
+        scale *= 1.0 + slew;
+    }
+    publish(tsc, base, scale, wall - steady);
+}
+#endif
+
+} // namespace
+
+namespace detail {
+
+std::int64_t mono_ns_slow()
+{
+#if TELEMETRYHUB_HAS_TSC
+    auto& st = g_timestamp_state;
+    std::uint8_t mode = st.mode.load(std::memory_order_acquire);
+    if (mode == kModeUninit) {
+        std::lock_guard lock(g_anchor_mutex);
+        if (st.mode.load(std::memory_order_acquire) == kModeUninit) {
+            if (invariant_tsc()) {
+                calibrate();
+            } else {
+                st.mode.store(kModeSteady, std::memory_order_release);
+            }
+        }
+        mode = st.mode.load(std::memory_order_acquire);
+    }
+    if (mode == kModeTsc) {
+        const std::uint64_t tsc = read_tsc();
+        if (tsc >= st.next_anchor_tsc.load(std::memory_order_relaxed)) {
+            // One thread re-anchors; the others carry on with the old anchor
+            std::unique_lock lock(g_anchor_mutex, std::try_to_lock);
+            if (lock.owns_lock()) {
+                reanchor(tsc);
+            }
+        }
+        return tsc_to_ns(st, tsc);
+    }
+#endif
+    return steady_ns();
+}
+
+} // namespace detail
+
+TimestampSource timestamp_source()
+{
+    (void)mono_ns(); // make sure the source has been chosen
+    return detail::g_timestamp_state.mode.load(std::memory_order_acquire) == detail::kModeTsc
+        ? TimestampSource::Tsc
+        : TimestampSource::SteadyClock;
+}
+
+const char* to_string(TimestampSource source)
+{
+    switch (source) {
+        case TimestampSource::Tsc:         return "tsc";
+        case TimestampSource::SteadyClock: return "steady_clock";
+    }
+    return "unknown";
+}
+
+} // namespace telemetryhub::device
@@ -0,0 +1,52 @@
+#include "telemetryhub/device/UnitRegistry.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace telemetryhub::device {
+
+UnitRegistry& UnitRegistry::instance()
+{
+    static UnitRegistry registry;
+    return registry;
+}
+
+UnitRegistry::UnitRegistry()
+{
+    intern("unitless"); // id 0, what a default-constructed Unit means
+}
+
+std::uint16_t UnitRegistry::intern(std::string_view name)
+{
+    // Published names never change, so the common case (a unit that is
+    // already known) needs neither the lock nor a temporary string
+    const std::size_t published = std::min(count_.load(std::memory_order_acquire), kFastScan);
+    for (std::size_t id = 0; id < published; ++id) {
+        if (*names_[id].load(std::memory_order_acquire) == name) {
+            return static_cast<std::uint16_t>(id);
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const std::size_t id = count_.load(std::memory_order_relaxed);
+    if (id >= kMaxUnits) {
+        throw std::length_error("UnitRegistry: too many distinct units");
+    }
+    it = ids_.emplace(std::string(name), static_cast<std::uint16_t>(id)).first;
+    // unordered_map nodes are stable, so readers can hold on to the key
+    names_[id].store(&it->first, std::memory_order_release);
+    count_.store(id + 1, std::memory_order_release);
+    return it->second;
+}
+
+const std::string& UnitRegistry::name(std::uint16_t id) const
+{
+    const std::string* n = id < kMaxUnits ? names_[id].load(std::memory_order_acquire) : nullptr;
+    return n ? *n : *names_[0].load(std::memory_order_acquire);
+}
+
+} // namespace telemetryhub::device
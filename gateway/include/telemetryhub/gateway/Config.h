@@ -1,13 +1,57 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "telemetryhub/gateway/Log.h"
+#include "telemetryhub/gateway/LoopModel.h"
+#include "telemetryhub/gateway/OffloadMode.h"
+#include "telemetryhub/gateway/QueuePolicy.h"
+#include "telemetryhub/gateway/WaitStrategy.h"
 
 namespace telemetryhub::gateway {
 
 struct AppConfig {
   std::chrono::milliseconds sampling_interval{std::chrono::milliseconds(100)};
   size_t queue_size{0}; // 0 = unbounded
+  size_t producer_batch_size{1}; // samples per push_bulk() from the producer
+  QueueBackend queue_backend{QueueBackend::Mutex}; // mutex | spsc | mpmc | conflating
+  // drop_oldest | drop_newest | block | decimate | spill
+  BackpressurePolicy queue_policy{BackpressurePolicy::DropOldest};
+  std::chrono::milliseconds queue_block_timeout{std::chrono::milliseconds(10)}; // policy=block
+  uint32_t queue_decimate_n{4}; // policy=decimate: admit every Nth sample on overflow
+  std::string queue_spill_dir;  // policy=spill: segment directory (empty = temp dir)
+  size_t queue_spill_segment_mb{16};
+  // AQM: drop samples queued longer than the target once the delay persists
+  // for the interval (0 = off; interval 0 = hard age limit)
+  std::chrono::milliseconds queue_sojourn_target{std::chrono::milliseconds(0)};
+  std::chrono::milliseconds queue_sojourn_interval{std::chrono::milliseconds(100)};
+  // Idle waits: block | spin | spin_then_park | futex
+  WaitStrategy queue_wait_strategy{WaitStrategy::SpinThenPark};
+  WaitStrategy pool_wait_strategy{WaitStrategy::Block};
+  // Preallocate at start and keep the pipeline off the heap afterwards
+  // (needs a bounded queue; see GatewayCore::set_zero_heap)
+  bool zero_heap{false};
+  // CPU pinning per thread role, e.g. "2" or "4-7,12" (empty = unpinned)
+  std::vector<int> producer_cpus;
+  std::vector<int> consumer_cpus;
+  std::vector<int> pool_cpus;
+  // Pool workers: start with min, grow to max under backlog, shrink back
+  // after a lull (max 0 = one per hardware thread; min == max = fixed)
+  size_t pool_min_threads{1};
+  size_t pool_max_threads{0};
+  // Run each device's batches in arrival order (per-device strands)
+  bool pool_ordered{false};
+  // Batch processing: auto | pool | inline; auto runs a batch on the consumer
+  // while its measured cost is under the threshold
+  OffloadMode pool_offload{OffloadMode::Auto};
+  std::chrono::microseconds pool_offload_threshold{kDefaultOffloadThreshold};
+  // Producer/consumer loops: threads | coroutines (both on one thread) |
+  // single (loops and processing on one thread, no pool)
+  LoopModel loop_model{LoopModel::Threads};
+  // Build queue/pool storage on the CPUs of the threads that use it
+  bool numa_local{false};
   ::telemetryhub::LogLevel log_level{::telemetryhub::LogLevel::Info};
 };
 
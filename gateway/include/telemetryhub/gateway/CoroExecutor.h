@@ -0,0 +1,310 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "telemetryhub/gateway/LoopModel.h"
+
+namespace telemetryhub::device {
+class IBus;
+}
+
+namespace telemetryhub::gateway {
+
+class CoroExecutor;
+class SampleBatch;
+class TelemetryQueue;
+
+/**
+ * @brief Fire-and-forget coroutine started with CoroExecutor::spawn()
+ *
+ * Created suspended; spawn() hands the frame to a loop thread, and the frame
+ * frees itself when the body returns. A CoTask that is never spawned
+ * destroys its frame. The body must not throw (as with ThreadPool::post):
+ * an escaping exception terminates.
+ */
+class CoTask
+{
+public:
+    struct promise_type {
+        CoroExecutor* executor{nullptr};
+
+        CoTask get_return_object() noexcept
+        {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    CoTask(CoTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    CoTask& operator=(CoTask&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+    ~CoTask()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+private:
+    friend class CoroExecutor;
+    explicit CoTask(std::coroutine_handle<promise_type> h) : handle_(h) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Runs many coroutines (device loops) on a few threads
+ *
+ * Each executor thread ("thub-coro-<i>") runs an event loop: a ready list,
+ * a timer heap and an inbox other threads post wakeups to. A coroutine
+ * stays on the loop it was spawned on, so everything one coroutine touches
+ * is single-threaded, and a loop with nothing ready sleeps until its next
+ * timer or a wakeup (one condition variable wait for the whole loop, not
+ * one per device).
+ *
+ * Awaitables (valid only inside a coroutine running on an executor):
+ *  - sleep_for / sleep_until: a timer node in the coroutine frame
+ *  - yield(): go to the back of this loop's ready list
+ *  - async_pop_batch(queue, ...): suspends until the queue has items or
+ *    shuts down; the queue wakes it through its AsyncSignal
+ *  - async_read(bus, ...): IBus has no readiness notification (the
+ *    simulated buses poll), so the read is retried from the timer heap
+ *    every `poll` until data arrives or the timeout passes
+ *
+ * Nothing here blocks a loop thread except a coroutine's own synchronous
+ * calls, so a coroutine must not wait any other way (std::this_thread::
+ * sleep_for, a blocking queue push): that stalls every coroutine on the
+ * loop. Timers, ready lists and the inbox keep their capacity, so a loop
+ * does not allocate once it has reached its steady number of coroutines.
+ * Frames are allocated once per spawn().
+ */
+class CoroExecutor
+{
+public:
+    /**
+     * @param threads Loop threads (at least one)
+     * @param cpus CPUs for the loop threads, one each round-robin (empty = unpinned)
+     */
+    explicit CoroExecutor(size_t threads = 1, std::vector<int> cpus = {});
+
+    /**
+     * @brief Waits until every spawned coroutine has finished, then stops
+     * the loop threads. Coroutines must be told to return (e.g. by shutting
+     * down the queue they await) before the executor is destroyed.
+     */
+    ~CoroExecutor();
+
+    CoroExecutor(const CoroExecutor&) = delete;
+    CoroExecutor& operator=(const CoroExecutor&) = delete;
+
+    // Starts task on the next loop (round-robin)
+    void spawn(CoTask task);
+    // Starts task on loop `index % thread_count()`
+    void spawn_on(size_t index, CoTask task);
+
+    size_t thread_count() const { return loops_.size(); }
+    const std::vector<int>& cpus() const { return cpus_; }
+
+    // Blocks until no spawned coroutine is left (timers keep firing meanwhile)
+    void wait_idle();
+
+    struct Metrics {
+        size_t threads{0};
+        size_t threads_pinned{0};
+        size_t tasks_live{0};       ///< Spawned and not yet finished
+        uint64_t tasks_spawned{0};
+        uint64_t resumes{0};        ///< Coroutine switches on the loops
+        uint64_t timers_fired{0};
+        uint64_t remote_wakeups{0}; ///< Resumes posted from other threads
+        uint64_t parks{0};          ///< Times a loop thread went to sleep
+    };
+    Metrics get_metrics() const;
+
+    /**
+     * @brief Intrusive timer node for custom awaitables
+     *
+     * Lives in the awaiting coroutine's frame. When `due` passes, the loop
+     * calls fire(): true resumes `waiter`, false re-arms the node at the
+     * (updated) `due`.
+     */
+    struct Timer {
+        std::chrono::steady_clock::time_point due{};
+        std::coroutine_handle<> waiter{};
+        bool (*fire)(Timer& self) = nullptr;
+    };
+
+    // Loop the calling coroutine runs on (nullptr off the executor)
+    struct Loop;
+    static Loop* current_loop();
+    // Schedules h on loop; any thread
+    static void schedule(Loop* loop, std::coroutine_handle<> h);
+    // Adds a timer to the calling loop; loop thread only
+    static void arm(Timer& timer);
+
+private:
+    friend struct CoTask::promise_type::FinalAwaiter;
+    void task_finished();
+    void run_loop(Loop& loop);
+
+    std::vector<int> cpus_;
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::atomic<size_t> next_loop_{0};
+    std::atomic<uint64_t> spawned_{0};
+    mutable std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    size_t live_{0};
+};
+
+/**
+ * @brief Wakes one suspended coroutine from any thread
+ *
+ * Single waiter. The waiter arms the signal, re-checks its condition, and
+ * either disarms (condition already true) or stays suspended; notify()
+ * resumes it on its own loop. Fences on both sides mean either the waiter
+ * sees the new state or the notifier sees the waiter, so notify() is a
+ * fence and one load while nobody waits (the same scheme as FutexEvent).
+ */
+class AsyncSignal
+{
+public:
+    void arm(CoroExecutor::Loop* loop, std::coroutine_handle<> waiter)
+    {
+        loop_ = loop;
+        waiter_ = waiter;
+        armed_.store(true, std::memory_order_release); // publishes loop_ and waiter_
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    // True if the waiter took itself back (no notify() will resume it)
+    bool disarm() { return armed_.exchange(false, std::memory_order_acq_rel); }
+
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (armed_.load(std::memory_order_relaxed) && armed_.exchange(false, std::memory_order_acq_rel)) {
+            CoroExecutor::schedule(loop_, waiter_);
+        }
+    }
+
+private:
+    std::atomic<bool> armed_{false};
+    CoroExecutor::Loop* loop_{nullptr};
+    std::coroutine_handle<> waiter_{};
+};
+
+// ---------------------------------------------------------------------------
+// Awaitables
+// ---------------------------------------------------------------------------
+
+struct SleepAwaiter : CoroExecutor::Timer {
+    explicit SleepAwaiter(std::chrono::steady_clock::time_point when) { due = when; }
+    bool await_ready() const { return due <= std::chrono::steady_clock::now(); }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+        waiter = h;
+        fire = [](CoroExecutor::Timer&) { return true; };
+        CoroExecutor::arm(*this);
+    }
+    void await_resume() const noexcept {}
+};
+
+inline SleepAwaiter sleep_until(std::chrono::steady_clock::time_point when)
+{
+    return SleepAwaiter(when);
+}
+
+template <typename Rep, typename Period>
+SleepAwaiter sleep_for(std::chrono::duration<Rep, Period> d)
+{
+    return SleepAwaiter(std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(d));
+}
+
+struct YieldAwaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { CoroExecutor::schedule(CoroExecutor::current_loop(), h); }
+    void await_resume() const noexcept {}
+};
+
+inline YieldAwaiter yield()
+{
+    return {};
+}
+
+// Appends up to max_items to out; 0 means the queue is shut down and empty
+// (or a wakeup found nothing, e.g. AQM dropped it; check is_shutdown()).
+// The queue must have an AsyncSignal set (TelemetryQueue::set_async_signal).
+struct QueuePopAwaiter {
+    TelemetryQueue& queue;
+    SampleBatch& out;
+    size_t max_items;
+    size_t popped{0};
+
+    bool await_ready();
+    bool await_suspend(std::coroutine_handle<> h);
+    size_t await_resume();
+};
+
+inline QueuePopAwaiter async_pop_batch(TelemetryQueue& queue, SampleBatch& out, size_t max_items)
+{
+    return QueuePopAwaiter{queue, out, max_items};
+}
+
+// Result of IBus::read(out, max_len), retried every `poll` until it returns
+// data or `timeout` passes (false then).
+struct BusReadAwaiter : CoroExecutor::Timer {
+    device::IBus& bus;
+    std::vector<std::uint8_t>& out;
+    size_t max_len;
+    std::chrono::steady_clock::duration timeout;
+    std::chrono::steady_clock::duration poll;
+    std::chrono::steady_clock::time_point deadline{};
+    bool result{false};
+
+    BusReadAwaiter(device::IBus& b, std::vector<std::uint8_t>& o, size_t len,
+                   std::chrono::steady_clock::duration t, std::chrono::steady_clock::duration p)
+        : bus(b), out(o), max_len(len), timeout(t), poll(p)
+    {
+    }
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> h);
+    bool await_resume() const noexcept { return result; }
+};
+
+template <typename Rep1, typename Period1, typename Rep2 = int64_t, typename Period2 = std::milli>
+BusReadAwaiter async_read(device::IBus& bus, std::vector<std::uint8_t>& out, size_t max_len,
+                          std::chrono::duration<Rep1, Period1> timeout,
+                          std::chrono::duration<Rep2, Period2> poll = std::chrono::milliseconds(1))
+{
+    using D = std::chrono::steady_clock::duration;
+    return BusReadAwaiter(bus, out, max_len, std::chrono::duration_cast<D>(timeout),
+                          std::chrono::duration_cast<D>(poll));
+}
+
+} // namespace telemetryhub::gateway
@@ -1,13 +1,20 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <algorithm>
 #include <thread>
 #include <optional>
+#include <vector>
 #include "telemetryhub/device/Device.h"
+#include "telemetryhub/gateway/CoroExecutor.h"
 #include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/HeapGuard.h"
 #include "telemetryhub/gateway/ICloudClient.h"
+#include "telemetryhub/gateway/ObjectPool.h"
+#include "telemetryhub/gateway/OffloadPolicy.h"
+#include "telemetryhub/gateway/Strand.h"
 #include "telemetryhub/gateway/ThreadPool.h"
 
 namespace telemetryhub::gateway {
@@ -21,6 +28,10 @@ public:
     GatewayCore(const GatewayCore&) = delete;
     GatewayCore& operator=(const GatewayCore&) = delete;
 
+    // Throws std::invalid_argument if zero-heap mode is on and the queue
+    // configuration cannot be preallocated (see set_zero_heap()), or if the
+    // coroutine or single loop model is combined with policy=block (see
+    // set_loop_model()).
     void start();
     void stop();
 
@@ -41,6 +52,135 @@ public:
     // Runtime knobs
     void set_sampling_interval(std::chrono::milliseconds ms) { sample_interval_ = ms; }
     void set_queue_capacity(size_t cap) { queue_capacity_ = cap; }
+    // Samples the producer collects before one push_bulk() into the queue
+    // (and one push_batch() to the cloud client). 1 = push every sample.
+    void set_producer_batch_size(size_t n) { producer_batch_size_ = std::max<size_t>(1, n); }
+    // Applied on start(); Spsc is safe because there is exactly one producer
+    // and one consumer thread on the queue.
+    void set_queue_backend(QueueBackend backend) { queue_backend_ = backend; }
+    // What the producer does when the bounded queue is full (applied on start())
+    void set_backpressure_policy(BackpressurePolicy policy) { backpressure_policy_ = policy; }
+    void set_block_timeout(std::chrono::milliseconds timeout) { block_timeout_ = timeout; }
+    void set_decimate_factor(uint32_t n) { decimate_factor_ = n; }
+    // policy=SpillToDisk: where overflow segments go (empty = system temp dir)
+    void set_spill_directory(std::string dir) { spill_dir_ = std::move(dir); }
+    void set_spill_segment_bytes(size_t bytes) { spill_segment_bytes_ = bytes; }
+    // Drop samples that waited longer than `target` in the queue (0 = off)
+    void set_queue_sojourn_target(std::chrono::milliseconds target) { sojourn_target_ = target; }
+    void set_queue_sojourn_interval(std::chrono::milliseconds interval) { sojourn_interval_ = interval; }
+    // Latency/CPU trade-off for idle waits; queue applied on start(), pool immediately
+    void set_queue_wait_strategy(WaitStrategy wait) { queue_wait_strategy_ = wait; }
+    void set_pool_wait_strategy(WaitStrategy wait)
+    {
+        pool_wait_strategy_ = wait;
+        if (thread_pool_) thread_pool_->set_wait_strategy(wait);
+    }
+
+    /**
+     * @brief CPU placement per thread role (applied on start())
+     *
+     * Producer and consumer pin to their whole set; pool workers take one
+     * CPU each from theirs, round-robin (the pool is rebuilt on start() when
+     * its set changed). Empty = left to the scheduler. With numa_local the
+     * queue storage is built on a thread pinned to the consumer's CPUs and
+     * the pool (job arena, worker deques) on the pool's, so first touch puts
+     * each on its user's node. Threads are named thub-producer,
+     * thub-consumer and thub-pool-<i> either way.
+     */
+    void set_producer_cpus(std::vector<int> cpus) { producer_cpus_ = std::move(cpus); }
+    void set_consumer_cpus(std::vector<int> cpus) { consumer_cpus_ = std::move(cpus); }
+    void set_pool_cpus(std::vector<int> cpus) { pool_cpus_ = std::move(cpus); }
+    void set_numa_local(bool enabled) { numa_local_ = enabled; }
+
+    /**
+     * @brief Pool worker bounds (applied on start(), rebuilding the pool)
+     *
+     * The pool starts min_threads workers and grows towards max_threads
+     * (0 = one per hardware thread) while jobs back up, retiring workers
+     * after a sustained lull; see ThreadPool::ElasticConfig. min == max
+     * gives a fixed pool. Default 1..hardware threads, so the same binary
+     * fits a 2-core edge box and a 32-core aggregator.
+     */
+    void set_pool_threads(size_t min_threads, size_t max_threads)
+    {
+        pool_elastic_.min_threads = min_threads;
+        pool_elastic_.max_threads = max_threads;
+    }
+
+    /**
+     * @brief Process batches in order per device (applied on start())
+     *
+     * Off: batch jobs go straight to the pool and may finish out of order.
+     * On: they go through a StrandPool keyed by device id, so one device's
+     * batches run one at a time in arrival order (safe for stateful
+     * per-device stages) while different devices still run in parallel.
+     * A popped batch that mixes devices is split into one job per device.
+     */
+    void set_ordered_processing(bool enabled) { ordered_processing_ = enabled; }
+
+    /**
+     * @brief Where batch processing runs (applied on start())
+     *
+     * Pool: every batch is a pool job. Inline: the consumer processes each
+     * batch itself. Auto (default): the consumer runs a batch inline while
+     * its measured cost (see OffloadPolicy) stays under `threshold` and
+     * posts it above that, so a stage cheaper than a cross-thread handoff
+     * stops paying for one. With ordered processing a batch still goes to
+     * the pool while an earlier one is queued there, so it cannot overtake.
+     */
+    void set_offload(OffloadMode mode, std::chrono::nanoseconds threshold = OffloadPolicy::kDefaultThreshold)
+    {
+        offload_mode_ = mode;
+        offload_threshold_ = threshold;
+    }
+
+    /**
+     * @brief How the producer and consumer loops run (applied on start())
+     *
+     * Threads: one OS thread each (thub-producer, thub-consumer). Coroutines:
+     * both are coroutines on a single CoroExecutor thread (thub-loops, pinned
+     * to the producer CPUs); the producer's pacing sleep is a timer and the
+     * consumer's pop suspends until the queue signals data, so the thread
+     * only wakes for actual work. A blocking push would stall both loops, so
+     * start() rejects policy=block in this mode.
+     *
+     * Single: the Coroutines loops, plus every batch processed inline on the
+     * same thread (offload mode forced to Inline). start() releases the
+     * thread pool, so acquisition, processing and the cloud client all run
+     * on thub-loops and no other pipeline thread exists; the pool is rebuilt
+     * when a later start() uses another model. Metrics keep their meaning
+     * (pool figures stay 0, offload_inline_batches counts every batch).
+     */
+    void set_loop_model(LoopModel model) { loop_model_ = model; }
+    LoopModel loop_model() const { return loop_model_; }
+
+    /**
+     * @brief Zero-heap steady state (applied on start())
+     *
+     * start() preallocates all pipeline storage from the configured sizes
+     * (memory_budget()), then the producer, consumer and pool jobs run under
+     * HeapGuard: any allocation they make is counted as heap_violations.
+     * When the batch arena is exhausted the consumer processes the batch
+     * itself instead of allocating another. Requires a bounded queue, a
+     * non-conflating backend and a policy other than spill. Cloud client
+     * calls are I/O outside the guarantee (counted as heap_exempt).
+     */
+    void set_zero_heap(bool enabled) { zero_heap_ = enabled; }
+    bool zero_heap() const { return zero_heap_; }
+
+    // Memory preallocated by start() for the current configuration (one device).
+    struct MemoryBudget {
+        size_t queue_bytes{0};       // bulk storage at capacity (0 if unbounded)
+        size_t control_bytes{0};     // control lane reserve
+        size_t batch_pool_bytes{0};  // consumer batch arena
+        size_t producer_bytes{0};    // producer micro-batch + cloud batch
+        size_t job_ring_bytes{0};    // thread pool job arena, deques and injection slots (+ strands)
+        size_t total() const
+        {
+            return queue_bytes + control_bytes + batch_pool_bytes + producer_bytes + job_ring_bytes;
+        }
+    };
+    MemoryBudget memory_budget() const;
 
     /**
      * @brief Configure failure policy for SafeState transition
@@ -53,9 +193,36 @@ public:
 
     struct Metrics {
         uint64_t samples_processed{0};
-        uint64_t samples_dropped{0};
+        uint64_t samples_dropped{0};   // queue drops of every kind (sum of the queue_* below)
         size_t queue_depth{0};
-        double latency_p99_ms{0.0};
+
+        // Queue backpressure accounting
+        uint64_t queue_dropped_oldest{0};
+        uint64_t queue_dropped_newest{0};
+        uint64_t queue_decimated{0};
+        uint64_t queue_block_timeouts{0};
+        uint64_t queue_aqm_dropped{0};
+        uint64_t queue_conflated{0};   // superseded by a newer sample (conflating backend)
+        // Disk spill (policy=spill)
+        uint64_t queue_spilled{0};
+        uint64_t queue_restored{0};
+        size_t queue_spill_depth{0};
+        uint64_t queue_spill_disk_bytes{0};
+        double queue_spill_write_mb_s{0.0};
+        double queue_spill_read_mb_s{0.0};
+        size_t queue_high_watermark{0};
+        // Time samples spent queued before the consumer took them
+        double queue_sojourn_p50_ms{0.0};
+        double queue_sojourn_p90_ms{0.0};
+        double queue_sojourn_p99_ms{0.0};
+        double queue_sojourn_max_ms{0.0};
+        // Priority lanes: status events (control) vs. measurements (bulk)
+        uint64_t queue_control_pushed{0};
+        size_t queue_control_depth{0};
+        double queue_control_sojourn_p50_ms{0.0};
+        double queue_control_sojourn_p99_ms{0.0};
+        size_t queue_bulk_depth{0};
+        double latency_p99_ms{0.0};  // producer-to-consumer p99 (= queue_sojourn_p99_ms)
         uint64_t uptime_seconds{0};
         
         // Thread pool metrics
@@ -63,13 +230,106 @@ public:
         uint64_t pool_jobs_queued{0};
         double pool_avg_processing_ms{0.0};
         size_t pool_num_threads{0};
+        // Elastic sizing: bounds, resize events so far, and the busy
+        // fraction the controller saw on its last tick
+        size_t pool_min_threads{0};
+        size_t pool_max_threads{0};
+        uint64_t pool_workers_started{0};
+        uint64_t pool_workers_retired{0};
+        double pool_recent_utilization{0.0};
+        uint64_t pool_jobs_local{0};
+        uint64_t pool_jobs_stolen{0};
+        uint64_t pool_steal_attempts{0};
+        // Pool saturation: time jobs waited for a worker vs. ran, and the
+        // busy fraction of each worker since the pool was built
+        double pool_queue_wait_p50_ms{0.0};
+        double pool_queue_wait_p99_ms{0.0};
+        double pool_queue_wait_p999_ms{0.0};
+        double pool_queue_wait_max_ms{0.0};
+        double pool_run_p50_ms{0.0};
+        double pool_run_p99_ms{0.0};
+        double pool_run_p999_ms{0.0};
+        double pool_run_max_ms{0.0};
+        double pool_utilization{0.0};
+        std::vector<double> pool_worker_utilization;
+        // Per JobPriority (untagged jobs count as normal)
+        struct PoolPriority {
+            uint64_t jobs{0};
+            double queue_wait_p50_ms{0.0};
+            double queue_wait_p99_ms{0.0};
+            double queue_wait_p999_ms{0.0};
+            uint64_t deadline_misses{0};
+        };
+        std::array<PoolPriority, kJobPriorities> pool_priorities{};
+        size_t pool_edf_queued{0};
+        // Ordered processing (StrandPool): batch jobs run, drain jobs, drains
+        // that hit their budget and requeued, batches waiting per device
+        uint64_t strand_jobs{0};
+        uint64_t strand_drains{0};
+        uint64_t strand_yields{0};
+        size_t strand_queued{0};
+        // Inline-vs-offload decisions (OffloadPolicy): batches processed on
+        // the consumer vs posted, the measured cost that drives Auto, and
+        // consumer time spent processing inline
+        OffloadMode offload_mode{OffloadMode::Auto};
+        double offload_threshold_us{0.0};
+        uint64_t offload_inline_batches{0};
+        uint64_t offload_pool_batches{0};
+        double offload_cost_ns_per_sample{0.0};
+        double offload_inline_ms{0.0};
+
+        // Producer/consumer loops: OS threads running them, and for the
+        // coroutine model the executor's switches, sleeps and cross-thread
+        // wakeups (0 with threads)
+        LoopModel loop_model{LoopModel::Threads};
+        size_t loop_threads{0};
+        uint64_t loop_resumes{0};
+        uint64_t loop_parks{0};
+        uint64_t loop_remote_wakeups{0};
+
+        // Thread placement: producer/consumer/pool threads pinned right now,
+        // and pin requests the OS rejected (unknown or offline CPU)
+        size_t threads_pinned{0};
+        uint64_t pin_failures{0};
+
+        // Batch pool: consumer batches recycled when their pool job finishes
+        uint64_t batch_pool_acquired{0};
+        uint64_t batch_pool_reused{0};
+        uint64_t batch_pool_heap_allocations{0};
+        size_t batch_pool_in_use{0};
+
+        // Zero-heap mode (heap_* stay 0 unless the allocator hook is linked in)
+        bool zero_heap{false};
+        size_t memory_budget_bytes{0};
+        bool heap_hook_installed{false};
+        uint64_t heap_allocations{0};
+        uint64_t heap_violations{0};
+        uint64_t heap_exempt{0};
     };
     Metrics get_metrics() const;
 
 private:
     void producer_loop();
     void consumer_loop();
-    void process_sample_with_metrics(const device::TelemetrySample& sample);
+    // Coroutine versions of the two loops (LoopModel::Coroutines)
+    CoTask producer_task();
+    CoTask consumer_task();
+    // One producer iteration; false once the device is done (fault or
+    // SafeState). The caller paces the next one by sample_interval_.
+    bool produce_once(SampleBatch& pending);
+    // Everything the consumer does with a popped batch
+    void consume_batch(ObjectPool<SampleBatch>::Handle& batch);
+    // Batch for the consumer to continue with while the current one is a
+    // pool job. Empty if the arena is exhausted, except when ordered: then
+    // it parks until a finished job hands its batch back.
+    ObjectPool<SampleBatch>::Handle acquire_job_batch();
+    void post_batch_job(uint32_t device_id, ObjectPool<SampleBatch>::Handle batch);
+    void flush_producer_batch(SampleBatch& pending);
+    void process_batch_with_metrics(SampleBatch& batch, bool inline_run);
+    void forward_status(device::DeviceState state);
+    bool pin_role(const char* role, const std::vector<int>& cpus);
+    void configure_queue();
+    void place_thread_pool();
 
     mutable std::mutex latest_mutex_;
     std::optional<device::TelemetrySample> latest_;
@@ -87,6 +347,30 @@ private:
     device::DeviceState prev_state_{device::DeviceState::Idle};
     std::chrono::milliseconds sample_interval_{std::chrono::milliseconds(100)};
     size_t queue_capacity_{0};
+    size_t producer_batch_size_{1};
+    QueueBackend queue_backend_{QueueBackend::Mutex};
+    BackpressurePolicy backpressure_policy_{BackpressurePolicy::DropOldest};
+    std::chrono::milliseconds block_timeout_{10};
+    uint32_t decimate_factor_{4};
+    std::string spill_dir_;
+    size_t spill_segment_bytes_{SpillStore::kDefaultSegmentBytes};
+    std::chrono::milliseconds sojourn_target_{0};
+    std::chrono::milliseconds sojourn_interval_{100};
+    WaitStrategy queue_wait_strategy_{WaitStrategy::SpinThenPark};
+    bool zero_heap_{false};
+    std::vector<int> producer_cpus_;
+    std::vector<int> consumer_cpus_;
+    std::vector<int> pool_cpus_;
+    ThreadPool::ElasticConfig pool_elastic_;
+    bool ordered_processing_{false};
+    OffloadMode offload_mode_{OffloadMode::Auto};
+    std::chrono::nanoseconds offload_threshold_{OffloadPolicy::kDefaultThreshold};
+    LoopModel loop_model_{LoopModel::Threads};
+    WaitStrategy pool_wait_strategy_{WaitStrategy::Block}; // for a rebuilt pool
+    bool numa_local_{false};
+    std::atomic<bool> producer_pinned_{false};
+    std::atomic<bool> consumer_pinned_{false};
+    std::atomic<uint64_t> pin_failures_{0};
     
     // Failure policy (circuit breaker pattern)
     int max_consecutive_failures_{5}; // Force SafeState after 5 consecutive failures
@@ -94,10 +378,27 @@ private:
     
     // Metrics tracking
     std::atomic<uint64_t> metrics_samples_processed_{0};
-    std::atomic<uint64_t> metrics_samples_dropped_{0};
     
+    // Producer thread only: the every-Nth-sample cloud batch, reused per flush
+    SampleBatch cloud_batch_;
+    // Inline-vs-offload cost model, and batch jobs posted but not finished;
+    // before thread_pool_, since jobs still finishing at shutdown touch both
+    OffloadPolicy offload_;
+    std::atomic<size_t> offloaded_in_flight_{0};
+    // Notified each time a batch job has returned its batch to batch_pool_
+    FutexEvent batch_released_;
+    // Consumer batches; declared before thread_pool_ so queued jobs can
+    // still hand their batch back while the pool shuts down
+    ObjectPool<SampleBatch> batch_pool_;
     // Thread pool for processing (Day 17)
     std::unique_ptr<ThreadPool> thread_pool_;
+    // Per-device ordering on top of thread_pool_ (ordered processing only);
+    // declared after it so it is destroyed first, once its jobs have run
+    std::unique_ptr<StrandPool> strands_;
+    // LoopModel::Coroutines/Single: the thread both loops run on, and the signal
+    // the queue uses to resume the consumer coroutine
+    AsyncSignal queue_signal_;
+    std::unique_ptr<CoroExecutor> loops_;
     std::chrono::steady_clock::time_point start_time_;
 };
 
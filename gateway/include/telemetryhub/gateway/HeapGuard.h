@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Heap allocation accounting for zero-heap mode
+ *
+ * The counting allocator hook (gateway/src/HeapGuardHook.cpp, linked into
+ * gateway_app when THUB_HEAP_GUARD is ON) reports every operator new here.
+ * Threads that have finished their startup preallocation open a ThreadScope;
+ * any allocation they make afterwards is a violation of the zero-heap
+ * guarantee and is counted as such. Work that is allowed to allocate on a
+ * guarded thread (cloud I/O) runs inside an Exempt scope.
+ *
+ * Only C++ allocations are seen: C code calling malloc() directly (stdio
+ * buffers, tz data) bypasses operator new. Without the hook linked in,
+ * hook_installed is false and every counter stays 0.
+ */
+class HeapGuard
+{
+public:
+    struct Metrics {
+        bool hook_installed{false};
+        uint64_t allocations{0};   ///< operator new calls, all threads
+        uint64_t bytes{0};         ///< bytes requested by those calls
+        uint64_t violations{0};    ///< allocations on a guarded thread
+        uint64_t exempt{0};        ///< allocations inside an Exempt scope on a guarded thread
+    };
+
+    // Called by the hook; must not allocate.
+    static void on_allocation(std::size_t bytes) noexcept;
+    static void mark_hook_installed() noexcept;
+
+    static Metrics get_metrics() noexcept;
+    static bool thread_guarded() noexcept;
+
+    // Guards the current thread for its lifetime (no-op when enable is false).
+    class ThreadScope
+    {
+    public:
+        explicit ThreadScope(bool enable = true) noexcept;
+        ~ThreadScope();
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+
+    private:
+        bool enabled_;
+    };
+
+    // Allows allocations on a guarded thread, counted as exempt.
+    class Exempt
+    {
+    public:
+        Exempt() noexcept;
+        ~Exempt();
+        Exempt(const Exempt&) = delete;
+        Exempt& operator=(const Exempt&) = delete;
+    };
+};
+
+} // namespace telemetryhub::gateway
@@ -1,6 +1,7 @@
 #pragma once
 #include "telemetryhub/device/TelemetrySample.h"
 #include "telemetryhub/device/Device.h"
+#include "telemetryhub/gateway/SampleBatch.h"
 
 namespace telemetryhub::gateway {
 class ICloudClient
@@ -11,5 +12,13 @@ public:
     virtual void push_sample(const telemetryhub::device::TelemetrySample& sample) = 0;
 
     virtual void push_status (device::DeviceState state) = 0;
+
+    // One call per producer micro-batch; override to ship it as one request.
+    virtual void push_batch(const SampleBatch& batch)
+    {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            push_sample(batch.sample(i));
+        }
+    }
 };
 } // namespace telemetryhub::gateway
\ No newline at end of file
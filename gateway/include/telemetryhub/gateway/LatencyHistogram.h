@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Lock-free log-linear histogram for latency percentiles
+ *
+ * Values (nanoseconds) land in power-of-two ranges split into 8 linear
+ * sub-buckets, so every reported percentile is within 12.5% of the true
+ * value across the whole 1ns..584y range. record() is one relaxed
+ * fetch_add per counter, cheap enough for every queue dequeue; readers
+ * see an approximate snapshot while writers are active.
+ */
+class LatencyHistogram
+{
+public:
+    struct Summary {
+        uint64_t count{0};
+        double mean_ns{0.0};
+        uint64_t p50_ns{0};
+        uint64_t p90_ns{0};
+        uint64_t p99_ns{0};
+        uint64_t p999_ns{0};
+        uint64_t max_ns{0};
+    };
+
+    void record(uint64_t value_ns);
+    void record(std::chrono::nanoseconds value)
+    {
+        record(value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0);
+    }
+
+    // p in [0, 100]; returns the upper bound of the bucket holding the
+    // p-th percentile (0 when nothing was recorded).
+    uint64_t percentile(double p) const;
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    Summary summary() const;
+
+    // Adds other's counts to this one (e.g. per-thread histograms into a
+    // snapshot). Approximate while other is being written.
+    void merge(const LatencyHistogram& other);
+
+    // Not atomic with respect to concurrent record() calls.
+    void reset();
+
+private:
+    static constexpr unsigned kSubBits = 3;
+    static constexpr uint64_t kSubBuckets = 1u << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    static size_t bucket_index(uint64_t v);
+    static uint64_t bucket_upper(size_t idx);
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace telemetryhub::gateway
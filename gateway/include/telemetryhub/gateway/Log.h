@@ -1,6 +1,7 @@
 #pragma once
 #include <atomic>
 #include <chrono>
+#include <cstdarg>
 #include <cstdio>
 #include <ctime>
 #include <mutex>
@@ -26,19 +27,43 @@ public:
   }
 
   void log(LogLevel lvl, const char* cat, const std::string& msg) {
+    log(lvl, cat, msg.c_str());
+  }
+  // Literal messages bind here and never build a std::string
+  void log(LogLevel lvl, const char* cat, const char* msg) {
     if ((int)lvl > level_.load(std::memory_order_relaxed)) return;
+    write_line(lvl, cat, msg);
+  }
 
+  // printf-style variant for hot paths: formats into a fixed stack buffer
+  // (lines longer than kMaxLine are truncated), so it never allocates, and
+  // filtered-out levels cost one atomic load instead of building a string.
+  static constexpr size_t kMaxLine = 512;
+#if defined(__GNUC__)
+  __attribute__((format(printf, 4, 5)))
+#endif
+  void logf(LogLevel lvl, const char* cat, const char* fmt, ...) {
+    if ((int)lvl > level_.load(std::memory_order_relaxed)) return;
+    char msg[kMaxLine];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    write_line(lvl, cat, msg);
+  }
+
+private:
+  void write_line(LogLevel lvl, const char* cat, const char* msg) {
     char ts[24];
     std::time_t t = std::time(nullptr);
     std::strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
 
     const char* L = lvl_name(lvl);
     std::lock_guard<std::mutex> lk(mu_);
-    std::fprintf(stdout, "%s [%s] (%s) %s\n", ts, L, cat, msg.c_str());
-    if (file_) std::fprintf(file_, "%s [%s] (%s) %s\n", ts, L, cat, msg.c_str());
+    std::fprintf(stdout, "%s [%s] (%s) %s\n", ts, L, cat, msg);
+    if (file_) std::fprintf(file_, "%s [%s] (%s) %s\n", ts, L, cat, msg);
   }
 
-private:
   static const char* lvl_name(LogLevel l){
     switch(l){
       case LogLevel::Error: return "ERROR";
@@ -60,5 +85,8 @@ private:
 #define TELEMETRYHUB_LOGW(cat, msg) TELEMETRYHUB_LOG(::telemetryhub::LogLevel::Warn,  (cat), (msg))
 #define TELEMETRYHUB_LOGI(cat, msg) TELEMETRYHUB_LOG(::telemetryhub::LogLevel::Info,  (cat), (msg))
 #define TELEMETRYHUB_LOGD(cat, msg) TELEMETRYHUB_LOG(::telemetryhub::LogLevel::Debug, (cat), (msg))
+// printf-style, allocation-free (Logger::logf)
+#define TELEMETRYHUB_LOGF(lvl, cat, ...) ::telemetryhub::Logger::instance().logf((lvl),(cat),__VA_ARGS__)
+#define TELEMETRYHUB_LOGIF(cat, ...) TELEMETRYHUB_LOGF(::telemetryhub::LogLevel::Info, (cat), __VA_ARGS__)
 
 } // namespace telemetryhub
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+namespace telemetryhub::gateway {
+
+// How GatewayCore runs its acquisition (producer) and consumer loops.
+//  Threads:    one OS thread per loop, waiting in sleep_for / the queue's
+//              condition variable (the original design)
+//  Coroutines: both loops are coroutines on one CoroExecutor thread; a
+//              wait suspends the coroutine instead of blocking the thread
+//  Single:     as Coroutines, and batch processing runs inline on that
+//              thread too, with no thread pool: the whole pipeline is one
+//              thread (for single-core gateways)
+enum class LoopModel
+{
+    Threads,
+    Coroutines,
+    Single
+};
+
+const char* to_string(LoopModel model);
+// Accepts "threads" | "coroutines" | "single"; false otherwise.
+bool parse_loop_model(const std::string& s, LoopModel& out);
+
+} // namespace telemetryhub::gateway
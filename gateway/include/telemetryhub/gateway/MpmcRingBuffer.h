@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include "telemetryhub/gateway/SpscRingBuffer.h"
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Bounded multi-producer/multi-consumer ring buffer (Dmitry Vyukov's design)
+ *
+ * Producers claim a position with a CAS on tail_, consumers with a CAS on
+ * head_; each slot's sequence number hands ownership back and forth, so no
+ * operation ever blocks on another thread holding a lock. Under contention a
+ * thread only retries its own CAS, which is what keeps throughput from
+ * collapsing with 10 producers / 5 consumers the way a shared mutex does.
+ *
+ * Same slot protocol as SpscRingBuffer; only the enqueue side differs.
+ */
+template <typename T>
+class MpmcRingBuffer
+{
+public:
+    // Capacity is rounded up to the next power of two.
+    explicit MpmcRingBuffer(std::size_t capacity)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_))
+    {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+    MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+    // Any thread. Returns false when the ring is full; value is untouched then.
+    bool try_push(T&& value)
+    {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value)
+    {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+
+    // Any thread. Returns false when empty.
+    bool try_pop(T& out)
+    {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.seq.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Counts claimed positions, so it is approximate while producers are mid-push.
+    std::size_t size() const
+    {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return capacity_; }
+    // Memory per slot (element plus sequence number), for footprint estimates.
+    static constexpr std::size_t slot_bytes() { return sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq{0};
+        T value{};
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0}; // consumers
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0}; // producers
+};
+
+} // namespace telemetryhub::gateway
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "telemetryhub/gateway/SpscRingBuffer.h" // kCacheLineSize
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Lock-free pool of reusable objects (arena for pipeline batches)
+ *
+ * A fixed arena of objects is created up front and handed out as a Handle -
+ * a unique_ptr whose deleter puts the object back - so whichever stage drops
+ * the last reference recycles it: the consumer, a pool worker, or a test.
+ * Released objects are clear()ed (when T has one) but keep their capacity,
+ * which is what makes a recycled SampleBatch allocation-free to refill.
+ *
+ * The free list is a Treiber stack of arena indices. The head packs a
+ * 32-bit version tag next to the index so a single 64-bit CAS is immune to
+ * ABA, and unlike a bounded MPMC ring it never reports "empty" just because
+ * another thread was preempted half-way through a release. When the arena
+ * is exhausted acquire() falls back to the heap and counts it; such overflow
+ * objects are deleted on release. The pool must outlive every Handle.
+ */
+template <typename T>
+class ObjectPool
+{
+public:
+    struct Releaser {
+        ObjectPool* pool{nullptr};
+        void operator()(T* obj) const { pool->release(obj); }
+    };
+    using Handle = std::unique_ptr<T, Releaser>;
+
+    struct Metrics {
+        uint64_t acquired{0};          ///< Handles given out
+        uint64_t reused{0};            ///< ... served from the arena
+        uint64_t heap_allocations{0};  ///< ... that had to allocate (arena exhausted)
+        size_t in_use{0};              ///< Handles currently alive
+        size_t available{0};           ///< Arena objects on the free list
+    };
+
+    // `prepare` runs once on every object the pool creates (e.g. reserve()).
+    explicit ObjectPool(size_t capacity, std::function<void(T&)> prepare = {})
+        : capacity_(capacity),
+          objects_(std::make_unique<T[]>(capacity)),
+          next_(std::make_unique<std::atomic<uint32_t>[]>(capacity)),
+          prepare_(std::move(prepare))
+    {
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (prepare_) {
+                prepare_(objects_[i]);
+            }
+            push_free(static_cast<uint32_t>(i));
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Any thread. Never returns null; allocates only when the arena is exhausted.
+    Handle acquire()
+    {
+        acquired_.fetch_add(1, std::memory_order_relaxed);
+        in_use_.fetch_add(1, std::memory_order_relaxed);
+        T* obj = nullptr;
+        uint32_t index = 0;
+        if (pop_free(index)) {
+            reused_.fetch_add(1, std::memory_order_relaxed);
+            obj = &objects_[index];
+        } else {
+            heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+            obj = new T();
+            if (prepare_) {
+                prepare_(*obj);
+            }
+        }
+        return Handle(obj, Releaser{this});
+    }
+
+    // Any thread. Arena only: returns an empty Handle instead of allocating
+    // (zero-heap callers decide what to do when the arena is exhausted).
+    Handle try_acquire()
+    {
+        uint32_t index = 0;
+        if (!pop_free(index)) {
+            return Handle(nullptr, Releaser{this});
+        }
+        acquired_.fetch_add(1, std::memory_order_relaxed);
+        reused_.fetch_add(1, std::memory_order_relaxed);
+        in_use_.fetch_add(1, std::memory_order_relaxed);
+        return Handle(&objects_[index], Releaser{this});
+    }
+
+    // Re-wraps a pointer taken out of a Handle with release(), e.g. to pass
+    // it through a callback that only takes trivially copyable captures.
+    Handle adopt(T* obj) { return Handle(obj, Releaser{this}); }
+
+    Metrics get_metrics() const
+    {
+        Metrics m;
+        m.acquired = acquired_.load(std::memory_order_relaxed);
+        m.reused = reused_.load(std::memory_order_relaxed);
+        m.heap_allocations = heap_allocations_.load(std::memory_order_relaxed);
+        m.in_use = in_use_.load(std::memory_order_relaxed);
+        m.available = available_.load(std::memory_order_relaxed);
+        return m;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    // head_ layout: version tag in the high 32 bits, index + 1 in the low 32 (0 = empty)
+    static constexpr uint64_t kIndexMask = 0xffffffffu;
+
+    void release(T* obj)
+    {
+        if constexpr (requires(T& t) { t.clear(); }) {
+            obj->clear();
+        }
+        in_use_.fetch_sub(1, std::memory_order_relaxed);
+        const std::less<const T*> before;
+        if (before(obj, objects_.get()) || !before(obj, objects_.get() + capacity_)) {
+            delete obj; // overflow object from acquire()
+            return;
+        }
+        push_free(static_cast<uint32_t>(obj - objects_.get()));
+    }
+
+    void push_free(uint32_t index)
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t desired = 0;
+        do {
+            next_[index].store(static_cast<uint32_t>(head & kIndexMask), std::memory_order_relaxed);
+            desired = ((head >> 32) + 1) << 32 | (index + 1);
+        } while (!head_.compare_exchange_weak(head, desired, std::memory_order_release,
+                                              std::memory_order_relaxed));
+        available_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool pop_free(uint32_t& index)
+    {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t desired = 0;
+        do {
+            if ((head & kIndexMask) == 0) {
+                return false;
+            }
+            index = static_cast<uint32_t>(head & kIndexMask) - 1;
+            // May read a stale link if another thread wins the race; the tag
+            // makes the CAS below fail in that case
+            desired = ((head >> 32) + 1) << 32 | next_[index].load(std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, desired, std::memory_order_acquire,
+                                              std::memory_order_acquire));
+        available_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    const size_t capacity_;
+    std::unique_ptr<T[]> objects_;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+    std::function<void(T&)> prepare_;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+    alignas(kCacheLineSize) std::atomic<uint64_t> acquired_{0};
+    std::atomic<uint64_t> reused_{0};
+    std::atomic<uint64_t> heap_allocations_{0};
+    std::atomic<size_t> in_use_{0};
+    std::atomic<size_t> available_{0};
+};
+
+} // namespace telemetryhub::gateway
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace telemetryhub::gateway {
+
+// Where the consumer runs a batch's processing stage.
+//  Auto:   inline while the measured cost of a batch of that size stays
+//          under the threshold, on the pool above it
+//  Pool:   always post to the thread pool (the original behaviour)
+//  Inline: always on the consumer thread; the pool stays idle
+enum class OffloadMode
+{
+    Auto,
+    Pool,
+    Inline
+};
+
+// Auto: default cost above which a batch goes to the pool
+inline constexpr std::chrono::microseconds kDefaultOffloadThreshold{20};
+
+const char* to_string(OffloadMode mode);
+// Accepts "auto" | "pool" | "inline"; false otherwise.
+bool parse_offload_mode(const std::string& s, OffloadMode& out);
+
+} // namespace telemetryhub::gateway
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "telemetryhub/gateway/OffloadMode.h"
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Inline-vs-offload cost model for small processing jobs
+ *
+ * Posting a job to the pool costs a cross-thread handoff: the post, a
+ * worker wakeup and a cache miss on the batch, typically a few µs and far
+ * more on a loaded core. A stage that runs in less than that (scale a
+ * column, compute its stats) is cheaper to run where the data already is.
+ *
+ * The model is one number: an exponentially weighted average of the
+ * measured run time per item (sample), fed by record() wherever the job
+ * ran. offload() multiplies it by the job's size and compares that with
+ * the threshold. Because inline runs keep measuring too, a stage that gets
+ * more expensive (bigger batches, debug logging, a new transform) moves
+ * back to the pool by itself, and vice versa. With no measurement yet the
+ * first job is offloaded, so an unknown, possibly heavy stage never stalls
+ * the caller.
+ *
+ * offload() is for the one calling thread; record() and get_metrics() may
+ * be called from any thread (two concurrent records may lose one update of
+ * the estimate, which only delays it by a sample).
+ */
+class OffloadPolicy
+{
+public:
+    static constexpr std::chrono::microseconds kDefaultThreshold = kDefaultOffloadThreshold;
+
+    explicit OffloadPolicy(OffloadMode mode = OffloadMode::Auto,
+                           std::chrono::nanoseconds threshold = kDefaultThreshold);
+
+    OffloadPolicy(const OffloadPolicy&) = delete;
+    OffloadPolicy& operator=(const OffloadPolicy&) = delete;
+
+    // Sets mode and threshold and forgets the estimate and counters; only
+    // while no job is being decided or recorded (get_metrics() is fine)
+    void reset(OffloadMode mode, std::chrono::nanoseconds threshold);
+
+    /**
+     * @brief True to post a job of `items` to the pool, false to run it inline
+     * @param pending Earlier jobs the new one must not overtake are still
+     *                queued (ordered processing); forces the pool
+     */
+    bool offload(size_t items, bool pending = false) const;
+
+    // Run time of a finished job of `items`, and whether it ran inline
+    void record(size_t items, std::chrono::nanoseconds took, bool ran_inline);
+
+    OffloadMode mode() const { return mode_.load(std::memory_order_relaxed); }
+    std::chrono::nanoseconds threshold() const
+    {
+        return std::chrono::nanoseconds(threshold_ns_.load(std::memory_order_relaxed));
+    }
+
+    struct Metrics {
+        OffloadMode mode{OffloadMode::Auto};
+        double threshold_us{0.0};
+        double cost_ns_per_item{0.0}; ///< Current estimate (0 = nothing measured yet)
+        uint64_t inline_jobs{0};
+        uint64_t offloaded_jobs{0};
+        double inline_ms{0.0};        ///< Caller time spent running jobs inline
+    };
+    Metrics get_metrics() const;
+
+private:
+    // Atomic because get_metrics() may run while start() calls reset()
+    std::atomic<OffloadMode> mode_;
+    std::atomic<int64_t> threshold_ns_;
+    std::atomic<double> cost_ns_per_item_{0.0};
+    std::atomic<uint64_t> inline_jobs_{0};
+    std::atomic<uint64_t> offloaded_jobs_{0};
+    std::atomic<uint64_t> inline_ns_{0};
+};
+
+} // namespace telemetryhub::gateway
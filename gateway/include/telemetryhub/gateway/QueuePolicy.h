@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+
+namespace telemetryhub::gateway {
+
+// Storage used behind the TelemetryQueue API.
+//  Mutex: RingDeque guarded by a mutex/condition_variable (any number of threads).
+//  Spsc:  lock-free ring, exactly one pushing thread and one popping thread
+//         (GatewayCore's producer_loop -> consumer_loop hop).
+//  Mpmc:  lock-free ring, any number of pushing and popping threads.
+//  Conflating: Mutex storage plus a (device_id, channel) index; a newer sample
+//         replaces the queued one with the same key in place (O(1)), so a slow
+//         consumer always sees the latest value per key and memory stays
+//         bounded by the number of keys.
+enum class QueueBackend
+{
+    Mutex,
+    Spsc,
+    Mpmc,
+    Conflating
+};
+
+// What push() does when a bounded queue is full. Freshness vs completeness:
+//  DropOldest:       evict the oldest queued sample (default; keeps data fresh)
+//  DropNewest:       reject the incoming sample (keeps what is already queued)
+//  BlockWithTimeout: wait up to the block timeout for space, then reject
+//  DecimateEveryNth: admit every Nth incoming sample (evicting the oldest),
+//                    reject the others, so overload thins the stream evenly
+//  SpillToDisk:      append the overflow to memory-mapped segment files and
+//                    read it back in order as the consumer catches up; never
+//                    blocks or drops unless the disk fails. Mutex backend
+//                    only; the others treat it as DropOldest.
+enum class BackpressurePolicy
+{
+    DropOldest,
+    DropNewest,
+    BlockWithTimeout,
+    DecimateEveryNth,
+    SpillToDisk
+};
+
+const char* to_string(QueueBackend backend);
+// Accepts "mutex" | "spsc" | "mpmc" | "conflating"; returns false for anything else.
+bool parse_queue_backend(const std::string& s, QueueBackend& out);
+
+const char* to_string(BackpressurePolicy policy);
+// Accepts "drop_oldest" | "drop_newest" | "block" | "decimate" | "spill"; false otherwise.
+bool parse_backpressure_policy(const std::string& s, BackpressurePolicy& out);
+
+} // namespace telemetryhub::gateway
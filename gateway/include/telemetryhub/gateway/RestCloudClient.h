@@ -15,6 +15,7 @@ namespace telemetryhub::gateway {
 
         void push_sample(const telemetryhub::device::TelemetrySample& sample) override;
         void push_status(telemetryhub::device::DeviceState state) override;
+        void push_batch(const SampleBatch& batch) override;
     private:
         std::string endpoint_url_;
     };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "telemetryhub/gateway/SpscRingBuffer.h"
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Growable circular FIFO used as the mutex-backend storage
+ *
+ * std::deque allocates a fresh 512-byte node every few push_backs and frees
+ * one every few pop_fronts, so a queue that merely holds steady still hits
+ * the heap continuously. RingDeque keeps one power-of-two buffer that only
+ * ever grows (doubling, elements moved in FIFO order), so once it has seen
+ * its high-water mark push/pop never allocate again.
+ *
+ * Not thread-safe; TelemetryQueue guards it with its mutex.
+ */
+template <typename T>
+class RingDeque
+{
+public:
+    RingDeque() = default;
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return buf_.size(); }
+
+    // Grows the buffer up front so the first n pushes do not allocate.
+    void reserve(std::size_t n)
+    {
+        if (n > buf_.size()) {
+            grow(round_up_pow2(n));
+        }
+    }
+
+    void push_back(T&& value)
+    {
+        if (size_ == buf_.size()) {
+            grow(buf_.empty() ? kInitialCapacity : buf_.size() * 2);
+        }
+        buf_[(head_ + size_) & (buf_.size() - 1)] = std::move(value);
+        ++size_;
+    }
+
+    T& front() { return buf_[head_]; }
+    const T& front() const { return buf_[head_]; }
+    T& back() { return (*this)[size_ - 1]; }
+
+    void pop_front()
+    {
+        head_ = (head_ + 1) & (buf_.size() - 1);
+        --size_;
+    }
+
+    // i counts from the front.
+    T& operator[](std::size_t i) { return buf_[(head_ + i) & (buf_.size() - 1)]; }
+    const T& operator[](std::size_t i) const { return buf_[(head_ + i) & (buf_.size() - 1)]; }
+
+    // Keeps the buffer; only the high-water mark is ever paid for.
+    void clear()
+    {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    static constexpr std::size_t kInitialCapacity = 16;
+
+    void grow(std::size_t new_capacity)
+    {
+        std::vector<T> next(new_capacity);
+        for (std::size_t i = 0; i < size_; ++i) {
+            next[i] = std::move((*this)[i]);
+        }
+        buf_ = std::move(next);
+        head_ = 0;
+    }
+
+    std::vector<T> buf_;
+    std::size_t head_{0};
+    std::size_t size_{0};
+};
+
+} // namespace telemetryhub::gateway
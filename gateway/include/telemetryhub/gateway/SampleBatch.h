@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "telemetryhub/device/TelemetrySample.h"
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Column-oriented (SoA) batch of samples
+ *
+ * One contiguous array per field, so stages that only look at values (stats,
+ * calibration, thresholds) stream through a dense double[] the compiler can
+ * vectorize, instead of striding over 32-byte samples. This is the unit the
+ * gateway pipeline moves around: the producer micro-batches into it, the
+ * queue pops straight into it, the thread pool processes it and cloud
+ * clients receive it, so fixed costs are paid per batch, not per sample.
+ *
+ * sample(i) / push_back() convert a row to and from TelemetrySample for
+ * code that still works one sample at a time.
+ */
+class SampleBatch
+{
+public:
+    SampleBatch() = default;
+    explicit SampleBatch(std::span<const device::TelemetrySample> samples);
+
+    void reserve(size_t n);
+    void clear();
+    // Column storage per reserved row, for memory budgets
+    static constexpr size_t bytes_per_row()
+    {
+        return sizeof(int64_t) + sizeof(double) + sizeof(uint32_t) + sizeof(uint16_t) +
+               sizeof(uint32_t) + sizeof(uint16_t) + sizeof(device::SampleKind);
+    }
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    void push_back(const device::TelemetrySample& s);
+    device::TelemetrySample sample(size_t i) const;
+    device::TelemetrySample front() const { return sample(0); }
+    device::TelemetrySample back() const { return sample(size() - 1); }
+    // Drops the first n rows (e.g. status items already handled)
+    void erase_front(size_t n);
+    // Moves every row of one device to the end of `out`; both keep their
+    // row order. Returns the number of rows moved.
+    size_t extract_device(uint32_t device_id, SampleBatch& out);
+    void append_to(std::vector<device::TelemetrySample>& out) const;
+
+    // Columns
+    std::span<const int64_t> timestamps_ns() const { return timestamps_ns_; }
+    std::span<const double> values() const { return values_; }
+    std::span<double> values() { return values_; }
+    std::span<const uint32_t> sequence_ids() const { return sequence_ids_; }
+    std::span<const uint16_t> unit_ids() const { return unit_ids_; }
+    std::span<const uint32_t> device_ids() const { return device_ids_; }
+    std::span<const uint16_t> channels() const { return channels_; }
+    std::span<const device::SampleKind> kinds() const { return kinds_; }
+
+    // Vectorizable kernels over the value column
+    struct ValueStats {
+        size_t count{0};
+        double min{0.0};
+        double max{0.0};
+        double sum{0.0};
+        double mean() const { return count ? sum / static_cast<double>(count) : 0.0; }
+        // Combines stats of two disjoint ranges (parallel_reduce over chunks)
+        void merge(const ValueStats& other);
+    };
+    ValueStats value_stats() const;
+    // Same kernel over any slice of a value column
+    static ValueStats value_stats(std::span<const double> values);
+    // values[i] = values[i] * factor + offset
+    void scale_values(double factor, double offset = 0.0);
+
+private:
+    std::vector<int64_t> timestamps_ns_;
+    std::vector<double> values_;
+    std::vector<uint32_t> sequence_ids_;
+    std::vector<uint16_t> unit_ids_;
+    std::vector<uint32_t> device_ids_;
+    std::vector<uint16_t> channels_;
+    std::vector<device::SampleKind> kinds_;
+};
+
+} // namespace telemetryhub::gateway
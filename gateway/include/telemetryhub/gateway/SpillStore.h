@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include "telemetryhub/device/TelemetrySample.h"
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Append-only FIFO of samples in memory-mapped segment files
+ *
+ * Backs TelemetryQueue's SpillToDisk policy. Records are appended to the
+ * tail segment through its mapping (no write() syscall per sample) and read
+ * back from the head segment in the same order; a segment file is deleted
+ * as soon as it has been fully read and the writer has moved on. Writing
+ * therefore runs at page-cache/disk speed and never waits for the consumer.
+ *
+ * Not thread-safe: TelemetryQueue calls it under its own mutex. Throws
+ * std::runtime_error if a segment file cannot be created or mapped.
+ */
+class SpillStore
+{
+public:
+    static constexpr size_t kDefaultSegmentBytes = size_t{16} << 20;
+
+    explicit SpillStore(std::filesystem::path dir, size_t segment_bytes = kDefaultSegmentBytes);
+    ~SpillStore(); // unmaps and deletes all of its segment files
+
+    SpillStore(const SpillStore&) = delete;
+    SpillStore& operator=(const SpillStore&) = delete;
+
+    void append(const device::TelemetrySample& sample, int64_t enqueued_ns);
+    // Oldest record first; false when empty.
+    bool pop(device::TelemetrySample& out, int64_t& enqueued_ns);
+
+    bool empty() const { return records_ == 0; }
+    size_t size() const { return records_; }
+    uint64_t disk_bytes() const;     ///< Size of the segment files currently on disk
+    uint64_t bytes_written() const { return bytes_written_; }
+    uint64_t bytes_read() const { return bytes_read_; }
+
+private:
+    struct Segment;
+
+    std::unique_ptr<Segment> open_segment();
+
+    std::filesystem::path dir_;
+    std::string prefix_;
+    size_t segment_bytes_;
+    uint64_t next_segment_id_ = 0;
+    std::deque<std::unique_ptr<Segment>> segments_; // front = read head, back = write tail
+    size_t records_ = 0;
+    uint64_t bytes_written_ = 0;
+    uint64_t bytes_read_ = 0;
+};
+
+} // namespace telemetryhub::gateway
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace telemetryhub::gateway {
+
+// Cache line size used to keep producer- and consumer-owned indices apart.
+// 64 bytes on x86-64 and on the ARM cores we deploy to.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+inline std::size_t round_up_pow2(std::size_t n)
+{
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/**
+ * @brief Bounded single-producer ring buffer (no locks on the hot path)
+ *
+ * Exactly one thread may call try_push(). try_pop() is safe from the consumer
+ * and from the producer itself, which lets TelemetryQueue evict the oldest
+ * element when full (drop-oldest) without a mutex. Every slot carries a
+ * sequence number (Vyukov-style) so an evicting producer can never overwrite
+ * a slot the consumer is still moving out of.
+ *
+ * head_ and tail_ live on separate cache lines to avoid false sharing between
+ * the producer and consumer cores (see docs/CACHE_LINE_FALSE_SHARING.md).
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    // Capacity is rounded up to the next power of two.
+    explicit SpscRingBuffer(std::size_t capacity)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_))
+    {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer only. Returns false when the ring is full.
+    bool try_push(T&& value)
+    {
+        const std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != pos) {
+            return false; // slot still holds an element from the previous lap
+        }
+        slot.value = std::move(value);
+        slot.seq.store(pos + 1, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value)
+    {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+
+    // Consumer, or the producer when evicting. Returns false when empty.
+    bool try_pop(T& out)
+    {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.seq.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate when called concurrently with push/pop.
+    std::size_t size() const
+    {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return capacity_; }
+    // Memory per slot (element plus sequence number), for footprint estimates.
+    static constexpr std::size_t slot_bytes() { return sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq{0};
+        T value{};
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0}; // consumer side
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0}; // producer side
+};
+
+} // namespace telemetryhub::gateway
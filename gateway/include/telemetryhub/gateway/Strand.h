@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "telemetryhub/gateway/ObjectPool.h"
+#include "telemetryhub/gateway/SpscRingBuffer.h" // kCacheLineSize
+#include "telemetryhub/gateway/Task.h"
+#include "telemetryhub/gateway/ThreadPool.h"
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Serial executors on a ThreadPool, one per key (device, channel)
+ *
+ * Jobs posted for one key run one at a time, in the order they were
+ * posted; jobs for different keys run in parallel on the pool's workers.
+ * That is what stateful per-device work (moving averages, delta encoding)
+ * needs without serializing the whole pipeline.
+ *
+ * No lock anywhere: a key hashes to one of a fixed array of strands (two
+ * keys that collide share a strand, which only adds ordering), and each
+ * strand is an intrusive multi-producer queue (a tail exchange per post)
+ * plus a count of queued jobs. The post that moves a strand's count from 0
+ * to 1 schedules one drain job on the pool; that drain is the strand's only
+ * consumer until it has emptied the strand.
+ *
+ * Fairness: a drain runs at most `budget` jobs, then requeues itself with
+ * ThreadPool::post_shared(), behind every other strand already waiting.
+ * A flooded key therefore gets its turn like any other instead of holding
+ * a worker until its backlog is gone.
+ *
+ * Job nodes come from a fixed arena (`nodes`, heap past that, counted), and
+ * a drain job is `this` plus a strand pointer, so posting does not allocate
+ * once the arena is sized. Jobs must not throw (as with ThreadPool::post).
+ */
+class StrandPool {
+public:
+    // Jobs a drain runs before it yields its worker to other strands
+    static constexpr size_t kDefaultBudget = 16;
+
+    /**
+     * @param pool Pool the drains run on; must outlive this object
+     * @param strands Number of strands, rounded up to a power of two
+     * @param nodes Job nodes preallocated across all strands
+     */
+    explicit StrandPool(ThreadPool& pool, size_t strands = 256, size_t nodes = 1024,
+                        size_t budget = kDefaultBudget);
+
+    /**
+     * @brief Waits until every queued job has run (the pool must still be
+     * running), so no drain outlives the strands
+     */
+    ~StrandPool();
+
+    StrandPool(const StrandPool&) = delete;
+    StrandPool& operator=(const StrandPool&) = delete;
+
+    /**
+     * @brief Queue func behind every job already posted for key
+     */
+    template <typename F>
+    void post(uint64_t key, F&& func);
+
+    // Strand a key maps to (keys with the same index are serialized together)
+    size_t strand_of(uint64_t key) const;
+    size_t strand_count() const { return mask_ + 1; }
+    ThreadPool& pool() const { return pool_; }
+
+    // Storage for `strands` strands and `nodes` job nodes
+    static size_t storage_bytes(size_t strands, size_t nodes);
+
+    struct Metrics {
+        uint64_t jobs_run{0};           ///< Jobs completed
+        uint64_t drains{0};             ///< Drain jobs run on the pool
+        uint64_t yields{0};             ///< Drains that hit the budget and requeued
+        size_t queued{0};               ///< Jobs waiting across all strands
+        size_t busiest_queued{0};       ///< Deepest single strand right now
+        uint64_t node_heap_allocations{0}; ///< Nodes allocated past the arena
+    };
+    Metrics get_metrics() const;
+
+private:
+    struct NodeBase {
+        std::atomic<NodeBase*> next{nullptr};
+    };
+    struct Node : NodeBase {
+        Task fn;
+        void clear() { fn.reset(); }
+    };
+
+    // Producer side (tail, count) and consumer side (head, counters) on
+    // separate lines; stub keeps the queue non-empty (Vyukov MPSC)
+    struct Strand {
+        alignas(kCacheLineSize) std::atomic<NodeBase*> tail{nullptr};
+        std::atomic<size_t> queued{0};
+        alignas(kCacheLineSize) NodeBase* head{nullptr}; // current drain only
+        NodeBase stub;
+        std::atomic<uint64_t> jobs_run{0};
+        std::atomic<uint64_t> drains{0};
+        std::atomic<uint64_t> yields{0};
+    };
+
+    void enqueue(uint64_t key, Task&& fn);
+    static void push(Strand& s, NodeBase* node);
+    static Node* pop(Strand& s);
+    void drain(Strand& s);
+
+    ThreadPool& pool_;
+    const size_t budget_;
+    size_t mask_{0};
+    std::unique_ptr<Strand[]> strands_;
+    ObjectPool<Node> nodes_;
+};
+
+template <typename F>
+void StrandPool::post(uint64_t key, F&& func)
+{
+    enqueue(key, Task(std::forward<F>(func)));
+}
+
+} // namespace telemetryhub::gateway
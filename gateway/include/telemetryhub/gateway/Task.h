@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Move-only void() callable with small-buffer storage (pool jobs)
+ *
+ * std::function must be copyable, so it cannot hold a move-only capture
+ * (a pooled batch Handle, a packaged_task), and libstdc++ only stores
+ * callables of up to two pointers inline. Task keeps up to kInlineSize bytes
+ * inline. That is enough for `this` plus a TelemetrySample, or a
+ * packaged_task, so typical pool jobs never allocate. Larger callables, or
+ * ones whose move can throw, fall back to the heap.
+ *
+ * sizeof(Task) is one cache line: the inline buffer plus an ops pointer.
+ */
+class Task
+{
+public:
+    static constexpr std::size_t kInlineSize = 48;
+
+    Task() noexcept = default;
+
+    template <typename F,
+              typename Fn = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<Fn, Task> && std::is_invocable_v<Fn&>>>
+    Task(F&& func)
+    {
+        if constexpr (fits_inline<Fn>()) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(func));
+            ops_ = &kInlineOps<Fn>;
+        } else {
+            ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<F>(func)));
+            ops_ = &kHeapOps<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept { take(other); }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    // Destroys the callable (and its captures) now
+    void reset() noexcept
+    {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    // Whether F is stored without a heap allocation
+    template <typename F>
+    static constexpr bool fits_inline()
+    {
+        return sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<F>;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        // Move-constructs into dst and destroys src
+        void (*relocate)(void* dst, void* src) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Fn>
+    static constexpr Ops kInlineOps{
+        [](void* s) { (*static_cast<Fn*>(s))(); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* s) noexcept { static_cast<Fn*>(s)->~Fn(); },
+    };
+
+    template <typename Fn>
+    static constexpr Ops kHeapOps{
+        [](void* s) { (**static_cast<Fn**>(s))(); },
+        [](void* dst, void* src) noexcept { ::new (dst) Fn*(*static_cast<Fn**>(src)); },
+        [](void* s) noexcept { delete *static_cast<Fn**>(s); },
+    };
+
+    void take(Task& other) noexcept
+    {
+        if (other.ops_) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+    const Ops* ops_{nullptr};
+};
+
+} // namespace telemetryhub::gateway
@@ -1,36 +1,288 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <filesystem>
 #include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "telemetryhub/device/TelemetrySample.h"
+#include "telemetryhub/device/Timestamp.h"
+#include "telemetryhub/gateway/LatencyHistogram.h"
+#include "telemetryhub/gateway/MpmcRingBuffer.h"
+#include "telemetryhub/gateway/QueuePolicy.h"
+#include "telemetryhub/gateway/RingDeque.h"
+#include "telemetryhub/gateway/SampleBatch.h"
+#include "telemetryhub/gateway/SpillStore.h"
+#include "telemetryhub/gateway/SpscRingBuffer.h"
+#include "telemetryhub/gateway/WaitStrategy.h"
 
 namespace telemetryhub::gateway {
 
+class AsyncSignal;
+
+// Priority lanes. Control items (SampleKind::Status) are always popped before
+// Bulk ones, on every backend. They are never dropped, conflated or aged out
+// by AQM, so a SafeState notification never waits behind a flood of samples.
+enum class Lane : uint8_t
+{
+    Control,
+    Bulk
+};
+inline constexpr size_t kLaneCount = 2;
+
+inline Lane lane_of(const device::TelemetrySample& s)
+{
+    return s.kind == device::SampleKind::Measurement ? Lane::Bulk : Lane::Control;
+}
+
 class TelemetryQueue
 {
 public:
-    // max_size=0 means unbounded. If bounded and full, oldest item is dropped.
-    explicit TelemetryQueue(size_t max_size = 0) : max_size_(max_size) {}
-    void set_capacity(size_t cap) { max_size_ = cap; }
-    void push(const device::TelemetrySample& sample);
+    // Ring backends are always bounded; max_size=0 maps to this capacity.
+    static constexpr size_t kDefaultRingCapacity = 16384;
+
+    // max_size=0 means unbounded. If bounded and full, the backpressure
+    // policy decides (default: oldest item is dropped).
+    explicit TelemetryQueue(size_t max_size = 0, QueueBackend backend = QueueBackend::Mutex);
+    ~TelemetryQueue();
+
+    // Reconfiguring a ring backend rebuilds the ring (queued items are carried
+    // over), so only call these while no thread is pushing or popping.
+    void set_capacity(size_t cap);
+    void set_backend(QueueBackend backend);
+    QueueBackend backend() const { return backend_; }
+
+    // Zero-heap mode: sizes the mutex-backend storage for the full capacity
+    // and the control lane for kControlReserve events up front, so that push
+    // and pop never allocate afterwards (rings are always preallocated). Only
+    // meaningful for a bounded queue; same threading rule as set_backend().
+    static constexpr size_t kControlReserve = 64;
+    void preallocate();
+    // Bytes of sample storage a full queue of this backend/capacity holds.
+    static size_t storage_bytes(QueueBackend backend, size_t capacity);
+    static constexpr size_t control_storage_bytes() { return kControlReserve * sizeof(Entry); }
+
+    // Overload handling; same threading rule as set_backend().
+    void set_backpressure_policy(BackpressurePolicy policy) { policy_ = policy; }
+    void set_block_timeout(std::chrono::milliseconds timeout) { block_timeout_ = timeout; }
+    void set_decimate_factor(uint32_t n) { decimate_n_ = n < 1 ? 1 : n; }
+    BackpressurePolicy backpressure_policy() const { return policy_; }
+    // SpillToDisk storage; defaults to <temp>/telemetryhub-spill and 16 MiB segments.
+    void set_spill_directory(std::filesystem::path dir) { spill_dir_ = std::move(dir); }
+    void set_spill_segment_bytes(size_t bytes) { spill_segment_bytes_ = bytes; }
+
+    // Latency-bounded AQM (CoDel-style). Every sample is stamped on enqueue;
+    // at dequeue, once the queue delay has stayed at or above `target` for a
+    // whole `interval` (a standing queue, not a burst), samples older than
+    // `target` are dropped until a fresh one is seen. target=0 disables it;
+    // interval=0 turns target into a hard age limit. Same threading rule.
+    void set_sojourn_target(std::chrono::milliseconds target);
+    void set_sojourn_interval(std::chrono::milliseconds interval);
+
+    // How idle consumers wait (default SpinThenPark). Same threading rule.
+    void set_wait_strategy(WaitStrategy strategy) { wait_strategy_ = strategy; }
+    WaitStrategy wait_strategy() const { return wait_strategy_; }
+
+    // Consumer that must not block its thread (a coroutine, see
+    // async_pop_batch): notified whenever items become poppable and on
+    // shutdown. nullptr = none (default). Same threading rule.
+    void set_async_signal(AsyncSignal* signal) { async_signal_ = signal; }
+    AsyncSignal* async_signal() const { return async_signal_; }
+
+    // Returns false if the sample was rejected (policy or shutdown).
+    bool push(const device::TelemetrySample& sample);
     // Optimized path to avoid extra copy when the caller can move
-    void push(device::TelemetrySample&& sample);
+    bool push(device::TelemetrySample&& sample);
     std::optional<device::TelemetrySample> pop();
+    // Timed variants: nullopt on timeout, or once shut down and drained.
+    std::optional<device::TelemetrySample> try_pop_for(std::chrono::milliseconds timeout);
+    std::optional<device::TelemetrySample> try_pop() { return try_pop_for(std::chrono::milliseconds(0)); }
+
+    // Push a burst with one lock acquisition and one wakeup (same backpressure
+    // rules as push()). Returns how many samples were accepted.
+    size_t push_bulk(std::span<const device::TelemetrySample> samples);
+    size_t push_bulk(const SampleBatch& batch);
+    // Wait up to `timeout` for data, then move up to max_items samples onto the
+    // end of `out`. Returns how many were appended; 0 means the wait timed out,
+    // everything queued was stale (AQM), or the queue is shut down and drained
+    // (check is_shutdown()).
+    size_t pop_batch(std::vector<device::TelemetrySample>& out, size_t max_items,
+                     std::chrono::milliseconds timeout);
+    // Same, appending rows to a column batch (no intermediate vector). Capacity,
+    // drops and AQM still work per sample; only the hand-off is batched.
+    size_t pop_batch(SampleBatch& out, size_t max_items, std::chrono::milliseconds timeout);
 
-    // Signal that no more items will be produced; unblocks waiting consumers.
+    // Signal that no more items will be produced; unblocks waiting consumers
+    // and producers blocked by BlockWithTimeout.
     void shutdown();
-    
+    bool is_shutdown() const { return shutdown_.load(std::memory_order_acquire); }
+
     // Get current queue depth (for metrics)
     size_t size();
 
+    struct Metrics {
+        uint64_t pushed{0};          ///< Samples accepted into the queue
+        uint64_t dropped_oldest{0};  ///< Queued samples evicted to make room
+        uint64_t dropped_newest{0};  ///< Incoming samples rejected (incl. block timeouts)
+        uint64_t decimated{0};       ///< Incoming samples skipped by DecimateEveryNth
+        uint64_t block_timeouts{0};  ///< BlockWithTimeout waits that expired
+        uint64_t aqm_dropped{0};     ///< Stale samples dropped at dequeue (sojourn target)
+        uint64_t conflated{0};       ///< Queued samples superseded by a newer one (same key)
+        uint64_t spilled{0};         ///< Samples written to the disk spill (SpillToDisk)
+        uint64_t restored{0};        ///< Spilled samples read back into the queue
+        size_t spill_depth{0};       ///< Samples currently on disk
+        uint64_t spill_disk_bytes{0};    ///< Size of the spill segment files
+        uint64_t spill_bytes_written{0};
+        uint64_t spill_bytes_read{0};
+        double spill_write_mb_s{0.0};    ///< Spill throughput while writing
+        double spill_read_mb_s{0.0};     ///< Restore throughput while reading
+        size_t depth{0};             ///< Current queue depth
+        size_t high_watermark{0};    ///< Deepest the queue has been
+        LatencyHistogram::Summary sojourn; ///< Queue delay of delivered bulk samples
+
+        struct LaneMetrics {
+            uint64_t pushed{0};
+            size_t depth{0};
+            LatencyHistogram::Summary sojourn;
+        };
+        std::array<LaneMetrics, kLaneCount> lanes; ///< Indexed by Lane
+
+        uint64_t dropped_total() const
+        {
+            return dropped_oldest + dropped_newest + decimated + aqm_dropped;
+        }
+    };
+    Metrics get_metrics() const;
+
 private:
-    std::mutex mutex_;
+    // What the storage actually holds: the sample plus its enqueue stamp
+    // (device::mono_ns(), cheap enough to take on every push and pop).
+    struct Entry {
+        device::TelemetrySample sample;
+        int64_t enqueued_ns = 0;
+    };
+
+    // AQM decision at dequeue; records the sojourn of delivered samples.
+    bool deliver(const Entry& entry, int64_t now_ns);
+
+    bool push_locked(std::unique_lock<std::mutex>& lock, device::TelemetrySample&& sample);
+    // Control lane: a small mutex-guarded deque, checked before the bulk storage
+    bool push_control(device::TelemetrySample&& sample);
+    bool push_control_locked(device::TelemetrySample&& sample);
+    bool take_control(Entry& out);
+    bool take_control_locked(Entry& out);
+    std::optional<device::TelemetrySample> pop_until(const std::chrono::steady_clock::time_point* deadline);
+    void spin_for_data(const std::chrono::steady_clock::time_point* deadline);
+    Entry pop_front_locked();
+    bool spill_locked(device::TelemetrySample&& sample);
+    // Moves spilled samples back into queue_ until it holds `limit` entries
+    void restore_spill_locked(size_t limit);
+    void rebuild_index();
+    bool uses_ring() const { return backend_ == QueueBackend::Spsc || backend_ == QueueBackend::Mpmc; }
+    static uint64_t conflation_key(const device::TelemetrySample& s)
+    {
+        return (static_cast<uint64_t>(s.device_id) << 16) | s.channel;
+    }
+    bool make_room_locked(std::unique_lock<std::mutex>& lock);
+    bool admit_decimated();
+    void note_depth(size_t depth);
+
+    void rebuild_ring();
+    void drain_ring_into(std::vector<Entry>& out);
+    template <typename Ring> bool push_ring(Ring& ring, device::TelemetrySample&& sample);
+    template <typename Ring> bool enqueue_ring(Ring& ring, device::TelemetrySample&& sample);
+    template <typename Ring> bool wait_ring_space(Ring& ring, size_t limit);
+    template <typename Ring>
+    std::optional<device::TelemetrySample> pop_ring(Ring& ring,
+                                                    const std::chrono::steady_clock::time_point* deadline);
+    // Out is std::vector<TelemetrySample> or SampleBatch; row(i) yields sample i
+    template <typename Row> size_t push_rows(size_t n, Row row);
+    template <typename Out>
+    size_t pop_batch_into(Out& out, size_t max_items, std::chrono::milliseconds timeout);
+    template <typename Ring, typename Out>
+    size_t pop_batch_ring(Ring& ring, Out& out, size_t max_items, std::chrono::milliseconds timeout);
+    // Blocks until `first` holds an element (true) or the queue is shut down
+    // and empty / the optional deadline passes (false). `from_control`, when
+    // given, is cleared if `first` came from the ring rather than the control lane.
+    template <typename Ring>
+    bool wait_ring(Ring& ring, Entry& first,
+                   const std::chrono::steady_clock::time_point* deadline,
+                   bool* from_control = nullptr);
+    template <typename Ready>
+    void park_ring_consumer(Ready& ready, const std::chrono::steady_clock::time_point* deadline);
+    void wake_ring_consumer(bool all = false);
+    void wake_ring_producer(bool all = false);
+    void wake_async_consumer();
+    size_t ring_size() const;
+
+    mutable std::mutex mutex_;
     std::condition_variable cv_;
-    std::queue<device::TelemetrySample> queue_;
-    bool shutdown_ = false;
+    std::condition_variable space_cv_; // BlockWithTimeout producers wait here
+    RingDeque<Entry> queue_; // grows to its high-water mark, then never allocates
+    // queue_.size() mirrored for lock-free polling in the spin phase
+    std::atomic<size_t> depth_hint_{0};
+    RingDeque<Entry> control_;
+    std::atomic<size_t> control_depth_{0}; // control_.size(), readable without the lock
+    // Conflating only: key -> absolute position in queue_ (front is head_pos_)
+    std::unordered_map<uint64_t, uint64_t> index_;
+    uint64_t head_pos_ = 0;
+    std::atomic<bool> shutdown_{false};
     size_t max_size_ = 0;
+
+    QueueBackend backend_ = QueueBackend::Mutex;
+    // Exactly one of these is set when uses_ring()
+    std::unique_ptr<SpscRingBuffer<Entry>> spsc_;
+    std::unique_ptr<MpmcRingBuffer<Entry>> mpmc_;
+    // Consumers parked on cv_ while a ring backend is empty; lets push()
+    // skip the mutex entirely when nobody is waiting.
+    std::atomic<int> ring_waiters_{0};
+    // Producers parked on space_cv_ (BlockWithTimeout); same idea for pop().
+    std::atomic<int> space_waiters_{0};
+
+    WaitStrategy wait_strategy_ = WaitStrategy::SpinThenPark;
+    FutexEvent data_event_; // ring consumers park here under WaitStrategy::Futex
+    AsyncSignal* async_signal_ = nullptr;
+
+    BackpressurePolicy policy_ = BackpressurePolicy::DropOldest;
+    std::chrono::milliseconds block_timeout_{10};
+    uint32_t decimate_n_ = 4;
+    std::atomic<uint64_t> overflow_arrivals_{0}; // DecimateEveryNth phase
+
+    // SpillToDisk: created on first overflow. While it holds anything, new
+    // samples go behind it so order is kept.
+    std::unique_ptr<SpillStore> spill_;
+    std::filesystem::path spill_dir_;
+    size_t spill_segment_bytes_ = SpillStore::kDefaultSegmentBytes;
+    uint64_t spill_write_ns_ = 0; // time spent appending/restoring (under mutex_)
+    uint64_t spill_read_ns_ = 0;
+
+    std::chrono::steady_clock::duration sojourn_target_{0};
+    std::chrono::steady_clock::duration sojourn_interval_{std::chrono::milliseconds(100)};
+    // steady_clock ns at which a standing queue starts being dropped; 0 = below target
+    std::atomic<int64_t> drop_after_ns_{0};
+    LatencyHistogram sojourn_;
+    LatencyHistogram control_sojourn_;
+
+    // Drop accounting (relaxed; read by get_metrics())
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> control_pushed_{0};
+    std::atomic<uint64_t> dropped_oldest_{0};
+    std::atomic<uint64_t> dropped_newest_{0};
+    std::atomic<uint64_t> decimated_{0};
+    std::atomic<uint64_t> block_timeouts_{0};
+    std::atomic<uint64_t> aqm_dropped_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> spilled_{0};
+    std::atomic<uint64_t> restored_{0};
+    std::atomic<size_t> high_watermark_{0};
 };
 
 } // namespace telemetryhub::gateway
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <exception>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Thread placement helpers: CPU pinning, thread names, NUMA nodes
+ *
+ * Pinning keeps a hot thread (producer, consumer, pool worker) on the cores
+ * it was given, so its caches and the memory it first touched stay local.
+ * There is no libnuma dependency: memory is placed by the kernel's default
+ * first-touch policy, so "NUMA-local" here means "allocated and touched by
+ * a thread pinned to that node" (see run_pinned).
+ *
+ * Linux uses pthread affinity and names (visible in top -H, perf, gdb);
+ * Windows uses SetThreadAffinityMask (first 64 CPUs) and
+ * SetThreadDescription. Elsewhere pinning is unsupported and reports false.
+ */
+
+// Upper bound (exclusive) on CPU ids parse_cpu_list accepts
+inline constexpr int kMaxCpuId = 4096;
+
+// Parses "0-3,8,10-11" into sorted, de-duplicated CPU ids. Empty text (or
+// "none") gives an empty list, meaning "not pinned". False on bad syntax
+// or an id of kMaxCpuId or more.
+bool parse_cpu_list(const std::string& text, std::vector<int>& out);
+
+// Inverse of parse_cpu_list, collapsing runs: {0,1,2,3,8} -> "0-3,8"
+std::string format_cpu_list(const std::vector<int>& cpus);
+
+// Restricts the calling thread to cpus. An empty list is a no-op that
+// returns true; false if the OS rejected the set (offline/unknown CPU).
+bool pin_current_thread(const std::vector<int>& cpus);
+
+// Names the calling thread. Linux truncates to 15 characters.
+void set_current_thread_name(const char* name);
+std::string current_thread_name();
+
+// CPU the calling thread is running on (-1 if unknown)
+int current_cpu();
+
+// NUMA node of a CPU, from sysfs (-1 if unknown, e.g. not Linux)
+int numa_node_of_cpu(int cpu);
+
+// True when every CPU in the list is on the same (known) node. Placement
+// only helps then; sets that straddle nodes are logged as a warning.
+bool cpus_share_numa_node(const std::vector<int>& cpus);
+
+/**
+ * @brief Runs f() on a short-lived thread pinned to cpus and waits for it
+ *
+ * Anything f() allocates and writes lands on the node of those CPUs
+ * (first touch), which is how queue rings and pool storage are placed next
+ * to the threads that use them. With an empty list f() runs inline.
+ */
+template <typename F>
+void run_pinned(const std::vector<int>& cpus, F&& f)
+{
+    if (cpus.empty()) {
+        std::forward<F>(f)();
+        return;
+    }
+    std::exception_ptr error;
+    std::thread t([&cpus, &f, &error] {
+        pin_current_thread(cpus);
+        try {
+            std::forward<F>(f)();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    t.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace telemetryhub::gateway
@@ -1,26 +1,70 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
+#include <latch>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
+#include "telemetryhub/gateway/LatencyHistogram.h"
+#include "telemetryhub/gateway/ObjectPool.h"
+#include "telemetryhub/gateway/RingDeque.h"
+#include "telemetryhub/gateway/Task.h"
+#include "telemetryhub/gateway/WaitStrategy.h"
+#include "telemetryhub/gateway/WorkStealingDeque.h"
 
 namespace telemetryhub::gateway {
 
 /**
- * @brief Simple thread pool for processing telemetry samples
+ * @brief Scheduling class of a pool job
+ *
+ * Jobs posted without one are Normal and take the lock-free deque path.
+ * Tagged jobs (a class and/or a deadline) are dispatched earliest deadline
+ * first; a class without an explicit deadline gets now + its default budget.
+ */
+enum class JobPriority : uint8_t { Critical, High, Normal, Low };
+inline constexpr size_t kJobPriorities = 4;
+const char* to_string(JobPriority priority);
+
+/**
+ * @brief Work-stealing thread pool for processing telemetry samples
  * 
  * Features:
- * - Fixed number of worker threads
- * - Job queue with FIFO processing
- * - Metrics: jobs processed, average processing time
+ * - Fixed worker count, or elastic between min and max (see ElasticConfig)
+ * - Per-worker lock-free deques; jobs submitted from a worker stay local
+ * - Idle workers steal from a random victim, oldest job first
+ * - Jobs submitted from outside the pool go through a shared FIFO
+ * - Metrics: jobs processed, queue-wait and run-time percentiles, busy
+ *   time per worker, steals
  * - Graceful shutdown with job completion
  * 
+ * Scheduling: a worker runs its own deque newest-first (the job it just
+ * spawned is the one whose data is still in cache), then the shared
+ * injection queue, then steals. Only the injection queue takes a lock, so
+ * fan-out from inside jobs never contends on it. Ordering across jobs is
+ * therefore not FIFO; callers that need ordering must chain jobs.
+ *
+ * Deadlines: jobs posted with a JobPriority and/or a deadline go into one
+ * EDF heap. Critical and High jobs, and any tagged job past its deadline,
+ * are taken before everything else; Normal and Low tagged jobs otherwise
+ * run only when the deque path is empty. Starvation protection is twofold:
+ * tagged jobs age (a Low job's default deadline is 1 s out, after which it
+ * is urgent too), and after kUrgentBurst urgent jobs in a row a worker
+ * takes one untagged job first.
+ *
+ * Elastic sizing: worker slots (deque, counters) exist up to max_threads
+ * from the start and never move, so growing only starts a thread on a free
+ * slot and shrinking only stops one. A retiring worker finishes the jobs
+ * left in its own deque, then exits; its slot stays readable for thieves
+ * and is reused by the next worker started there.
+ * 
  * Design considerations:
  * - Reduces thread creation overhead for high-frequency tasks
  * - Limits concurrency for bounded resource usage
@@ -29,11 +73,59 @@ namespace telemetryhub::gateway {
  */
 class ThreadPool {
 public:
+    /**
+     * @brief Worker bounds and the resize controller's thresholds
+     *
+     * Every interval the controller looks at the backlog (queued jobs) and
+     * at how busy the active workers were during that tick. A tick is
+     * pressured when more than grow_backlog jobs per worker are queued, or
+     * when the workers were busy for at least grow_utilization of it and
+     * jobs are still waiting; it is idle when nothing is queued and busy
+     * time stayed below shrink_utilization. grow_ticks pressured ticks in a
+     * row start one worker, shrink_ticks idle ticks in a row retire one.
+     * The gap between the two thresholds and the much longer shrink window
+     * are the hysteresis: a burst grows the pool within a few ticks, a lull
+     * has to last seconds before it shrinks, and a steady load that sits
+     * between the thresholds leaves the size alone.
+     */
+    struct ElasticConfig {
+        size_t min_threads{1};
+        size_t max_threads{0};                       ///< 0 = hardware concurrency
+        std::chrono::milliseconds interval{50};      ///< Controller tick
+        size_t grow_backlog{2};                      ///< Queued jobs per worker
+        double grow_utilization{0.9};
+        unsigned grow_ticks{2};
+        double shrink_utilization{0.3};
+        unsigned shrink_ticks{40};                   ///< 2 s at the default tick
+
+        // max 0 -> hardware concurrency; min clamped to [1, max]
+        ElasticConfig resolved() const;
+    };
+
     /**
      * @brief Construct thread pool with N worker threads
      * @param num_threads Number of worker threads (0 = hardware concurrency)
+     * @param wait How idle workers wait for jobs
+     * @param cpus CPUs to pin workers to, one each round-robin (empty = unpinned)
+     *
+     * Each worker pins itself, names itself "thub-pool-<i>" and then
+     * allocates its own deque, so the deque is first-touched on the
+     * worker's NUMA node. The constructor returns once every worker is up.
+     */
+    explicit ThreadPool(size_t num_threads = 0, WaitStrategy wait = WaitStrategy::Block,
+                        std::vector<int> cpus = {});
+
+    /**
+     * @brief Construct an elastic pool: min_threads workers up front, up to
+     * max_threads under load
+     *
+     * With min < max a controller thread ("thub-pool-ctl") resizes the pool
+     * one worker per decision. The job arena and the deques are sized for
+     * max_threads here; a worker allocates its slot's counters the first
+     * time that slot is started. Workers pin to cpus[slot % cpus.size()].
      */
-    explicit ThreadPool(size_t num_threads = 0);
+    explicit ThreadPool(const ElasticConfig& elastic, WaitStrategy wait = WaitStrategy::Block,
+                        std::vector<int> cpus = {});
     
     /**
      * @brief Destructor - waits for all jobs to complete
@@ -58,40 +150,288 @@ public:
     template<typename F, typename... Args>
     auto submit(F&& func, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
 
+    /**
+     * @brief Queue a fire-and-forget job: no packaged_task, no future
+     *
+     * The job is held in a Task inside a preallocated job node. Callables
+     * that fit Task's inline buffer (48 bytes, e.g. `this` plus a sample)
+     * are queued without touching the heap once reserve() has sized the
+     * injection queue and while the job arena is not exhausted. Move-only
+     * captures are fine.
+     */
+    template<typename F>
+    void post(F&& func);
+
+    /**
+     * @brief post() through the shared FIFO even when called from a worker
+     *
+     * A job posted from a worker normally lands on top of that worker's own
+     * deque and runs next. Jobs that requeue themselves to give others a
+     * turn (StrandPool drains) use this instead, so they go behind
+     * everything already waiting.
+     */
+    template<typename F>
+    void post_shared(F&& func);
+
+    /**
+     * @brief Queue a job by class and optional deadline (EDF dispatch)
+     * @param deadline When the job should have finished; default is now
+     *        plus default_budget(priority)
+     *
+     * Tagged jobs share one mutex-guarded heap, so they cost a lock per
+     * submit and per dispatch; keep bulk work on the untagged post().
+     */
+    template<typename F>
+    void post(F&& func, JobPriority priority);
+    template<typename F>
+    void post(F&& func, JobPriority priority, std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief submit() with a class: a future for an EDF-dispatched job
+     */
+    template<typename F, typename... Args>
+    auto submit(JobPriority priority, F&& func, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    // Deadline a tagged job gets when none is given (Critical 1 ms, High
+    // 10 ms, Normal 100 ms, Low 1 s after submission)
+    static constexpr std::chrono::nanoseconds default_budget(JobPriority priority)
+    {
+        constexpr std::chrono::nanoseconds budgets[kJobPriorities] = {
+            std::chrono::milliseconds(1), std::chrono::milliseconds(10),
+            std::chrono::milliseconds(100), std::chrono::seconds(1)};
+        return budgets[static_cast<size_t>(priority)];
+    }
+
+    // Urgent EDF jobs a worker runs in a row before it lets one untagged job through
+    static constexpr unsigned kUrgentBurst = 8;
+
+    /**
+     * @brief Run body(chunk_begin, chunk_end) over [begin, end) in parallel
+     * @param grain Indices per chunk (0 = about four chunks per worker)
+     *
+     * The calling thread works through chunks too, next to up to
+     * thread_count() helper jobs; chunks are claimed from one shared atomic
+     * cursor, so fast participants take more of them. Returns once every
+     * chunk has run (one latch for the whole range, not a future per job).
+     * Safe to call from inside a pool job: the caller keeps running queued
+     * jobs while it waits. The first exception thrown by body stops further
+     * chunks from being claimed and is rethrown here.
+     */
+    template<typename Body>
+    void parallel_for(size_t begin, size_t end, Body&& body, size_t grain = 0);
+
+    /**
+     * @brief Map each chunk of [begin, end) to a T, then fold the results
+     *
+     * map(chunk_begin, chunk_end) -> T runs in parallel as in parallel_for;
+     * the per-chunk results are then folded on the calling thread in chunk
+     * order, starting from identity: combine(acc, chunk_result) -> T. The
+     * result is therefore deterministic for a fixed grain, even for
+     * floating-point sums. Allocates one T per chunk.
+     */
+    template<typename T, typename Map, typename Combine>
+    T parallel_reduce(size_t begin, size_t end, T identity, Map&& map, Combine&& combine, size_t grain = 0);
+
+    /**
+     * @brief Preallocate room for n jobs queued from outside the pool
+     *
+     * Sizes the injection queue and the EDF heap (which only grow past
+     * their high-water mark). Job nodes come from a fixed arena of
+     * kJobsPerWorker per worker slot (max_threads of them).
+     */
+    void reserve(size_t n);
+
+    // Local deque slots and job nodes per worker
+    static constexpr size_t kJobsPerWorker = 128;
+
+    /**
+     * @brief Bytes of job storage: the arena, the worker slots (all
+     * max_threads of them) and room for `queued` jobs in the injection
+     * queue and the EDF heap
+     */
+    size_t storage_bytes(size_t queued) const;
+
     /**
      * @brief Get metrics for monitoring
      */
+    // Per class; untagged jobs count as Normal
+    struct PriorityStats {
+        uint64_t jobs{0};                     ///< Jobs run
+        LatencyHistogram::Summary queue_wait; ///< Enqueue -> start, ns
+        uint64_t deadline_misses{0};          ///< Tagged jobs that finished after their deadline
+    };
+
     struct Metrics {
         uint64_t jobs_processed{0};     ///< Total jobs completed
         uint64_t jobs_queued{0};        ///< Jobs currently in queue
         double avg_processing_ms{0.0};  ///< Average job processing time
-        size_t num_threads{0};          ///< Number of worker threads
+        size_t num_threads{0};          ///< Active worker threads
+        size_t min_threads{0};          ///< Elastic bounds (equal for a fixed pool)
+        size_t max_threads{0};
+        uint64_t workers_started{0};    ///< Resize events: workers the controller added
+        uint64_t workers_retired{0};    ///< ... and removed
+        uint64_t jobs_local{0};         ///< Jobs pushed to the submitting worker's own deque
+        uint64_t jobs_stolen{0};        ///< Jobs taken from another worker's deque
+        uint64_t steal_attempts{0};     ///< Victim deques probed by idle workers
+        uint64_t job_heap_allocations{0}; ///< Job nodes allocated because the arena was exhausted
+        size_t workers_pinned{0};       ///< Workers whose affinity the OS accepted
+        LatencyHistogram::Summary queue_wait; ///< Enqueue -> start of run, ns
+        LatencyHistogram::Summary run_time;   ///< Start -> end of run, ns
+        double utilization{0.0};        ///< Mean busy fraction of the workers since construction
+        std::vector<double> worker_utilization; ///< Busy fraction per slot ever started, since construction
+        double recent_utilization{0.0}; ///< Busy fraction over the controller's last tick (elastic only)
+        size_t edf_queued{0};           ///< Tagged jobs waiting in the EDF heap
+        std::array<PriorityStats, kJobPriorities> priorities{}; ///< Indexed by JobPriority
     };
     
     Metrics get_metrics() const;
 
     /**
-     * @brief Get number of worker threads
+     * @brief Get number of active worker threads (changes while elastic)
+     */
+    size_t thread_count() const { return active_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Worker bounds, resolved (min == max for a fixed pool)
+     */
+    const ElasticConfig& elastic() const { return elastic_; }
+
+    /**
+     * @brief CPUs the workers were pinned to (empty = unpinned)
+     */
+    const std::vector<int>& cpus() const { return cpus_; }
+
+    /**
+     * @brief Change how idle workers wait; takes effect on their next wait
      */
-    size_t thread_count() const { return workers_.size(); }
+    void set_wait_strategy(WaitStrategy wait) { wait_strategy_.store(wait, std::memory_order_relaxed); }
+    WaitStrategy wait_strategy() const { return wait_strategy_.load(std::memory_order_relaxed); }
 
 private:
-    void worker_loop();
+    // Job node: lives in job_pool_ while queued or running; the deques and
+    // the injection queue hold plain pointers to it
+    struct Job {
+        Task fn;
+        int64_t enqueued_ns{0}; // mono_ns() when queued: start of queue wait
+        int64_t deadline_ns{0}; // mono_ns() deadline; 0 = untagged
+        JobPriority priority{JobPriority::Normal};
+        void clear() { fn.reset(); }
+    };
+
+    struct alignas(kCacheLineSize) Worker {
+        explicit Worker(size_t capacity) : local(capacity) {}
+        WorkStealingDeque<Job*> local;
+        uint64_t rng{0};  // victim selection (xorshift), owner only
+        // Owner-written counters, summed by get_metrics()
+        std::atomic<uint64_t> jobs_local{0};
+        std::atomic<uint64_t> jobs_stolen{0};
+        std::atomic<uint64_t> steal_attempts{0};
+        // Jobs this worker ran: time queued before it started them (per
+        // class), time spent running them (histograms are per worker, so
+        // recording never contends; get_metrics() merges them)
+        std::array<LatencyHistogram, kJobPriorities> queue_wait;
+        LatencyHistogram run_time;
+        std::atomic<uint64_t> busy_ns{0};
+        std::array<std::atomic<uint64_t>, kJobPriorities> deadline_misses{};
+        unsigned urgent_streak{0}; // owner only
+    };
+
+    // A parallel_for/reduce range shared by the caller and its helper jobs;
+    // lives on the caller's stack, which outlives the helpers (the caller
+    // waits on helpers_done)
+    struct ParallelRange {
+        ParallelRange(size_t b, size_t e, size_t g, size_t helpers)
+            : begin(b), end(e), grain(g), chunks((e - b + g - 1) / g), helpers_done(static_cast<std::ptrdiff_t>(helpers)) {}
+        const size_t begin;
+        const size_t end;
+        const size_t grain;
+        const size_t chunks;
+        // Type-erased body: run(body, chunk_index, chunk_begin, chunk_end)
+        void (*run)(void* body, size_t chunk, size_t b, size_t e){nullptr};
+        void* body{nullptr};
+        std::atomic<size_t> next{0};
+        std::latch helpers_done;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+    };
 
-    // Worker threads
-    std::vector<std::thread> workers_;
+    size_t parallel_grain(size_t n, size_t grain) const;
+    size_t parallel_helpers(size_t n, size_t grain) const;
+    void run_parallel(ParallelRange& range, size_t helpers);
+    static void drain_range(ParallelRange& range);
+
+    // Slot lifecycle; only the constructor, the controller and the
+    // destructor change Empty/Running and touch threads_
+    enum class SlotState : uint8_t { Empty, Running, Retiring, Exited };
+
+    void worker_loop(size_t index, bool initial);
+    void retire_current(Worker& self);
+    void start_worker(size_t index, bool initial);
+    void controller_loop();
+    bool grow();
+    bool shrink();
+    Worker* slot(size_t index) const { return slots_[index].load(std::memory_order_acquire); }
+    void enqueue(Task&& fn, bool allow_local = true);
+    void enqueue(Task&& fn, JobPriority priority, int64_t deadline_ns);
+    Job* find_job(size_t index);
+    Job* find_untagged_job(Worker& self, size_t index);
+    Job* take_edf(bool urgent_only);
+    void run_job(Job* job);
+    void notify_one();
+
+    // Worker slots, max_threads of them. A worker allocates its slot's
+    // Worker the first time the slot runs (owned_[i], written only by that
+    // worker) and publishes it in slots_[i]; thieves skip slots that are
+    // still null. slots_used_ is one past the highest slot ever started.
+    const ElasticConfig elastic_;
+    std::vector<std::thread> threads_;
+    std::vector<std::unique_ptr<Worker>> owned_;
+    std::vector<std::atomic<Worker*>> slots_;
+    std::vector<std::atomic<SlotState>> states_;
+    std::atomic<size_t> slots_used_{0};
+    std::atomic<size_t> active_{0};
+    ObjectPool<Job> job_pool_;
+    const std::vector<int> cpus_;
+    std::latch started_; // the min_threads initial workers
+    std::atomic<size_t> workers_pinned_{0};
+
+    // Resize controller (elastic pools only)
+    std::thread controller_;
+    std::mutex controller_mutex_;
+    std::condition_variable controller_cv_;
+    std::atomic<uint64_t> workers_started_{0};
+    std::atomic<uint64_t> workers_retired_{0};
+    std::atomic<double> recent_utilization_{0.0};
     
-    // Job queue
-    std::queue<std::function<void()>> jobs_;
+    // Injection queue for jobs submitted from outside the pool (FIFO ring;
+    // grows to its high-water mark, then reuses slots)
+    RingDeque<Job*> injected_;
+    std::atomic<size_t> injected_size_{0};
     mutable std::mutex queue_mutex_;
     std::condition_variable cv_;
+
+    // Tagged jobs, min-heap on deadline_ns (guarded by queue_mutex_).
+    // edf_size_ and edf_urgent_ (Critical/High queued) let workers skip the
+    // lock; edf_due_ns_ is the earliest deadline (INT64_MAX when empty).
+    std::vector<Job*> edf_;
+    std::atomic<size_t> edf_size_{0};
+    std::atomic<size_t> edf_urgent_{0};
+    std::atomic<int64_t> edf_due_ns_{INT64_MAX};
     
     // Shutdown flag
     std::atomic<bool> stop_{false};
-    
-    // Metrics
-    std::atomic<uint64_t> jobs_processed_{0};
-    std::atomic<uint64_t> total_processing_time_us_{0};  // microseconds
+
+    // Idle wait: pending_ counts queued jobs across all queues (raised before
+    // a job is published, so it never underflows); sleepers_ lets submitters
+    // skip the mutex when nobody is parked on cv_; job_event_ is where Futex
+    // workers park
+    std::atomic<WaitStrategy> wait_strategy_{WaitStrategy::Block};
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> sleepers_{0};
+    FutexEvent job_event_;
+
+    // Utilization is busy time over time since construction
+    const int64_t created_ns_;
 };
 
 // Template implementation must be in header
@@ -100,24 +440,103 @@ auto ThreadPool::submit(F&& func, Args&&... args) -> std::future<std::invoke_res
 {
     using return_type = std::invoke_result_t<F, Args...>;
     
-    // Wrap in packaged_task to get future
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(func), std::forward<Args>(args)...)
+    // Wrap in packaged_task to get future. The task is moved into the job
+    // (it fits Task's inline buffer), so the only allocation left is the
+    // future's shared state.
+    std::packaged_task<return_type()> task(
+        [func = std::forward<F>(func), ... args = std::forward<Args>(args)]() mutable {
+            return std::invoke(func, args...);
+        }
     );
     
-    std::future<return_type> result = task->get_future();
-    
-    {
-        std::lock_guard lock(queue_mutex_);
-        
-        if (stop_) {
-            throw std::runtime_error("ThreadPool is stopped, cannot submit new jobs");
+    std::future<return_type> result = task.get_future();
+    enqueue([task = std::move(task)]() mutable { task(); });
+    return result;
+}
+
+template<typename F>
+void ThreadPool::post(F&& func)
+{
+    enqueue(Task(std::forward<F>(func)));
+}
+
+template<typename F>
+void ThreadPool::post_shared(F&& func)
+{
+    enqueue(Task(std::forward<F>(func)), false);
+}
+
+template<typename F>
+void ThreadPool::post(F&& func, JobPriority priority)
+{
+    enqueue(Task(std::forward<F>(func)), priority, 0);
+}
+
+template<typename F>
+void ThreadPool::post(F&& func, JobPriority priority, std::chrono::steady_clock::time_point deadline)
+{
+    // mono_ns() shares steady_clock's epoch
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    enqueue(Task(std::forward<F>(func)), priority, ns > 0 ? ns : 1);
+}
+
+template<typename F, typename... Args>
+auto ThreadPool::submit(JobPriority priority, F&& func, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>>
+{
+    using return_type = std::invoke_result_t<F, Args...>;
+    std::packaged_task<return_type()> task(
+        [func = std::forward<F>(func), ... args = std::forward<Args>(args)]() mutable {
+            return std::invoke(func, args...);
         }
-        
-        jobs_.emplace([task]() { (*task)(); });
+    );
+    std::future<return_type> result = task.get_future();
+    enqueue([task = std::move(task)]() mutable { task(); }, priority, 0);
+    return result;
+}
+
+template<typename Body>
+void ThreadPool::parallel_for(size_t begin, size_t end, Body&& body, size_t grain)
+{
+    if (end <= begin) {
+        return;
+    }
+    grain = parallel_grain(end - begin, grain);
+    const size_t helpers = parallel_helpers(end - begin, grain);
+    ParallelRange range(begin, end, grain, helpers);
+    range.body = &body;
+    range.run = [](void* b, size_t, size_t chunk_begin, size_t chunk_end) {
+        (*static_cast<std::remove_reference_t<Body>*>(b))(chunk_begin, chunk_end);
+    };
+    run_parallel(range, helpers);
+}
+
+template<typename T, typename Map, typename Combine>
+T ThreadPool::parallel_reduce(size_t begin, size_t end, T identity, Map&& map, Combine&& combine, size_t grain)
+{
+    if (end <= begin) {
+        return identity;
+    }
+    grain = parallel_grain(end - begin, grain);
+    const size_t helpers = parallel_helpers(end - begin, grain);
+    ParallelRange range(begin, end, grain, helpers);
+
+    // One slot per chunk, each written by exactly one participant
+    struct Context {
+        Map& map;
+        std::vector<T> partial;
+    } ctx{map, std::vector<T>(range.chunks, identity)};
+    range.body = &ctx;
+    range.run = [](void* c, size_t chunk, size_t chunk_begin, size_t chunk_end) {
+        auto& context = *static_cast<Context*>(c);
+        context.partial[chunk] = context.map(chunk_begin, chunk_end);
+    };
+    run_parallel(range, helpers);
+
+    T result = std::move(identity);
+    for (auto& part : ctx.partial) {
+        result = combine(std::move(result), std::move(part));
     }
-    
-    cv_.notify_one();
     return result;
 }
 
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace telemetryhub::gateway {
+
+// How an idle consumer (TelemetryQueue pop, ThreadPool worker) waits for work.
+//  Block:        park on the condition variable right away (lowest CPU)
+//  Spin:         never park; poll with a pause instruction, yielding now and
+//                then (lowest wakeup latency, keeps a core busy while idle)
+//  SpinThenPark: poll for kSpinBeforePark rounds, then park on the condition
+//                variable
+//  Futex:        same bounded poll, then park on a futex word, so a wakeup
+//                does not have to re-acquire the queue mutex (Linux futex;
+//                other platforms fall back to std::atomic::wait)
+enum class WaitStrategy
+{
+    Block,
+    Spin,
+    SpinThenPark,
+    Futex
+};
+
+const char* to_string(WaitStrategy strategy);
+// Accepts "block" | "spin" | "spin_then_park" | "futex"; false otherwise.
+bool parse_wait_strategy(const std::string& s, WaitStrategy& out);
+
+// Polling rounds a SpinThenPark/Futex waiter spends before parking. Covers
+// the common case where the producer is mid-push without paying a futex wait.
+inline constexpr int kSpinBeforePark = 64;
+
+// CPU hint for busy-wait loops (PAUSE / YIELD); frees pipeline resources for
+// the sibling hyper-thread and avoids a memory-order flush on loop exit.
+inline void cpu_relax()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Spin phase shared by queue and pool waits
+ *
+ * Returns true as soon as ready() holds, false once the strategy's spin
+ * budget is used up (Block: immediately) or the optional deadline passed.
+ * Spin never gives up on its own, so without a deadline it only returns true.
+ */
+template <typename Ready>
+bool spin_until(WaitStrategy strategy, Ready&& ready,
+                const std::chrono::steady_clock::time_point* deadline)
+{
+    if (strategy == WaitStrategy::Block) {
+        return ready();
+    }
+    if (strategy != WaitStrategy::Spin) {
+        for (int i = 0; i < kSpinBeforePark; ++i) {
+            if (ready()) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        return ready();
+    }
+    for (uint32_t i = 1;; ++i) {
+        if (ready()) {
+            return true;
+        }
+        cpu_relax();
+        if ((i & 63) == 0) {
+            // Let a preempted producer run on an oversubscribed machine
+            std::this_thread::yield();
+            if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+                return ready();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Futex-backed event count for the Futex wait strategy
+ *
+ * Waiter:   epoch = prepare_wait(); re-check the condition; then either
+ *           cancel_wait() or wait(epoch, deadline).
+ * Notifier: make the condition true, then notify_one()/notify_all().
+ *
+ * The waiter count and the seq_cst fences on both sides guarantee that either
+ * the waiter sees the condition or the notifier sees the waiter, so notify()
+ * is a single load when nobody is parked.
+ */
+class FutexEvent
+{
+public:
+    uint32_t prepare_wait()
+    {
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    void cancel_wait() { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Parks until notified (epoch moved on) or the optional deadline passes.
+    // May return spuriously; callers re-check their condition.
+    void wait(uint32_t epoch, const std::chrono::steady_clock::time_point* deadline);
+
+    void notify_one() { notify(false); }
+    void notify_all() { notify(true); }
+
+private:
+    void notify(bool all)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        epoch_.fetch_add(1, std::memory_order_release);
+        wake(all);
+    }
+    void wake(bool all);
+
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<int> waiters_{0};
+};
+
+} // namespace telemetryhub::gateway
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include "telemetryhub/gateway/SpscRingBuffer.h" // round_up_pow2, kCacheLineSize
+
+namespace telemetryhub::gateway {
+
+/**
+ * @brief Bounded lock-free work-stealing deque (Chase-Lev)
+ *
+ * One owner thread pushes and pops at the bottom (LIFO, cache-hot work
+ * first); any number of thieves steal from the top (FIFO, oldest work).
+ * push() is a release store and pop() adds one seq_cst fence; only the
+ * race for the last element and steals use a CAS on top_.
+ *
+ * Slots are atomics, so T must be trivially copyable and small - ThreadPool
+ * stores job pointers. The buffer is fixed at construction (rounded up to a
+ * power of two); push() returns false when it is full and the caller spills
+ * elsewhere, so the deque never allocates after construction.
+ *
+ * Follows Le, Pop, Cohen, Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "slots are std::atomic<T>");
+
+public:
+    explicit WorkStealingDeque(std::size_t capacity)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<std::atomic<T>[]>(capacity_))
+    {
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only. False when full.
+    bool push(T value)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(capacity_)) {
+            return false;
+        }
+        slots_[b & mask_].store(value, std::memory_order_relaxed);
+        // Release store rather than fence + relaxed store: same ordering,
+        // and visible to ThreadSanitizer (which does not model fences)
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only. Takes the most recently pushed element.
+    bool pop(T& out)
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed); // was empty
+            return false;
+        }
+        out = slots_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last element: race the thieves for it
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the oldest element; false when empty or when another
+    // thief (or the owner) won the race for it.
+    bool steal(T& out)
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        out = slots_[t & mask_].load(std::memory_order_relaxed);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+    // Approximate when called concurrently.
+    std::size_t size() const
+    {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<std::atomic<T>[]> slots_;
+
+    alignas(kCacheLineSize) std::atomic<int64_t> top_{0};    // thieves
+    alignas(kCacheLineSize) std::atomic<int64_t> bottom_{0}; // owner
+};
+
+} // namespace telemetryhub::gateway
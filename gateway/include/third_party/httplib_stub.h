@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <map>
@@ -19,10 +20,25 @@ public:
   void set_content(const std::string& b, const char* /*mime*/) { body = b; }
 };
 
+// Request handler threads (cpp-httplib: Server::new_task_queue)
+class TaskQueue {
+public:
+  virtual ~TaskQueue() = default;
+};
+
+class ThreadPool : public TaskQueue {
+public:
+  explicit ThreadPool(size_t n, size_t max_queued_requests = 0) : threads(n), max_queued(max_queued_requests) {}
+  size_t threads;
+  size_t max_queued;
+};
+
 class Server {
 public:
   using Handler = std::function<void(const Request&, Response&)>;
 
+  std::function<TaskQueue*(void)> new_task_queue;
+
   void Get(const char* path, Handler h) { 
     routes_[std::string("GET ")+path] = std::move(h); 
   }
@@ -1,4 +1,5 @@
 #include "telemetryhub/gateway/Config.h"
+#include "telemetryhub/gateway/ThreadAffinity.h"
 
 #include <fstream>
 #include <sstream>
@@ -20,6 +21,10 @@ inline ::telemetryhub::LogLevel parse_level(const std::string& s){
   if (s == "debug") return ::telemetryhub::LogLevel::Debug;
   return ::telemetryhub::LogLevel::Trace;
 }
+
+inline bool parse_bool(const std::string& s){
+  return s == "1" || s == "true" || s == "yes" || s == "on";
+}
 }
 
 namespace telemetryhub::gateway {
@@ -45,8 +50,57 @@ bool load_config(const std::string& path, AppConfig& out)
       out.sampling_interval = std::chrono::milliseconds(std::stoll(val));
     } else if (key == "queue_size"){
       out.queue_size = static_cast<size_t>(std::stoull(val));
+    } else if (key == "producer_batch_size"){
+      out.producer_batch_size = static_cast<size_t>(std::stoull(val));
     } else if (key == "log_level"){
       out.log_level = parse_level(val);
+    } else if (key == "queue_backend"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      parse_queue_backend(val, out.queue_backend); // unknown value keeps current backend
+    } else if (key == "queue_policy"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      parse_backpressure_policy(val, out.queue_policy); // unknown value keeps current policy
+    } else if (key == "queue_block_timeout_ms"){
+      out.queue_block_timeout = std::chrono::milliseconds(std::stoll(val));
+    } else if (key == "queue_decimate_n"){
+      out.queue_decimate_n = static_cast<uint32_t>(std::stoul(val));
+    } else if (key == "queue_spill_dir"){
+      out.queue_spill_dir = val;
+    } else if (key == "queue_spill_segment_mb"){
+      out.queue_spill_segment_mb = static_cast<size_t>(std::stoull(val));
+    } else if (key == "queue_sojourn_target_ms"){
+      out.queue_sojourn_target = std::chrono::milliseconds(std::stoll(val));
+    } else if (key == "queue_sojourn_interval_ms"){
+      out.queue_sojourn_interval = std::chrono::milliseconds(std::stoll(val));
+    } else if (key == "queue_wait_strategy" || key == "pool_wait_strategy"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      // unknown value keeps current strategy
+      parse_wait_strategy(val, key == "queue_wait_strategy" ? out.queue_wait_strategy : out.pool_wait_strategy);
+    } else if (key == "zero_heap"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      out.zero_heap = parse_bool(val);
+    } else if (key == "producer_cpus" || key == "consumer_cpus" || key == "pool_cpus"){
+      auto& cpus = key == "producer_cpus" ? out.producer_cpus
+                 : key == "consumer_cpus" ? out.consumer_cpus : out.pool_cpus;
+      parse_cpu_list(val, cpus); // malformed list keeps current value
+    } else if (key == "pool_min_threads"){
+      out.pool_min_threads = static_cast<size_t>(std::stoull(val));
+    } else if (key == "pool_max_threads"){
+      out.pool_max_threads = static_cast<size_t>(std::stoull(val));
+    } else if (key == "pool_ordered"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      out.pool_ordered = parse_bool(val);
+    } else if (key == "pool_offload"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      parse_offload_mode(val, out.pool_offload); // unknown value keeps current mode
+    } else if (key == "pool_offload_threshold_us"){
+      out.pool_offload_threshold = std::chrono::microseconds(std::stoll(val));
+    } else if (key == "loop_model"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      parse_loop_model(val, out.loop_model); // unknown value keeps current model
+    } else if (key == "numa_local"){
+      std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+      out.numa_local = parse_bool(val);
     }
   }
   return true;
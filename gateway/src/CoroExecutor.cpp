@@ -0,0 +1,322 @@
+#include "telemetryhub/gateway/CoroExecutor.h"
+#include "telemetryhub/device/BusInterface.h"
+#include "telemetryhub/gateway/SampleBatch.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/ThreadAffinity.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace telemetryhub::gateway {
+
+namespace {
+// Initial capacity of each loop's ready list, inbox and timer heap; they
+// only grow past it when that many coroutines wait on one loop at once
+constexpr size_t kLoopReserve = 64;
+// Floor for async_read's retry interval, so a zero poll cannot spin the loop
+constexpr std::chrono::microseconds kMinBusPoll{100};
+}
+
+const char* to_string(LoopModel model)
+{
+    switch (model) {
+        case LoopModel::Threads:    return "threads";
+        case LoopModel::Coroutines: return "coroutines";
+        case LoopModel::Single:     return "single";
+    }
+    return "unknown";
+}
+
+bool parse_loop_model(const std::string& s, LoopModel& out)
+{
+    if (s == "threads")    { out = LoopModel::Threads;    return true; }
+    if (s == "coroutines") { out = LoopModel::Coroutines; return true; }
+    if (s == "single")     { out = LoopModel::Single;     return true; }
+    return false;
+}
+
+struct CoroExecutor::Loop {
+    size_t index{0};
+    std::thread thread;
+    // Loop thread only
+    std::vector<std::coroutine_handle<>> ready;
+    std::vector<std::coroutine_handle<>> running;
+    std::vector<Timer*> timers; // min-heap on due
+    // Other threads hand wakeups over here
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::coroutine_handle<>> inbox;
+    bool sleeping{false};
+    bool stop{false};
+    // Written by the loop thread, read by get_metrics()
+    std::atomic<uint64_t> resumes{0};
+    std::atomic<uint64_t> timers_fired{0};
+    std::atomic<uint64_t> remote_wakeups{0};
+    std::atomic<uint64_t> parks{0};
+    std::atomic<bool> pinned{false};
+};
+
+namespace {
+thread_local CoroExecutor::Loop* t_loop = nullptr;
+
+bool later(const CoroExecutor::Timer* a, const CoroExecutor::Timer* b)
+{
+    return a->due > b->due;
+}
+
+// Single writer, so a plain load/store instead of a locked add
+void bump(std::atomic<uint64_t>& counter, uint64_t n = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+}
+
+void CoTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> h) noexcept
+{
+    CoroExecutor* executor = h.promise().executor;
+    h.destroy();
+    if (executor) {
+        executor->task_finished();
+    }
+}
+
+CoroExecutor::CoroExecutor(size_t threads, std::vector<int> cpus)
+    : cpus_(std::move(cpus))
+{
+    threads = std::max<size_t>(1, threads);
+    loops_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        auto loop = std::make_unique<Loop>();
+        loop->index = i;
+        loop->ready.reserve(kLoopReserve);
+        loop->running.reserve(kLoopReserve);
+        loop->timers.reserve(kLoopReserve);
+        loop->inbox.reserve(kLoopReserve);
+        loops_.push_back(std::move(loop));
+    }
+    for (auto& loop : loops_) {
+        loop->thread = std::thread([this, l = loop.get()] { run_loop(*l); });
+    }
+}
+
+CoroExecutor::~CoroExecutor()
+{
+    wait_idle();
+    for (auto& loop : loops_) {
+        {
+            std::lock_guard lock(loop->mutex);
+            loop->stop = true;
+        }
+        loop->cv.notify_one();
+    }
+    for (auto& loop : loops_) {
+        loop->thread.join();
+    }
+}
+
+void CoroExecutor::spawn(CoTask task)
+{
+    spawn_on(next_loop_.fetch_add(1, std::memory_order_relaxed), std::move(task));
+}
+
+void CoroExecutor::spawn_on(size_t index, CoTask task)
+{
+    if (!task.handle_) {
+        return;
+    }
+    task.handle_.promise().executor = this;
+    {
+        std::lock_guard lock(idle_mutex_);
+        ++live_;
+    }
+    spawned_.fetch_add(1, std::memory_order_relaxed);
+    schedule(loops_[index % loops_.size()].get(), std::exchange(task.handle_, {}));
+}
+
+void CoroExecutor::wait_idle()
+{
+    std::unique_lock lock(idle_mutex_);
+    idle_cv_.wait(lock, [this] { return live_ == 0; });
+}
+
+void CoroExecutor::task_finished()
+{
+    std::lock_guard lock(idle_mutex_);
+    if (--live_ == 0) {
+        idle_cv_.notify_all();
+    }
+}
+
+CoroExecutor::Loop* CoroExecutor::current_loop()
+{
+    return t_loop;
+}
+
+void CoroExecutor::schedule(Loop* loop, std::coroutine_handle<> h)
+{
+    if (loop == t_loop) {
+        loop->ready.push_back(h);
+        return;
+    }
+    bool wake = false;
+    {
+        std::lock_guard lock(loop->mutex);
+        loop->inbox.push_back(h);
+        wake = loop->sleeping;
+    }
+    if (wake) {
+        loop->cv.notify_one();
+    }
+}
+
+void CoroExecutor::arm(Timer& timer)
+{
+    auto& timers = t_loop->timers;
+    timers.push_back(&timer);
+    std::push_heap(timers.begin(), timers.end(), later);
+}
+
+void CoroExecutor::run_loop(Loop& loop)
+{
+    t_loop = &loop;
+    const std::string name = "thub-coro-" + std::to_string(loop.index);
+    set_current_thread_name(name.c_str());
+    loop.pinned = !cpus_.empty() && pin_current_thread({cpus_[loop.index % cpus_.size()]});
+
+    std::vector<std::coroutine_handle<>> incoming;
+    incoming.reserve(kLoopReserve);
+    for (;;) {
+        {
+            std::lock_guard lock(loop.mutex);
+            if (loop.stop && loop.inbox.empty()) {
+                break;
+            }
+            incoming.swap(loop.inbox);
+        }
+        if (!incoming.empty()) {
+            bump(loop.remote_wakeups, incoming.size());
+            loop.ready.insert(loop.ready.end(), incoming.begin(), incoming.end());
+            incoming.clear();
+        }
+
+        if (!loop.timers.empty()) {
+            const auto now = std::chrono::steady_clock::now();
+            while (!loop.timers.empty() && loop.timers.front()->due <= now) {
+                std::pop_heap(loop.timers.begin(), loop.timers.end(), later);
+                Timer* timer = loop.timers.back();
+                if (timer->fire(*timer)) {
+                    loop.timers.pop_back();
+                    loop.ready.push_back(timer->waiter);
+                    bump(loop.timers_fired);
+                } else {
+                    std::push_heap(loop.timers.begin(), loop.timers.end(), later); // re-armed later
+                }
+            }
+        }
+
+        if (!loop.ready.empty()) {
+            // Coroutines made ready while these run wait for the next pass
+            loop.running.swap(loop.ready);
+            for (auto h : loop.running) {
+                bump(loop.resumes); // before: the resume may finish the last task
+                h.resume();
+            }
+            loop.running.clear();
+            continue;
+        }
+
+        std::unique_lock lock(loop.mutex);
+        if (!loop.inbox.empty() || loop.stop) {
+            continue;
+        }
+        loop.sleeping = true;
+        bump(loop.parks);
+        auto woken = [&loop] { return !loop.inbox.empty() || loop.stop; };
+        if (loop.timers.empty()) {
+            loop.cv.wait(lock, woken);
+        } else {
+            loop.cv.wait_until(lock, loop.timers.front()->due, woken);
+        }
+        loop.sleeping = false;
+    }
+    t_loop = nullptr;
+}
+
+CoroExecutor::Metrics CoroExecutor::get_metrics() const
+{
+    Metrics m;
+    m.threads = loops_.size();
+    for (const auto& loop : loops_) {
+        m.threads_pinned += loop->pinned.load(std::memory_order_relaxed) ? 1 : 0;
+        m.resumes += loop->resumes.load(std::memory_order_relaxed);
+        m.timers_fired += loop->timers_fired.load(std::memory_order_relaxed);
+        m.remote_wakeups += loop->remote_wakeups.load(std::memory_order_relaxed);
+        m.parks += loop->parks.load(std::memory_order_relaxed);
+    }
+    m.tasks_spawned = spawned_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard lock(idle_mutex_);
+        m.tasks_live = live_;
+    }
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+// Awaitables
+// ---------------------------------------------------------------------------
+
+bool QueuePopAwaiter::await_ready()
+{
+    popped = queue.pop_batch(out, max_items, std::chrono::milliseconds(0));
+    return popped > 0 || queue.is_shutdown();
+}
+
+bool QueuePopAwaiter::await_suspend(std::coroutine_handle<> h)
+{
+    AsyncSignal& signal = *queue.async_signal();
+    signal.arm(CoroExecutor::current_loop(), h);
+    // A push between await_ready() and arm() did not see us armed: look again
+    popped = queue.pop_batch(out, max_items, std::chrono::milliseconds(0));
+    if (popped == 0 && !queue.is_shutdown()) {
+        return true;
+    }
+    // Done without waiting, unless a notify() already claimed the wakeup
+    // (then it has scheduled our resume and we must stay suspended for it)
+    return !signal.disarm();
+}
+
+size_t QueuePopAwaiter::await_resume()
+{
+    if (popped == 0) {
+        popped = queue.pop_batch(out, max_items, std::chrono::milliseconds(0));
+    }
+    return popped;
+}
+
+bool BusReadAwaiter::await_ready()
+{
+    result = bus.read(out, max_len);
+    return result || timeout <= std::chrono::steady_clock::duration::zero();
+}
+
+void BusReadAwaiter::await_suspend(std::coroutine_handle<> h)
+{
+    const auto now = std::chrono::steady_clock::now();
+    poll = std::max<std::chrono::steady_clock::duration>(poll, kMinBusPoll);
+    deadline = now + timeout;
+    due = std::min(now + poll, deadline);
+    waiter = h;
+    fire = [](CoroExecutor::Timer& timer) {
+        auto& self = static_cast<BusReadAwaiter&>(timer);
+        self.result = self.bus.read(self.out, self.max_len);
+        const auto now = std::chrono::steady_clock::now();
+        if (self.result || now >= self.deadline) {
+            return true;
+        }
+        self.due = std::min(now + self.poll, self.deadline);
+        return false;
+    };
+    CoroExecutor::arm(*this);
+}
+
+} // namespace telemetryhub::gateway
@@ -1,19 +1,35 @@
 #include "telemetryhub/gateway/GatewayCore.h"
 #include "telemetryhub/device/DeviceUtils.h"
 #include "telemetryhub/gateway/Log.h"
+#include "telemetryhub/gateway/ThreadAffinity.h"
 
 #include <iostream>
 #include <mutex>
+#include <stdexcept>
 #include <thread>
 #include <chrono>
 using namespace std::chrono_literals; // enable 100ms duration literal
 
 namespace telemetryhub::gateway {
 
+namespace {
+// consumer_loop drains up to this many samples per wakeup and hands them to
+// the pool as one job, amortizing lock, wakeup and submit costs per burst.
+constexpr size_t kConsumerBatchSize = 64;
+// Upper bound on a single pop_batch wait; the loop re-checks shutdown after it.
+constexpr std::chrono::milliseconds kConsumerPollTimeout{100};
+// Batches in flight between consumer and pool workers before acquire() has
+// to allocate: one being filled plus a backlog of queued jobs.
+constexpr size_t kBatchPoolSize = 16;
+// Ordered processing: strands devices hash onto (one node per batch in flight)
+constexpr size_t kDeviceStrands = 64;
+}
+
 GatewayCore::GatewayCore()
     : device_{}, // default Device (e.g. fault after 8 samples)
-      start_time_(std::chrono::steady_clock::now()),
-      thread_pool_(std::make_unique<ThreadPool>(4))  // 4 worker threads for processing
+      batch_pool_(kBatchPoolSize, [](SampleBatch& b) { b.reserve(kConsumerBatchSize); }),
+      thread_pool_(std::make_unique<ThreadPool>(pool_elastic_)), // elastic, 1..hardware threads
+      start_time_(std::chrono::steady_clock::now())
 {
 }
 
@@ -26,11 +42,33 @@ GatewayCore::Metrics GatewayCore::get_metrics() const
 {
     Metrics m;
     m.samples_processed = metrics_samples_processed_.load();
-    m.samples_dropped = metrics_samples_dropped_.load();
-    // Note: queue_.size() requires mutable access, so we can't get accurate depth from const method
-    // TODO: Make queue metrics thread-safe for const access or make get_metrics() non-const
-    m.queue_depth = 0;  // Placeholder - requires non-const access to queue
-    m.latency_p99_ms = 0.0; // TODO: Implement latency tracking with histogram
+    const auto q = queue_.get_metrics();
+    m.samples_dropped = q.dropped_total();
+    m.queue_depth = q.depth;
+    m.queue_dropped_oldest = q.dropped_oldest;
+    m.queue_dropped_newest = q.dropped_newest;
+    m.queue_decimated = q.decimated;
+    m.queue_block_timeouts = q.block_timeouts;
+    m.queue_aqm_dropped = q.aqm_dropped;
+    m.queue_conflated = q.conflated;
+    m.queue_spilled = q.spilled;
+    m.queue_restored = q.restored;
+    m.queue_spill_depth = q.spill_depth;
+    m.queue_spill_disk_bytes = q.spill_disk_bytes;
+    m.queue_spill_write_mb_s = q.spill_write_mb_s;
+    m.queue_spill_read_mb_s = q.spill_read_mb_s;
+    m.queue_high_watermark = q.high_watermark;
+    m.queue_sojourn_p50_ms = static_cast<double>(q.sojourn.p50_ns) / 1e6;
+    m.queue_sojourn_p90_ms = static_cast<double>(q.sojourn.p90_ns) / 1e6;
+    m.queue_sojourn_p99_ms = static_cast<double>(q.sojourn.p99_ns) / 1e6;
+    m.queue_sojourn_max_ms = static_cast<double>(q.sojourn.max_ns) / 1e6;
+    const auto& control = q.lanes[static_cast<size_t>(Lane::Control)];
+    m.queue_control_pushed = control.pushed;
+    m.queue_control_depth = control.depth;
+    m.queue_control_sojourn_p50_ms = static_cast<double>(control.sojourn.p50_ns) / 1e6;
+    m.queue_control_sojourn_p99_ms = static_cast<double>(control.sojourn.p99_ns) / 1e6;
+    m.queue_bulk_depth = q.lanes[static_cast<size_t>(Lane::Bulk)].depth;
+    m.latency_p99_ms = m.queue_sojourn_p99_ms;
     
     auto now = std::chrono::steady_clock::now();
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - start_time_);
@@ -43,13 +81,122 @@ GatewayCore::Metrics GatewayCore::get_metrics() const
         m.pool_jobs_queued = pool_metrics.jobs_queued;
         m.pool_avg_processing_ms = pool_metrics.avg_processing_ms;
         m.pool_num_threads = pool_metrics.num_threads;
+        m.pool_min_threads = pool_metrics.min_threads;
+        m.pool_max_threads = pool_metrics.max_threads;
+        m.pool_workers_started = pool_metrics.workers_started;
+        m.pool_workers_retired = pool_metrics.workers_retired;
+        m.pool_recent_utilization = pool_metrics.recent_utilization;
+        m.pool_jobs_local = pool_metrics.jobs_local;
+        m.pool_jobs_stolen = pool_metrics.jobs_stolen;
+        m.pool_steal_attempts = pool_metrics.steal_attempts;
+        m.threads_pinned = pool_metrics.workers_pinned;
+        m.pool_queue_wait_p50_ms = static_cast<double>(pool_metrics.queue_wait.p50_ns) / 1e6;
+        m.pool_queue_wait_p99_ms = static_cast<double>(pool_metrics.queue_wait.p99_ns) / 1e6;
+        m.pool_queue_wait_p999_ms = static_cast<double>(pool_metrics.queue_wait.p999_ns) / 1e6;
+        m.pool_queue_wait_max_ms = static_cast<double>(pool_metrics.queue_wait.max_ns) / 1e6;
+        m.pool_run_p50_ms = static_cast<double>(pool_metrics.run_time.p50_ns) / 1e6;
+        m.pool_run_p99_ms = static_cast<double>(pool_metrics.run_time.p99_ns) / 1e6;
+        m.pool_run_p999_ms = static_cast<double>(pool_metrics.run_time.p999_ns) / 1e6;
+        m.pool_run_max_ms = static_cast<double>(pool_metrics.run_time.max_ns) / 1e6;
+        m.pool_utilization = pool_metrics.utilization;
+        m.pool_worker_utilization = std::move(pool_metrics.worker_utilization);
+        for (size_t c = 0; c < kJobPriorities; ++c) {
+            const auto& in = pool_metrics.priorities[c];
+            auto& out = m.pool_priorities[c];
+            out.jobs = in.jobs;
+            out.queue_wait_p50_ms = static_cast<double>(in.queue_wait.p50_ns) / 1e6;
+            out.queue_wait_p99_ms = static_cast<double>(in.queue_wait.p99_ns) / 1e6;
+            out.queue_wait_p999_ms = static_cast<double>(in.queue_wait.p999_ns) / 1e6;
+            out.deadline_misses = in.deadline_misses;
+        }
+        m.pool_edf_queued = pool_metrics.edf_queued;
     }
+    if (strands_) {
+        const auto sm = strands_->get_metrics();
+        m.strand_jobs = sm.jobs_run;
+        m.strand_drains = sm.drains;
+        m.strand_yields = sm.yields;
+        m.strand_queued = sm.queued;
+    }
+    const auto om = offload_.get_metrics();
+    m.offload_mode = om.mode;
+    m.offload_threshold_us = om.threshold_us;
+    m.offload_inline_batches = om.inline_jobs;
+    m.offload_pool_batches = om.offloaded_jobs;
+    m.offload_cost_ns_per_sample = om.cost_ns_per_item;
+    m.offload_inline_ms = om.inline_ms;
+    m.loop_model = loop_model_;
+    if (loops_) {
+        const auto lm = loops_->get_metrics();
+        m.loop_threads = lm.threads;
+        m.loop_resumes = lm.resumes;
+        m.loop_parks = lm.parks;
+        m.loop_remote_wakeups = lm.remote_wakeups;
+    } else if (running_) {
+        m.loop_threads = 2;
+    }
+    m.threads_pinned += producer_pinned_.load(std::memory_order_relaxed) ? 1 : 0;
+    m.threads_pinned += consumer_pinned_.load(std::memory_order_relaxed) ? 1 : 0;
+    m.pin_failures = pin_failures_.load(std::memory_order_relaxed);
+
+    const auto bp = batch_pool_.get_metrics();
+    m.batch_pool_acquired = bp.acquired;
+    m.batch_pool_reused = bp.reused;
+    m.batch_pool_heap_allocations = bp.heap_allocations;
+    m.batch_pool_in_use = bp.in_use;
+
+    const auto heap = HeapGuard::get_metrics();
+    m.zero_heap = zero_heap_;
+    m.memory_budget_bytes = memory_budget().total();
+    m.heap_hook_installed = heap.hook_installed;
+    m.heap_allocations = heap.allocations;
+    m.heap_violations = heap.violations;
+    m.heap_exempt = heap.exempt;
     
     return m;
 }
 
+GatewayCore::MemoryBudget GatewayCore::memory_budget() const
+{
+    MemoryBudget b;
+    b.queue_bytes = TelemetryQueue::storage_bytes(queue_backend_, queue_capacity_);
+    b.control_bytes = TelemetryQueue::control_storage_bytes();
+    b.batch_pool_bytes = kBatchPoolSize * (sizeof(SampleBatch) + kConsumerBatchSize * SampleBatch::bytes_per_row());
+    b.producer_bytes = 2 * producer_batch_size_ * SampleBatch::bytes_per_row(); // pending + cloud batch
+    if (loop_model_ != LoopModel::Single) { // no pool in single-thread mode
+        b.job_ring_bytes = thread_pool_ ? thread_pool_->storage_bytes(kBatchPoolSize) : 0;
+        if (ordered_processing_) {
+            b.job_ring_bytes += StrandPool::storage_bytes(kDeviceStrands, kBatchPoolSize);
+        }
+    }
+    return b;
+}
+
 void GatewayCore::start()
 {
+    if (zero_heap_)
+    {
+        // Everything the pipeline touches must have a fixed size up front
+        if (queue_capacity_ == 0 && queue_backend_ == QueueBackend::Mutex)
+        {
+            throw std::invalid_argument("zero_heap requires a bounded queue (queue_size > 0)");
+        }
+        if (queue_backend_ == QueueBackend::Conflating)
+        {
+            throw std::invalid_argument("zero_heap does not support the conflating backend (per-key index allocates)");
+        }
+        if (backpressure_policy_ == BackpressurePolicy::SpillToDisk)
+        {
+            throw std::invalid_argument("zero_heap does not support policy=spill");
+        }
+    }
+    if (loop_model_ != LoopModel::Threads && backpressure_policy_ == BackpressurePolicy::BlockWithTimeout)
+    {
+        // The producer's push would block the thread the consumer runs on
+        throw std::invalid_argument(std::string("loop_model=") + to_string(loop_model_) +
+                                    " does not support policy=block");
+    }
+
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true))
     {
@@ -63,12 +210,141 @@ void GatewayCore::start()
     prev_state_ = device_.state();
     device_.start();
 
-    // Apply queue capacity if requested
+    // Strands sit on the pool: drop them (after their queued batches) before
+    // the pool may be rebuilt, then build them on the pool that will run
+    strands_.reset();
+    if (loop_model_ == LoopModel::Single)
+    {
+        // Batches are processed on the loop thread, in order: no pool, no strands
+        thread_pool_.reset();
+    }
+    else
+    {
+        place_thread_pool();
+    }
+    if (ordered_processing_ && thread_pool_)
+    {
+        run_pinned(numa_local_ ? pool_cpus_ : std::vector<int>{}, [this] {
+            strands_ = std::make_unique<StrandPool>(*thread_pool_, kDeviceStrands, kBatchPoolSize);
+        });
+    }
+
+    offload_.reset(loop_model_ == LoopModel::Single ? OffloadMode::Inline : offload_mode_, offload_threshold_);
+
+    // Apply queue backend/capacity/policy before the worker threads touch the
+    // queue. With numa_local this runs pinned to the consumer's CPUs, so the
+    // rings are first touched on its node.
+    run_pinned(numa_local_ ? consumer_cpus_ : std::vector<int>{}, [this] { configure_queue(); });
+    if (zero_heap_)
+    {
+        cloud_batch_.reserve(producer_batch_size_);
+        // Jobs in flight never exceed the batch arena in zero-heap mode
+        if (thread_pool_)
+        {
+            thread_pool_->reserve(kBatchPoolSize);
+        }
+        const auto budget = memory_budget();
+        TELEMETRYHUB_LOGIF("GatewayCore",
+            "zero-heap mode: preallocated %zu bytes (queue %zu, control %zu, batch pool %zu, producer %zu, jobs %zu)",
+            budget.total(), budget.queue_bytes, budget.control_bytes, budget.batch_pool_bytes,
+            budget.producer_bytes, budget.job_ring_bytes);
+    }
+    if (loop_model_ != LoopModel::Threads)
+    {
+        // Both loops on one thread; pushes resume the consumer through queue_signal_
+        queue_.set_async_signal(&queue_signal_);
+        loops_ = std::make_unique<CoroExecutor>(1);
+        loops_->spawn(producer_task());
+        loops_->spawn(consumer_task());
+    }
+    else
+    {
+        queue_.set_async_signal(nullptr);
+        producer_thread_ = std::thread(&GatewayCore::producer_loop, this);
+        consumer_thread_ = std::thread(&GatewayCore::consumer_loop, this);
+    }
+}
+
+void GatewayCore::configure_queue()
+{
+    queue_.set_backend(queue_backend_);
+    queue_.set_backpressure_policy(backpressure_policy_);
+    queue_.set_block_timeout(block_timeout_);
+    queue_.set_decimate_factor(decimate_factor_);
+    queue_.set_spill_directory(spill_dir_);
+    queue_.set_spill_segment_bytes(spill_segment_bytes_);
+    queue_.set_sojourn_target(sojourn_target_);
+    queue_.set_sojourn_interval(sojourn_interval_);
+    queue_.set_wait_strategy(queue_wait_strategy_);
     if (queue_capacity_ > 0) {
         queue_.set_capacity(queue_capacity_);
     }
-    producer_thread_ = std::thread(&GatewayCore::producer_loop, this);
-    consumer_thread_ = std::thread(&GatewayCore::consumer_loop, this);
+    if (zero_heap_) {
+        queue_.preallocate();
+    }
+}
+
+// Rebuilds the (idle) pool when its CPU set or worker bounds changed, or
+// builds it after single-thread mode released it; the old pool drains
+// whatever is still queued before it goes away.
+void GatewayCore::place_thread_pool()
+{
+    const auto bounds = pool_elastic_.resolved();
+    if (thread_pool_ && thread_pool_->cpus() == pool_cpus_ &&
+        thread_pool_->elastic().min_threads == bounds.min_threads &&
+        thread_pool_->elastic().max_threads == bounds.max_threads)
+    {
+        return;
+    }
+    const WaitStrategy wait = pool_wait_strategy_;
+    thread_pool_.reset();
+    // With numa_local the job arena is allocated on the pool's node too
+    // (workers always allocate their own deques after pinning)
+    run_pinned(numa_local_ ? pool_cpus_ : std::vector<int>{}, [&] {
+        thread_pool_ = std::make_unique<ThreadPool>(pool_elastic_, wait, pool_cpus_);
+    });
+    TELEMETRYHUB_LOGIF("GatewayCore", "[pool] %zu..%zu workers", bounds.min_threads, bounds.max_threads);
+    const size_t workers = thread_pool_->thread_count();
+    const auto pinned = thread_pool_->get_metrics().workers_pinned;
+    if (!pool_cpus_.empty() && pinned < workers)
+    {
+        pin_failures_.fetch_add(workers - pinned, std::memory_order_relaxed);
+        TELEMETRYHUB_LOGF(::telemetryhub::LogLevel::Warn, "GatewayCore",
+            "[pool] only %zu of %zu workers pinned to cpus %s", pinned, workers,
+            format_cpu_list(pool_cpus_).c_str());
+    }
+    else if (!pool_cpus_.empty())
+    {
+        TELEMETRYHUB_LOGIF("GatewayCore", "[pool] %zu workers pinned to cpus %s (node %d)",
+            workers, format_cpu_list(pool_cpus_).c_str(), numa_node_of_cpu(pool_cpus_.front()));
+    }
+}
+
+// Called first thing on a role's own thread: names it and applies its CPU set.
+bool GatewayCore::pin_role(const char* role, const std::vector<int>& cpus)
+{
+    const std::string name = std::string("thub-") + role;
+    set_current_thread_name(name.c_str());
+    if (cpus.empty())
+    {
+        return false;
+    }
+    if (!pin_current_thread(cpus))
+    {
+        pin_failures_.fetch_add(1, std::memory_order_relaxed);
+        TELEMETRYHUB_LOGF(::telemetryhub::LogLevel::Warn, "GatewayCore",
+            "[%s] could not pin to cpus %s", role, format_cpu_list(cpus).c_str());
+        return false;
+    }
+    if (numa_local_ && !cpus_share_numa_node(cpus))
+    {
+        TELEMETRYHUB_LOGF(::telemetryhub::LogLevel::Warn, "GatewayCore",
+            "[%s] cpus %s span NUMA nodes (or the node is unknown); placement is not local",
+            role, format_cpu_list(cpus).c_str());
+    }
+    TELEMETRYHUB_LOGIF("GatewayCore", "[%s] pinned to cpus %s (node %d)", role,
+        format_cpu_list(cpus).c_str(), numa_node_of_cpu(cpus.front()));
+    return true;
 }
 
 void GatewayCore::stop()
@@ -98,6 +374,8 @@ void GatewayCore::stop()
     {
         consumer_thread_.join();
     }
+    // Waits for both coroutines to return (running_ is false, queue shut down)
+    loops_.reset();
 
     // std::cout << "[GatewayCore] stopped.\n";
     TELEMETRYHUB_LOGI("GatewayCore","stopped.");
@@ -133,146 +411,345 @@ void GatewayCore::producer_loop()
 {
     // std::cout << "[GatewayCore::producer] thread started\n";
     TELEMETRYHUB_LOGI("GatewayCore","[producer] thread started");
+    producer_pinned_ = pin_role("producer", producer_cpus_);
 
-    while (running_)
+    SampleBatch pending;
+    pending.reserve(producer_batch_size_);
+    // Startup allocations are done; from here on the loop must not allocate
+    HeapGuard::ThreadScope heap_guard(zero_heap_);
+    while (running_ && produce_once(pending))
     {
-        auto state = device_.state();
-        // Push status on transitions
-        if (cloud_client_ && state != prev_state_)
-        {
-            try { cloud_client_->push_status(state); }
-            catch (const std::exception& e) {
-                TELEMETRYHUB_LOGI("GatewayCore", (std::string("cloud push_status failed: ") + e.what()).c_str());
-            }
-            prev_state_ = state;
-        }
+        // Pace sampling irrespective of whether we produced a sample
+        std::this_thread::sleep_for(sample_interval_);
+    }
+    flush_producer_batch(pending);
 
-        if (state != device::DeviceState::Measuring)
-        {
-            if (state == device::DeviceState::SafeState ||
-                state == device::DeviceState::Error)
-            {
-                // std::cout << "[producer] device state="
-                //           << device::to_string(state)
-                //           << ", exiting producer loop\n";
-                TELEMETRYHUB_LOGI("GatewayCore", (std::string("[producer] device state=") + device::to_string(state) + ", exiting producer loop").c_str());
-                break;
-            }
+    // std::cout << "[GatewayCore::producer] exiting\n";
+    TELEMETRYHUB_LOGI("GatewayCore","[producer] exiting");
+    producer_pinned_ = false;
+}
+
+CoTask GatewayCore::producer_task()
+{
+    TELEMETRYHUB_LOGI("GatewayCore","[producer] coroutine started");
+    // First to run on the loop thread, so it names and pins it for both loops
+    producer_pinned_ = pin_role("loops", producer_cpus_);
+
+    SampleBatch pending;
+    pending.reserve(producer_batch_size_);
+    // Guard depth is per thread, so the consumer coroutine's guard and this
+    // one nest correctly while they interleave on the loop thread
+    HeapGuard::ThreadScope heap_guard(zero_heap_);
+    while (running_ && produce_once(pending))
+    {
+        co_await sleep_for(sample_interval_);
+    }
+    flush_producer_batch(pending);
 
-            // Idle or transitioning – wait a bit
-            std::this_thread::sleep_for(sample_interval_);
-            continue;
+    TELEMETRYHUB_LOGI("GatewayCore","[producer] exiting");
+    producer_pinned_ = false;
+}
+
+bool GatewayCore::produce_once(SampleBatch& pending)
+{
+    auto state = device_.state();
+    // Queue status on transitions; the control lane overtakes queued
+    // samples and the consumer forwards it to the cloud
+    if (cloud_client_ && state != prev_state_)
+    {
+        device::TelemetrySample status;
+        status.kind = device::SampleKind::Status;
+        status.timestamp_ns = device::wall_ns();
+        status.value = static_cast<double>(state);
+        queue_.push(std::move(status));
+        prev_state_ = state;
+    }
+
+    if (state != device::DeviceState::Measuring)
+    {
+        flush_producer_batch(pending);
+        if (state == device::DeviceState::SafeState ||
+            state == device::DeviceState::Error)
+        {
+            // std::cout << "[producer] device state="
+            //           << device::to_string(state)
+            //           << ", exiting producer loop\n";
+            TELEMETRYHUB_LOGIF("GatewayCore", "[producer] device state=%s, exiting producer loop",
+                               device::to_string(state));
+            return false;
         }
 
-        // Attempt to read sample from device
-        auto sample_opt = device_.read_sample();
+        // Idle or transitioning – wait a bit
+        return true;
+    }
+
+    // Attempt to read sample from device
+    auto sample_opt = device_.read_sample();
+    
+    if (!sample_opt)
+    {
+        // Track consecutive failures (circuit breaker pattern)
+        consecutive_read_failures_++;
         
-        if (!sample_opt)
+        TELEMETRYHUB_LOGIF("GatewayCore", "[producer] read failed, consecutive failures: %d",
+                           consecutive_read_failures_);
+
+        // Force device to SafeState after threshold (policy enforcement)
+        if (consecutive_read_failures_ >= max_consecutive_failures_)
         {
-            // Track consecutive failures (circuit breaker pattern)
-            consecutive_read_failures_++;
+            TELEMETRYHUB_LOGIF("GatewayCore",
+                "[producer] Max consecutive failures (%d) reached, forcing device to SafeState",
+                max_consecutive_failures_);
             
-            TELEMETRYHUB_LOGI("GatewayCore",
-                (std::string("[producer] read failed, consecutive failures: ") +
-                 std::to_string(consecutive_read_failures_)).c_str());
+            // Stop device—policy-driven SafeState transition
+            device_.stop();
+            return false;
+        }
+        return true;
+    }
 
-            // Force device to SafeState after threshold (policy enforcement)
-            if (consecutive_read_failures_ >= max_consecutive_failures_)
-            {
-                TELEMETRYHUB_LOGI("GatewayCore",
-                    (std::string("[producer] Max consecutive failures (") +
-                     std::to_string(max_consecutive_failures_) +
-                     ") reached, forcing device to SafeState").c_str());
-                
-                // Stop device—policy-driven SafeState transition
-                device_.stop();
-                break;
-            }
+    // Successful read—reset failure counter
+    consecutive_read_failures_ = 0;
 
-            std::this_thread::sleep_for(sample_interval_);
-            continue;
-        }
+    pending.push_back(*sample_opt);
+    if (pending.size() >= producer_batch_size_)
+    {
+        flush_producer_batch(pending);
+    }
+    return true;
+}
 
-        // Successful read—reset failure counter
-        consecutive_read_failures_ = 0;
-        
-        if (sample_opt)
+void GatewayCore::flush_producer_batch(SampleBatch& pending)
+{
+    if (pending.empty())
+    {
+        return;
+    }
+    // Rejected samples (drop_newest/decimate/block timeout) are
+    // counted by the queue itself and reported as samples_dropped
+    metrics_samples_processed_ += queue_.push_bulk(pending);
+
+    cloud_batch_.clear();
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        if (++accepted_counter_ % cloud_sample_interval_ == 0 && cloud_client_)
         {
-            // Blocking push in current queue implementation; treat as accepted
-            queue_.push(*sample_opt);
-            metrics_samples_processed_++;
-            accepted_counter_++;
-            if (cloud_client_ && (accepted_counter_ % cloud_sample_interval_ == 0))
-            {
-                try { cloud_client_->push_sample(*sample_opt); }
-                catch (const std::exception& e) {
-                    TELEMETRYHUB_LOGI("GatewayCore", (std::string("cloud push_sample failed: ") + e.what()).c_str());
-                }
-            }
+            cloud_batch_.push_back(pending.sample(i));
         }
-        // Pace sampling irrespective of whether we produced a sample
-        std::this_thread::sleep_for(sample_interval_);
     }
-
-    // std::cout << "[GatewayCore::producer] exiting\n";
-    TELEMETRYHUB_LOGI("GatewayCore","[producer] exiting");
+    if (!cloud_batch_.empty())
+    {
+        HeapGuard::Exempt cloud_io; // client I/O is outside the zero-heap guarantee
+        try { cloud_client_->push_batch(cloud_batch_); }
+        catch (const std::exception& e) {
+            TELEMETRYHUB_LOGI("GatewayCore", (std::string("cloud push_batch failed: ") + e.what()).c_str());
+        }
+    }
+    pending.clear();
 }
 
 void GatewayCore::consumer_loop()
 {
     // std::cout << "[GatewayCore::consumer] thread started\n";
     TELEMETRYHUB_LOGI("GatewayCore","[consumer] thread started");
+    consumer_pinned_ = pin_role("consumer", consumer_cpus_);
 
+    // Batches come from batch_pool_ and go back to it when the pool job
+    // that processed them is destroyed, so steady state allocates nothing
+    auto batch = batch_pool_.acquire();
+    HeapGuard::ThreadScope heap_guard(zero_heap_);
     while (true)
     {
-        auto sample_opt = queue_.pop();
-        if (!sample_opt)
+        if (queue_.pop_batch(*batch, kConsumerBatchSize, kConsumerPollTimeout) == 0)
         {
+            if (!queue_.is_shutdown())
+            {
+                continue; // poll timeout, nothing queued yet
+            }
             // std::cout << "[consumer] queue shutdown, exiting consumer loop\n";
             TELEMETRYHUB_LOGI("GatewayCore","[consumer] queue shutdown, exiting consumer loop");
             break;
         }
+        consume_batch(batch);
+    }
+
+    // std::cout << "[GatewayCore::consumer] exiting\n";
+    TELEMETRYHUB_LOGI("GatewayCore","[consumer] exiting");
+    consumer_pinned_ = false;
+}
 
+CoTask GatewayCore::consumer_task()
+{
+    TELEMETRYHUB_LOGI("GatewayCore","[consumer] coroutine started");
+    auto batch = batch_pool_.acquire();
+    HeapGuard::ThreadScope heap_guard(zero_heap_);
+    while (true)
+    {
+        // Suspends (no timeout needed: shutdown() signals too) until the
+        // queue has something; other coroutines run on the thread meanwhile
+        if (co_await async_pop_batch(queue_, *batch, kConsumerBatchSize) == 0)
         {
-            std::lock_guard lock(latest_mutex_);
-            latest_ = *sample_opt;
+            if (!queue_.is_shutdown())
+            {
+                continue; // woken, but AQM dropped what was there
+            }
+            TELEMETRYHUB_LOGI("GatewayCore","[consumer] queue shutdown, exiting consumer loop");
+            break;
         }
+        consume_batch(batch);
+    }
+    TELEMETRYHUB_LOGI("GatewayCore","[consumer] exiting");
+}
 
-        // Submit processing to thread pool (Day 17)
-        if (thread_pool_) {
-            thread_pool_->submit(&GatewayCore::process_sample_with_metrics, this, *sample_opt);
+void GatewayCore::consume_batch(ObjectPool<SampleBatch>::Handle& batch)
+{
+    // Control-lane items come first in the batch: forward status events
+    // before touching any of the measurements behind them
+    size_t first_sample = 0;
+    while (first_sample < batch->size() && batch->kinds()[first_sample] == device::SampleKind::Status)
+    {
+        forward_status(static_cast<device::DeviceState>(static_cast<int>(batch->values()[first_sample])));
+        ++first_sample;
+    }
+    if (first_sample > 0)
+    {
+        batch->erase_front(first_sample);
+        if (batch->empty())
+        {
+            return;
         }
+    }
 
-        // std::cout << "[consumer] got sample #" << sample_opt->sequence_id
-        //           << " value=" << sample_opt->value
-        //           << " " << sample_opt->unit << "\n";
-        TELEMETRYHUB_LOGI("GatewayCore",
-            (std::string("[consumer] got sample #") + std::to_string(sample_opt->sequence_id) +
-             " value=" + std::to_string(sample_opt->value) + " " + sample_opt->unit).c_str());  
-                  
+    {
+        std::lock_guard lock(latest_mutex_);
+        latest_ = batch->back();
     }
 
-    // std::cout << "[GatewayCore::consumer] exiting\n";
-    TELEMETRYHUB_LOGI("GatewayCore","[consumer] exiting");
+    const auto last = batch->back();
+    TELEMETRYHUB_LOGIF("GatewayCore", "[consumer] got %zu sample(s) #%u..#%u last value=%f %s",
+                       batch->size(), batch->sequence_ids().front(), last.sequence_id,
+                       last.value, last.unit.str().c_str());
+
+    // Cheap batches are processed right here: a pool handoff would cost
+    // more than the work. Ordered: not while an earlier batch is queued on
+    // the pool, which this one would overtake. Single-thread mode has no pool.
+    if (!thread_pool_ ||
+        !offload_.offload(batch->size(), strands_ && offloaded_in_flight_.load(std::memory_order_acquire) > 0))
+    {
+        process_batch_with_metrics(*batch, true);
+        batch->clear();
+        return;
+    }
+
+    // Hand the whole burst to the thread pool as one job (Day 17)
+    auto next = acquire_job_batch();
+    if (!next) {
+        // Arena exhausted (workers behind): process here rather than allocate
+        process_batch_with_metrics(*batch, true);
+        batch->clear();
+        return;
+    }
+    if (strands_) {
+        // Ordered: a strand keeps one device's jobs in order, so a batch
+        // holding several devices goes out as one job per device
+        for (;;) {
+            const auto devices = batch->device_ids();
+            const uint32_t device_id = devices.front();
+            if (std::all_of(devices.begin(), devices.end(), [device_id](uint32_t d) { return d == device_id; })) {
+                break;
+            }
+            batch->extract_device(device_id, *next);
+            post_batch_job(device_id, std::move(next));
+            next = acquire_job_batch();
+        }
+    }
+    const uint32_t device_id = batch->device_ids().front();
+    post_batch_job(device_id, std::move(batch));
+    batch = std::move(next);
 }
 
-void GatewayCore::process_sample_with_metrics(const device::TelemetrySample& sample)
+void GatewayCore::post_batch_job(uint32_t device_id, ObjectPool<SampleBatch>::Handle batch)
+{
+    // `this` plus the batch handle fit Task's inline buffer, so posting
+    // does not allocate; the job hands the batch back to the pool as soon
+    // as it is done. Ordered: keyed by the batch's device, so that
+    // device's batches run in arrival order
+    offloaded_in_flight_.fetch_add(1, std::memory_order_relaxed);
+    auto job = [this, job = std::move(batch)]() mutable {
+        process_batch_with_metrics(*job, false);
+        job.reset();
+        offloaded_in_flight_.fetch_sub(1, std::memory_order_release);
+        batch_released_.notify_one();
+    };
+    if (strands_) {
+        strands_->post(device_id, std::move(job));
+    } else {
+        thread_pool_->post(std::move(job));
+    }
+}
+
+ObjectPool<SampleBatch>::Handle GatewayCore::acquire_job_batch()
+{
+    auto next = zero_heap_ ? batch_pool_.try_acquire() : batch_pool_.acquire();
+    if (next || !strands_) {
+        return next;
+    }
+    // Ordered: processing here would overtake the device's queued batches,
+    // so wait for one of them to finish instead
+    auto ready = [this, &next] {
+        next = batch_pool_.try_acquire();
+        return next != nullptr;
+    };
+    while (!spin_until(pool_wait_strategy_, ready, nullptr)) {
+        const uint32_t epoch = batch_released_.prepare_wait();
+        if (ready()) {
+            batch_released_.cancel_wait();
+            break;
+        }
+        batch_released_.wait(epoch, nullptr);
+    }
+    return next;
+}
+
+void GatewayCore::forward_status(device::DeviceState state)
+{
+    if (!cloud_client_)
+    {
+        return;
+    }
+    HeapGuard::Exempt cloud_io;
+    try { cloud_client_->push_status(state); }
+    catch (const std::exception& e) {
+        TELEMETRYHUB_LOGI("GatewayCore", (std::string("cloud push_status failed: ") + e.what()).c_str());
+    }
+}
+
+void GatewayCore::process_batch_with_metrics(SampleBatch& batch, bool inline_run)
 {
     // Example derived metric: compute moving average, variance, etc.
     // This demonstrates CPU-bound work that benefits from parallel processing
-    
-    // Simulate some processing work
+
     // In production, this would be:
     // - Statistical calculations (moving average, stddev, percentiles)
     // - Data transformation (unit conversions, normalization)
     // - Anomaly detection (outlier detection, trend analysis)
     // - Aggregation (windowed metrics, rollups)
-    
-    double derived_value = sample.value * 1.5;  // Example: apply calibration factor
-    
-    TELEMETRYHUB_LOGI("GatewayCore",
-        (std::string("[thread_pool] processed sample #") + std::to_string(sample.sequence_id) +
-         " derived_value=" + std::to_string(derived_value)).c_str());
+    //
+    // Each step runs over the whole value column at once (vectorizable),
+    // and logging is per batch rather than per sample.
+    //
+    // The run time feeds offload_'s cost model, wherever the batch ran.
+    HeapGuard::ThreadScope heap_guard(zero_heap_);
+    const auto started = std::chrono::steady_clock::now();
+    batch.scale_values(1.5);  // Example: apply calibration factor
+    const auto stats = batch.value_stats();
+
+    TELEMETRYHUB_LOGIF("GatewayCore",
+        "[%s] processed %zu sample(s) #%u..#%u derived mean=%f min=%f max=%f",
+        inline_run ? "consumer" : "thread_pool",
+        stats.count, batch.sequence_ids().front(), batch.sequence_ids().back(),
+        stats.mean(), stats.min, stats.max);
+    offload_.record(batch.size(), std::chrono::steady_clock::now() - started, inline_run);
 }
 
 }   // namespace telemetryhub::gateway 
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "telemetryhub/gateway/HeapGuard.h"
+#include <atomic>
+
+namespace telemetryhub::gateway {
+
+namespace {
+std::atomic<bool> g_hook_installed{false};
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_violations{0};
+std::atomic<uint64_t> g_exempt{0};
+
+// Plain ints: constant-initialized TLS, so reading them never allocates
+thread_local int t_guard_depth = 0;
+thread_local int t_exempt_depth = 0;
+}
+
+void HeapGuard::on_allocation(std::size_t bytes) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (t_guard_depth > 0) {
+        (t_exempt_depth > 0 ? g_exempt : g_violations).fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void HeapGuard::mark_hook_installed() noexcept
+{
+    g_hook_installed.store(true, std::memory_order_relaxed);
+}
+
+HeapGuard::Metrics HeapGuard::get_metrics() noexcept
+{
+    Metrics m;
+    m.hook_installed = g_hook_installed.load(std::memory_order_relaxed);
+    m.allocations = g_allocations.load(std::memory_order_relaxed);
+    m.bytes = g_bytes.load(std::memory_order_relaxed);
+    m.violations = g_violations.load(std::memory_order_relaxed);
+    m.exempt = g_exempt.load(std::memory_order_relaxed);
+    return m;
+}
+
+bool HeapGuard::thread_guarded() noexcept
+{
+    return t_guard_depth > 0 && t_exempt_depth == 0;
+}
+
+HeapGuard::ThreadScope::ThreadScope(bool enable) noexcept : enabled_(enable)
+{
+    if (enabled_) {
+        ++t_guard_depth;
+    }
+}
+
+HeapGuard::ThreadScope::~ThreadScope()
+{
+    if (enabled_) {
+        --t_guard_depth;
+    }
+}
+
+HeapGuard::Exempt::Exempt() noexcept
+{
+    ++t_exempt_depth;
+}
+
+HeapGuard::Exempt::~Exempt()
+{
+    --t_exempt_depth;
+}
+
+} // namespace telemetryhub::gateway
@@ -0,0 +1,74 @@
+// Counting replacement for the global operator new/delete (see HeapGuard.h).
+// Built as the heap_guard_hook object library and linked into executables
+// only: a replacement allocator inside gateway_core would be picked up, or
+// not, depending on link order.
+#include "telemetryhub/gateway/HeapGuard.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+using telemetryhub::gateway::HeapGuard;
+
+namespace {
+const bool kHookInstalled = (HeapGuard::mark_hook_installed(), true);
+
+void* allocate(std::size_t size)
+{
+    HeapGuard::on_allocation(size);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t align)
+{
+    HeapGuard::on_allocation(size);
+    const auto a = static_cast<std::size_t>(align);
+    const std::size_t n = size ? size : 1; // new T[0] still needs a unique pointer
+#if defined(_MSC_VER)
+    void* p = _aligned_malloc(n, a);
+#else
+    void* p = std::aligned_alloc(a, (n + a - 1) / a * a); // size must be a multiple
+#endif
+    if (p) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void release_aligned(void* p) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return allocate_aligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocate_aligned(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release_aligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release_aligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release_aligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release_aligned(p); }
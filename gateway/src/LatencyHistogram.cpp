@@ -0,0 +1,111 @@
+#include "telemetryhub/gateway/LatencyHistogram.h"
+
+#include <bit>
+#include <cmath>
+
+namespace telemetryhub::gateway {
+
+size_t LatencyHistogram::bucket_index(uint64_t v)
+{
+    if (v < kSubBuckets) {
+        return static_cast<size_t>(v);
+    }
+    const unsigned msb = static_cast<unsigned>(std::bit_width(v)) - 1;
+    const unsigned shift = msb - kSubBits;
+    return (msb - kSubBits + 1) * kSubBuckets + ((v >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t idx)
+{
+    if (idx < kSubBuckets) {
+        return idx;
+    }
+    const size_t group = idx / kSubBuckets; // >= 1
+    const uint64_t sub = idx % kSubBuckets;
+    const unsigned shift = static_cast<unsigned>(group - 1);
+    const uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value_ns)
+{
+    buckets_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value_ns, std::memory_order_relaxed);
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (value_ns > prev &&
+           !max_.compare_exchange_weak(prev, value_ns, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double p) const
+{
+    uint64_t total = 0;
+    for (const auto& b : buckets_) {
+        total += b.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    p = p < 0.0 ? 0.0 : (p > 100.0 ? 100.0 : p);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total)));
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Never report more than the largest value actually recorded
+            const uint64_t upper = bucket_upper(i);
+            const uint64_t mx = max();
+            return upper < mx ? upper : mx;
+        }
+    }
+    return max();
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+    Summary s;
+    s.count = count();
+    if (s.count == 0) {
+        return s;
+    }
+    s.mean_ns = static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(s.count);
+    s.p50_ns = percentile(50.0);
+    s.p90_ns = percentile(90.0);
+    s.p99_ns = percentile(99.0);
+    s.p999_ns = percentile(99.9);
+    s.max_ns = max();
+    return s;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < kBuckets; ++i) {
+        const uint64_t n = other.buckets_[i].load(std::memory_order_relaxed);
+        if (n != 0) {
+            buckets_[i].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+    count_.fetch_add(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    const uint64_t mx = other.max();
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (mx > prev && !max_.compare_exchange_weak(prev, mx, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& b : buckets_) {
+        b.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace telemetryhub::gateway
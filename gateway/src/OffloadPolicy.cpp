@@ -0,0 +1,93 @@
+#include "telemetryhub/gateway/OffloadPolicy.h"
+
+#include <algorithm>
+
+namespace telemetryhub::gateway {
+
+namespace {
+// Weight of a new measurement in the per-item estimate (1/8: a change in
+// cost is followed within a few dozen jobs, one outlier moves it little)
+constexpr double kCostWeight = 0.125;
+}
+
+const char* to_string(OffloadMode mode)
+{
+    switch (mode) {
+        case OffloadMode::Auto:   return "auto";
+        case OffloadMode::Pool:   return "pool";
+        case OffloadMode::Inline: return "inline";
+    }
+    return "unknown";
+}
+
+bool parse_offload_mode(const std::string& s, OffloadMode& out)
+{
+    if (s == "auto")   { out = OffloadMode::Auto;   return true; }
+    if (s == "pool")   { out = OffloadMode::Pool;   return true; }
+    if (s == "inline") { out = OffloadMode::Inline; return true; }
+    return false;
+}
+
+OffloadPolicy::OffloadPolicy(OffloadMode mode, std::chrono::nanoseconds threshold)
+    : mode_(mode), threshold_ns_(threshold.count())
+{
+}
+
+void OffloadPolicy::reset(OffloadMode mode, std::chrono::nanoseconds threshold)
+{
+    mode_.store(mode, std::memory_order_relaxed);
+    threshold_ns_.store(threshold.count(), std::memory_order_relaxed);
+    cost_ns_per_item_.store(0.0, std::memory_order_relaxed);
+    inline_jobs_.store(0, std::memory_order_relaxed);
+    offloaded_jobs_.store(0, std::memory_order_relaxed);
+    inline_ns_.store(0, std::memory_order_relaxed);
+}
+
+bool OffloadPolicy::offload(size_t items, bool pending) const
+{
+    if (pending) {
+        return true;
+    }
+    switch (mode_.load(std::memory_order_relaxed)) {
+        case OffloadMode::Pool:   return true;
+        case OffloadMode::Inline: return false;
+        case OffloadMode::Auto:   break;
+    }
+    const double cost = cost_ns_per_item_.load(std::memory_order_relaxed);
+    if (cost <= 0.0) {
+        return true; // not measured yet
+    }
+    return cost * static_cast<double>(items) > static_cast<double>(threshold_ns_.load(std::memory_order_relaxed));
+}
+
+void OffloadPolicy::record(size_t items, std::chrono::nanoseconds took, bool ran_inline)
+{
+    const auto ns = static_cast<uint64_t>(std::max<int64_t>(0, took.count()));
+    if (ran_inline) {
+        inline_jobs_.fetch_add(1, std::memory_order_relaxed);
+        inline_ns_.fetch_add(ns, std::memory_order_relaxed);
+    } else {
+        offloaded_jobs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (items == 0) {
+        return;
+    }
+    const double sample = static_cast<double>(ns) / static_cast<double>(items);
+    const double cost = cost_ns_per_item_.load(std::memory_order_relaxed);
+    cost_ns_per_item_.store(cost <= 0.0 ? sample : cost + kCostWeight * (sample - cost),
+                            std::memory_order_relaxed);
+}
+
+OffloadPolicy::Metrics OffloadPolicy::get_metrics() const
+{
+    Metrics m;
+    m.mode = mode();
+    m.threshold_us = static_cast<double>(threshold_ns_.load(std::memory_order_relaxed)) / 1e3;
+    m.cost_ns_per_item = cost_ns_per_item_.load(std::memory_order_relaxed);
+    m.inline_jobs = inline_jobs_.load(std::memory_order_relaxed);
+    m.offloaded_jobs = offloaded_jobs_.load(std::memory_order_relaxed);
+    m.inline_ms = static_cast<double>(inline_ns_.load(std::memory_order_relaxed)) / 1e6;
+    return m;
+}
+
+} // namespace telemetryhub::gateway
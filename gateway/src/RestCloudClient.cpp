@@ -13,7 +13,28 @@ void RestCloudClient::push_sample(const TelemetrySample &sample)
     std::string msg = std::string{"{\"type\":\"sample\",\"seq\":"} +
         std::to_string(sample.sequence_id) +
         ",\"value\":" + std::to_string(sample.value) +
-        ",\"unit\":\"" + sample.unit + "\"}";
+        ",\"unit\":\"" + sample.unit.str() + "\"}";
+    TELEMETRYHUB_LOGI("cloud", msg);
+}
+
+// Columnar message: one request for the whole batch
+void RestCloudClient::push_batch(const SampleBatch& batch)
+{
+    if (batch.size() == 1) {
+        push_sample(batch.front());
+        return;
+    }
+    std::string seq;
+    std::string value;
+    std::string unit;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const char* sep = i == 0 ? "" : ",";
+        seq += sep + std::to_string(batch.sequence_ids()[i]);
+        value += sep + std::to_string(batch.values()[i]);
+        unit += sep + std::string("\"") + device::Unit::from_id(batch.unit_ids()[i]).str() + "\"";
+    }
+    std::string msg = std::string{"{\"type\":\"batch\",\"count\":"} + std::to_string(batch.size()) +
+        ",\"seq\":[" + seq + "],\"value\":[" + value + "],\"unit\":[" + unit + "]}";
     TELEMETRYHUB_LOGI("cloud", msg);
 }
 
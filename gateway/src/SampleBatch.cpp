@@ -0,0 +1,175 @@
+#include "telemetryhub/gateway/SampleBatch.h"
+
+#include <algorithm>
+
+namespace telemetryhub::gateway {
+
+SampleBatch::SampleBatch(std::span<const device::TelemetrySample> samples)
+{
+    reserve(samples.size());
+    for (const auto& s : samples) {
+        push_back(s);
+    }
+}
+
+void SampleBatch::reserve(size_t n)
+{
+    timestamps_ns_.reserve(n);
+    values_.reserve(n);
+    sequence_ids_.reserve(n);
+    unit_ids_.reserve(n);
+    device_ids_.reserve(n);
+    channels_.reserve(n);
+    kinds_.reserve(n);
+}
+
+void SampleBatch::clear()
+{
+    timestamps_ns_.clear();
+    values_.clear();
+    sequence_ids_.clear();
+    unit_ids_.clear();
+    device_ids_.clear();
+    channels_.clear();
+    kinds_.clear();
+}
+
+void SampleBatch::push_back(const device::TelemetrySample& s)
+{
+    timestamps_ns_.push_back(s.timestamp_ns);
+    values_.push_back(s.value);
+    sequence_ids_.push_back(s.sequence_id);
+    unit_ids_.push_back(s.unit.id());
+    device_ids_.push_back(s.device_id);
+    channels_.push_back(s.channel);
+    kinds_.push_back(s.kind);
+}
+
+device::TelemetrySample SampleBatch::sample(size_t i) const
+{
+    device::TelemetrySample s;
+    s.timestamp_ns = timestamps_ns_[i];
+    s.value = values_[i];
+    s.sequence_id = sequence_ids_[i];
+    s.unit = device::Unit::from_id(unit_ids_[i]);
+    s.device_id = device_ids_[i];
+    s.channel = channels_[i];
+    s.kind = kinds_[i];
+    return s;
+}
+
+void SampleBatch::erase_front(size_t n)
+{
+    n = std::min(n, size());
+    const auto drop = [n](auto& column) {
+        column.erase(column.begin(), column.begin() + static_cast<std::ptrdiff_t>(n));
+    };
+    drop(timestamps_ns_);
+    drop(values_);
+    drop(sequence_ids_);
+    drop(unit_ids_);
+    drop(device_ids_);
+    drop(channels_);
+    drop(kinds_);
+}
+
+size_t SampleBatch::extract_device(uint32_t device_id, SampleBatch& out)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < size(); ++i) {
+        if (device_ids_[i] == device_id) {
+            out.push_back(sample(i));
+            continue;
+        }
+        if (kept != i) {
+            const auto shift = [i, kept](auto& column) { column[kept] = column[i]; };
+            shift(timestamps_ns_);
+            shift(values_);
+            shift(sequence_ids_);
+            shift(unit_ids_);
+            shift(device_ids_);
+            shift(channels_);
+            shift(kinds_);
+        }
+        ++kept;
+    }
+    const size_t moved = size() - kept;
+    const auto truncate = [kept](auto& column) { column.resize(kept); };
+    truncate(timestamps_ns_);
+    truncate(values_);
+    truncate(sequence_ids_);
+    truncate(unit_ids_);
+    truncate(device_ids_);
+    truncate(channels_);
+    truncate(kinds_);
+    return moved;
+}
+
+void SampleBatch::append_to(std::vector<device::TelemetrySample>& out) const
+{
+    out.reserve(out.size() + size());
+    for (size_t i = 0; i < size(); ++i) {
+        out.push_back(sample(i));
+    }
+}
+
+SampleBatch::ValueStats SampleBatch::value_stats() const
+{
+    return value_stats(values_);
+}
+
+SampleBatch::ValueStats SampleBatch::value_stats(std::span<const double> values)
+{
+    ValueStats st;
+    const size_t n = values.size();
+    if (n == 0) {
+        return st;
+    }
+    const double* v = values.data();
+    // Four independent lanes: no loop-carried dependency on a single
+    // accumulator, so the compiler can keep them in SIMD registers (strict
+    // FP semantics forbid it from reassociating a plain running sum itself).
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    double lo[4] = {v[0], v[0], v[0], v[0]};
+    double hi[4] = {v[0], v[0], v[0], v[0]};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (size_t k = 0; k < 4; ++k) {
+            sum[k] += v[i + k];
+            lo[k] = v[i + k] < lo[k] ? v[i + k] : lo[k];
+            hi[k] = v[i + k] > hi[k] ? v[i + k] : hi[k];
+        }
+    }
+    for (; i < n; ++i) {
+        sum[0] += v[i];
+        lo[0] = std::min(lo[0], v[i]);
+        hi[0] = std::max(hi[0], v[i]);
+    }
+    st.count = n;
+    st.sum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    st.min = std::min(std::min(lo[0], lo[1]), std::min(lo[2], lo[3]));
+    st.max = std::max(std::max(hi[0], hi[1]), std::max(hi[2], hi[3]));
+    return st;
+}
+
+void SampleBatch::ValueStats::merge(const ValueStats& other)
+{
+    if (other.count == 0) {
+        return;
+    }
+    min = count ? std::min(min, other.min) : other.min;
+    max = count ? std::max(max, other.max) : other.max;
+    count += other.count;
+    sum += other.sum;
+}
+
+void SampleBatch::scale_values(double factor, double offset)
+{
+    double* v = values_.data();
+    const size_t n = values_.size();
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = v[i] * factor + offset;
+    }
+}
+
+} // namespace telemetryhub::gateway
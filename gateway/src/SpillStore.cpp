@@ -0,0 +1,183 @@
+#include "telemetryhub/gateway/SpillStore.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace telemetryhub::gateway {
+
+namespace {
+// Record layout: i64 enqueued_ns followed by the sample's bytes. Samples are
+// trivially copyable and the files never leave this process (unit ids are
+// only meaningful to its UnitRegistry), so a memcpy is the whole encoding.
+constexpr size_t kRecordBytes = sizeof(int64_t) + sizeof(device::TelemetrySample);
+
+uint64_t process_id()
+{
+#ifdef _WIN32
+    return static_cast<uint64_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint64_t>(getpid());
+#endif
+}
+
+std::atomic<uint64_t> g_store_counter{0};
+}
+
+struct SpillStore::Segment
+{
+    std::filesystem::path path;
+    size_t capacity = 0;
+    size_t write_off = 0;
+    size_t read_off = 0;
+    uint8_t* data = nullptr;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    ~Segment()
+    {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(data, capacity);
+        if (fd >= 0) close(fd);
+#endif
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+SpillStore::SpillStore(std::filesystem::path dir, size_t segment_bytes)
+    : dir_(std::move(dir)),
+      prefix_("spill-" + std::to_string(process_id()) + "-" + std::to_string(g_store_counter.fetch_add(1)) + "-"),
+      segment_bytes_(segment_bytes < 4096 ? 4096 : segment_bytes)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    if (ec) {
+        throw std::runtime_error("SpillStore: cannot create " + dir_.string() + ": " + ec.message());
+    }
+}
+
+SpillStore::~SpillStore() = default;
+
+std::unique_ptr<SpillStore::Segment> SpillStore::open_segment()
+{
+    auto seg = std::make_unique<Segment>();
+    seg->path = dir_ / (prefix_ + std::to_string(next_segment_id_++) + ".seg");
+    seg->capacity = segment_bytes_;
+#ifdef _WIN32
+    seg->file = CreateFileW(seg->path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                            CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr);
+    if (seg->file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("SpillStore: cannot create " + seg->path.string());
+    }
+    const auto size = static_cast<uint64_t>(seg->capacity);
+    seg->mapping = CreateFileMappingW(seg->file, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+    if (!seg->mapping) {
+        throw std::runtime_error("SpillStore: cannot map " + seg->path.string());
+    }
+    seg->data = static_cast<uint8_t*>(MapViewOfFile(seg->mapping, FILE_MAP_ALL_ACCESS, 0, 0, seg->capacity));
+    if (!seg->data) {
+        throw std::runtime_error("SpillStore: cannot map " + seg->path.string());
+    }
+#else
+    seg->fd = ::open(seg->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (seg->fd < 0) {
+        throw std::runtime_error("SpillStore: cannot create " + seg->path.string());
+    }
+    // Reserve the blocks now: writing through the mapping into a sparse
+    // file raises SIGBUS once the disk is full, while a failed reservation
+    // is an exception the queue turns into a dropped sample
+#if defined(__linux__)
+    const int err = posix_fallocate(seg->fd, 0, static_cast<off_t>(seg->capacity));
+#else
+    const int err = ftruncate(seg->fd, static_cast<off_t>(seg->capacity)) != 0 ? errno : 0;
+#endif
+    if (err != 0) {
+        throw std::runtime_error("SpillStore: cannot size " + seg->path.string() + ": " +
+                                 std::strerror(err));
+    }
+    void* p = mmap(nullptr, seg->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, seg->fd, 0);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("SpillStore: cannot map " + seg->path.string());
+    }
+    seg->data = static_cast<uint8_t*>(p);
+#endif
+    return seg;
+}
+
+void SpillStore::append(const device::TelemetrySample& sample, int64_t enqueued_ns)
+{
+    if (segments_.empty() || segments_.back()->write_off + kRecordBytes > segments_.back()->capacity) {
+        segments_.push_back(open_segment());
+    }
+    Segment& seg = *segments_.back();
+
+    uint8_t* p = seg.data + seg.write_off;
+    std::memcpy(p, &enqueued_ns, sizeof(enqueued_ns));
+    std::memcpy(p + sizeof(enqueued_ns), &sample, sizeof(sample));
+
+    seg.write_off += kRecordBytes;
+    bytes_written_ += kRecordBytes;
+    ++records_;
+}
+
+bool SpillStore::pop(device::TelemetrySample& out, int64_t& enqueued_ns)
+{
+    if (records_ == 0) {
+        return false;
+    }
+    // Retire fully read segments the writer has moved past
+    while (segments_.front()->read_off == segments_.front()->write_off) {
+        segments_.pop_front();
+    }
+    Segment& seg = *segments_.front();
+
+    const uint8_t* p = seg.data + seg.read_off;
+    std::memcpy(&enqueued_ns, p, sizeof(enqueued_ns));
+    std::memcpy(&out, p + sizeof(enqueued_ns), sizeof(out));
+
+    seg.read_off += kRecordBytes;
+    bytes_read_ += kRecordBytes;
+    --records_;
+
+    if (seg.read_off == seg.write_off) {
+        if (segments_.size() > 1) {
+            segments_.pop_front(); // deletes the file
+        } else {
+            seg.read_off = seg.write_off = 0; // drained: reuse the tail segment
+        }
+    }
+    return true;
+}
+
+uint64_t SpillStore::disk_bytes() const
+{
+    return static_cast<uint64_t>(segments_.size()) * segment_bytes_;
+}
+
+} // namespace telemetryhub::gateway
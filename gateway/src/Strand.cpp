@@ -0,0 +1,147 @@
+#include "telemetryhub/gateway/Strand.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace telemetryhub::gateway {
+
+namespace {
+// splitmix64 finalizer: device ids are small and dense, so spread them
+uint64_t mix(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+}
+
+StrandPool::StrandPool(ThreadPool& pool, size_t strands, size_t nodes, size_t budget)
+    : pool_(pool),
+      budget_(std::max<size_t>(1, budget)),
+      mask_(round_up_pow2(std::max<size_t>(1, strands)) - 1),
+      strands_(std::make_unique<Strand[]>(mask_ + 1)),
+      nodes_(nodes)
+{
+    for (size_t i = 0; i <= mask_; ++i) {
+        Strand& s = strands_[i];
+        s.head = &s.stub;
+        s.tail.store(&s.stub, std::memory_order_relaxed);
+    }
+}
+
+StrandPool::~StrandPool()
+{
+    // A drain's last access to its strand is the decrement that empties it
+    for (size_t i = 0; i <= mask_; ++i) {
+        while (strands_[i].queued.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t StrandPool::strand_of(uint64_t key) const
+{
+    return static_cast<size_t>(mix(key)) & mask_;
+}
+
+size_t StrandPool::storage_bytes(size_t strands, size_t nodes)
+{
+    return round_up_pow2(std::max<size_t>(1, strands)) * sizeof(Strand) + nodes * sizeof(Node);
+}
+
+void StrandPool::push(Strand& s, NodeBase* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    NodeBase* prev = s.tail.exchange(node, std::memory_order_acq_rel);
+    // Between the exchange and this store the node is queued but not yet
+    // reachable from head; pop() reports "empty" for that instant
+    prev->next.store(node, std::memory_order_release);
+}
+
+StrandPool::Node* StrandPool::pop(Strand& s)
+{
+    NodeBase* head = s.head;
+    NodeBase* next = head->next.load(std::memory_order_acquire);
+    if (head == &s.stub) {
+        if (!next) {
+            return nullptr;
+        }
+        s.head = next;
+        head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        s.head = next;
+        return static_cast<Node*>(head);
+    }
+    if (head != s.tail.load(std::memory_order_acquire)) {
+        return nullptr; // a push is half done
+    }
+    // head is the last node: put the stub behind it so it can be taken
+    push(s, &s.stub);
+    next = head->next.load(std::memory_order_acquire);
+    if (next) {
+        s.head = next;
+        return static_cast<Node*>(head);
+    }
+    return nullptr;
+}
+
+void StrandPool::enqueue(uint64_t key, Task&& fn)
+{
+    Strand& s = strands_[strand_of(key)];
+    auto node = nodes_.acquire();
+    node->fn = std::move(fn);
+    push(s, node.release());
+
+    // Only the post that wakes an idle strand schedules a drain, so at most
+    // one drain per strand is ever queued or running
+    if (s.queued.fetch_add(1, std::memory_order_acq_rel) == 0) {
+        pool_.post([this, &s] { drain(s); });
+    }
+}
+
+void StrandPool::drain(Strand& s)
+{
+    s.drains.store(s.drains.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    for (size_t ran = 0; ran < budget_; ++ran) {
+        // queued > 0, so a node is on its way even if its push is half done
+        Node* node = pop(s);
+        while (!node) {
+            std::this_thread::yield();
+            node = pop(s);
+        }
+        auto owned = nodes_.adopt(node);
+        owned->fn();
+        owned.reset();
+        s.jobs_run.store(s.jobs_run.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (s.queued.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            return; // empty: the next post schedules a new drain
+        }
+    }
+    // Budget spent with jobs left: take our turn behind the other strands
+    s.yields.store(s.yields.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    pool_.post_shared([this, &s] { drain(s); });
+}
+
+StrandPool::Metrics StrandPool::get_metrics() const
+{
+    Metrics m;
+    for (size_t i = 0; i <= mask_; ++i) {
+        const Strand& s = strands_[i];
+        m.jobs_run += s.jobs_run.load(std::memory_order_relaxed);
+        m.drains += s.drains.load(std::memory_order_relaxed);
+        m.yields += s.yields.load(std::memory_order_relaxed);
+        const size_t queued = s.queued.load(std::memory_order_relaxed);
+        m.queued += queued;
+        m.busiest_queued = std::max(m.busiest_queued, queued);
+    }
+    m.node_heap_allocations = nodes_.get_metrics().heap_allocations;
+    return m;
+}
+
+} // namespace telemetryhub::gateway
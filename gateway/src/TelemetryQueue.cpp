@@ -1,51 +1,975 @@
 #include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/CoroExecutor.h"
+
+#include <thread>
+#include <vector>
 
 namespace telemetryhub::gateway {
 
-void TelemetryQueue::push(const device::TelemetrySample& sample)
+const char* to_string(QueueBackend backend)
+{
+    switch (backend) {
+        case QueueBackend::Mutex: return "mutex";
+        case QueueBackend::Spsc:  return "spsc";
+        case QueueBackend::Mpmc:  return "mpmc";
+        case QueueBackend::Conflating: return "conflating";
+    }
+    return "unknown";
+}
+
+bool parse_queue_backend(const std::string& s, QueueBackend& out)
+{
+    if (s == "mutex") { out = QueueBackend::Mutex; return true; }
+    if (s == "spsc")  { out = QueueBackend::Spsc;  return true; }
+    if (s == "mpmc")  { out = QueueBackend::Mpmc;  return true; }
+    if (s == "conflating") { out = QueueBackend::Conflating; return true; }
+    return false;
+}
+
+const char* to_string(BackpressurePolicy policy)
+{
+    switch (policy) {
+        case BackpressurePolicy::DropOldest:       return "drop_oldest";
+        case BackpressurePolicy::DropNewest:       return "drop_newest";
+        case BackpressurePolicy::BlockWithTimeout: return "block";
+        case BackpressurePolicy::DecimateEveryNth: return "decimate";
+        case BackpressurePolicy::SpillToDisk:      return "spill";
+    }
+    return "unknown";
+}
+
+bool parse_backpressure_policy(const std::string& s, BackpressurePolicy& out)
+{
+    if (s == "drop_oldest") { out = BackpressurePolicy::DropOldest;       return true; }
+    if (s == "drop_newest") { out = BackpressurePolicy::DropNewest;       return true; }
+    if (s == "block")       { out = BackpressurePolicy::BlockWithTimeout; return true; }
+    if (s == "decimate")    { out = BackpressurePolicy::DecimateEveryNth; return true; }
+    if (s == "spill")       { out = BackpressurePolicy::SpillToDisk;      return true; }
+    return false;
+}
+
+TelemetryQueue::TelemetryQueue(size_t max_size, QueueBackend backend)
+    : max_size_(max_size), backend_(backend)
+{
+    if (uses_ring()) {
+        rebuild_ring();
+    }
+}
+
+TelemetryQueue::~TelemetryQueue() = default;
+
+void TelemetryQueue::set_capacity(size_t cap)
+{
+    std::lock_guard lock(mutex_);
+    max_size_ = cap;
+    if (uses_ring()) {
+        rebuild_ring();
+    }
+}
+
+void TelemetryQueue::preallocate()
+{
+    std::lock_guard lock(mutex_);
+    if (!uses_ring()) {
+        queue_.reserve(max_size_);
+    }
+    control_.reserve(kControlReserve);
+}
+
+size_t TelemetryQueue::storage_bytes(QueueBackend backend, size_t capacity)
+{
+    switch (backend) {
+    case QueueBackend::Spsc:
+        return round_up_pow2(capacity > 0 ? capacity : kDefaultRingCapacity) *
+               SpscRingBuffer<Entry>::slot_bytes();
+    case QueueBackend::Mpmc:
+        return round_up_pow2(capacity > 0 ? capacity : kDefaultRingCapacity) *
+               MpmcRingBuffer<Entry>::slot_bytes();
+    default:
+        return capacity > 0 ? round_up_pow2(capacity) * sizeof(Entry) : 0; // unbounded: no bound
+    }
+}
+
+void TelemetryQueue::set_backend(QueueBackend backend)
+{
+    std::lock_guard lock(mutex_);
+    if (backend == backend_) {
+        return;
+    }
+    const bool was_ring = uses_ring();
+    restore_spill_locked(SIZE_MAX); // only the mutex backend spills
+    backend_ = backend;
+    if (uses_ring()) {
+        rebuild_ring();
+    } else if (was_ring) {
+        std::vector<Entry> carried;
+        drain_ring_into(carried);
+        for (auto& e : carried) {
+            queue_.push_back(std::move(e));
+        }
+    }
+    rebuild_index();
+}
+
+// Caller holds mutex_. Only the Conflating backend keeps an index.
+void TelemetryQueue::rebuild_index()
+{
+    index_.clear();
+    head_pos_ = 0;
+    depth_hint_.store(queue_.size(), std::memory_order_relaxed);
+    if (backend_ != QueueBackend::Conflating) {
+        return;
+    }
+    for (size_t i = 0; i < queue_.size(); ++i) {
+        index_[conflation_key(queue_[i].sample)] = i; // later duplicates win
+    }
+}
+
+// Caller holds mutex_ and guarantees no concurrent push/pop. Releases both rings.
+void TelemetryQueue::drain_ring_into(std::vector<Entry>& out)
+{
+    Entry e;
+    while (spsc_ && spsc_->try_pop(e)) {
+        out.push_back(std::move(e));
+    }
+    while (mpmc_ && mpmc_->try_pop(e)) {
+        out.push_back(std::move(e));
+    }
+    spsc_.reset();
+    mpmc_.reset();
+}
+
+// Caller holds mutex_ and guarantees no concurrent push/pop.
+void TelemetryQueue::rebuild_ring()
+{
+    const size_t limit = max_size_ > 0 ? max_size_ : kDefaultRingCapacity;
+
+    // Carry queued items over so reconfiguring behaves like the mutex backend
+    std::vector<Entry> carried;
+    drain_ring_into(carried);
+    for (size_t i = 0; i < queue_.size(); ++i) {
+        carried.push_back(std::move(queue_[i]));
+    }
+    queue_.clear();
+    depth_hint_.store(0, std::memory_order_relaxed);
+
+    const size_t skip = carried.size() > limit ? carried.size() - limit : 0;
+    if (backend_ == QueueBackend::Spsc) {
+        spsc_ = std::make_unique<SpscRingBuffer<Entry>>(limit);
+        for (size_t i = skip; i < carried.size(); ++i) {
+            spsc_->try_push(std::move(carried[i]));
+        }
+    } else {
+        mpmc_ = std::make_unique<MpmcRingBuffer<Entry>>(limit);
+        for (size_t i = skip; i < carried.size(); ++i) {
+            mpmc_->try_push(std::move(carried[i]));
+        }
+    }
+}
+
+size_t TelemetryQueue::ring_size() const
+{
+    return spsc_ ? spsc_->size() : (mpmc_ ? mpmc_->size() : 0);
+}
+
+// ---------------------------------------------------------------------------
+// Drop accounting
+// ---------------------------------------------------------------------------
+
+void TelemetryQueue::note_depth(size_t depth)
+{
+    size_t hw = high_watermark_.load(std::memory_order_relaxed);
+    while (depth > hw &&
+           !high_watermark_.compare_exchange_weak(hw, depth, std::memory_order_relaxed)) {
+    }
+}
+
+// DecimateEveryNth: every Nth arrival at a full queue gets in, the rest are skipped.
+bool TelemetryQueue::admit_decimated()
 {
+    const uint64_t n = overflow_arrivals_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (n % decimate_n_ == 0) {
+        return true;
+    }
+    decimated_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+TelemetryQueue::Metrics TelemetryQueue::get_metrics() const
+{
+    Metrics m;
+    m.pushed = pushed_.load(std::memory_order_relaxed);
+    m.dropped_oldest = dropped_oldest_.load(std::memory_order_relaxed);
+    m.dropped_newest = dropped_newest_.load(std::memory_order_relaxed);
+    m.decimated = decimated_.load(std::memory_order_relaxed);
+    m.block_timeouts = block_timeouts_.load(std::memory_order_relaxed);
+    m.aqm_dropped = aqm_dropped_.load(std::memory_order_relaxed);
+    m.conflated = conflated_.load(std::memory_order_relaxed);
+    m.spilled = spilled_.load(std::memory_order_relaxed);
+    m.restored = restored_.load(std::memory_order_relaxed);
+    m.high_watermark = high_watermark_.load(std::memory_order_relaxed);
+    m.sojourn = sojourn_.summary();
+
+    auto& control = m.lanes[static_cast<size_t>(Lane::Control)];
+    auto& bulk = m.lanes[static_cast<size_t>(Lane::Bulk)];
+    control.pushed = control_pushed_.load(std::memory_order_relaxed);
+    control.sojourn = control_sojourn_.summary();
+    bulk.pushed = m.pushed - control.pushed;
+    bulk.sojourn = m.sojourn;
     {
         std::lock_guard lock(mutex_);
-        if (shutdown_) {
-            return; // Do not accept new samples after shutdown
+        control.depth = control_.size();
+        bulk.depth = uses_ring() ? ring_size() : queue_.size();
+        if (spill_) {
+            m.spill_depth = spill_->size();
+            m.spill_disk_bytes = spill_->disk_bytes();
+            m.spill_bytes_written = spill_->bytes_written();
+            m.spill_bytes_read = spill_->bytes_read();
+            // bytes per ns -> MB/s
+            if (spill_write_ns_ > 0) {
+                m.spill_write_mb_s = 1e3 * static_cast<double>(m.spill_bytes_written) / spill_write_ns_;
+            }
+            if (spill_read_ns_ > 0) {
+                m.spill_read_mb_s = 1e3 * static_cast<double>(m.spill_bytes_read) / spill_read_ns_;
+            }
         }
-        if (max_size_ > 0 && queue_.size() >= max_size_) {
-            // Drop oldest to make room
-            queue_.pop();
+    }
+    m.depth = control.depth + bulk.depth;
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+// Sojourn-time AQM
+// ---------------------------------------------------------------------------
+
+void TelemetryQueue::set_sojourn_target(std::chrono::milliseconds target)
+{
+    sojourn_target_ = target.count() > 0 ? target : std::chrono::milliseconds(0);
+    drop_after_ns_.store(0, std::memory_order_relaxed);
+}
+
+void TelemetryQueue::set_sojourn_interval(std::chrono::milliseconds interval)
+{
+    sojourn_interval_ = interval.count() > 0 ? interval : std::chrono::milliseconds(0);
+    drop_after_ns_.store(0, std::memory_order_relaxed);
+}
+
+bool TelemetryQueue::deliver(const Entry& entry, int64_t now_ns)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+
+    const auto sojourn = nanoseconds(now_ns - entry.enqueued_ns);
+    if (sojourn_target_.count() > 0) {
+        if (sojourn >= sojourn_target_) {
+            // Stale: arm the interval on the first one, drop once it has passed.
+            // Racing consumers may both arm it; either deadline is fine.
+            int64_t drop_after = drop_after_ns_.load(std::memory_order_relaxed);
+            if (drop_after == 0) {
+                const int64_t armed = now_ns + duration_cast<nanoseconds>(sojourn_interval_).count();
+                drop_after = drop_after_ns_.compare_exchange_strong(
+                    drop_after, armed, std::memory_order_relaxed) ? armed : drop_after;
+            }
+            if (now_ns >= drop_after) {
+                aqm_dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } else if (drop_after_ns_.load(std::memory_order_relaxed) != 0) {
+            drop_after_ns_.store(0, std::memory_order_relaxed); // queue drained below target
         }
-        queue_.push(sample);
     }
-    cv_.notify_one();
+    sojourn_.record(sojourn);
+    return true;
 }
 
-void TelemetryQueue::push(device::TelemetrySample&& sample)
+// ---------------------------------------------------------------------------
+// Control lane
+// ---------------------------------------------------------------------------
+
+bool TelemetryQueue::push_control(device::TelemetrySample&& sample)
 {
     {
         std::lock_guard lock(mutex_);
-        if (shutdown_) {
-            return; // Do not accept new samples after shutdown
+        if (!push_control_locked(std::move(sample))) {
+            return false;
+        }
+    }
+    if (uses_ring()) {
+        wake_ring_consumer();
+    } else {
+        cv_.notify_one();
+        wake_async_consumer();
+    }
+    return true;
+}
+
+// Unbounded on purpose: status events are rare and must never be dropped.
+bool TelemetryQueue::push_control_locked(device::TelemetrySample&& sample)
+{
+    if (shutdown_) {
+        return false;
+    }
+    control_.push_back(Entry{std::move(sample), device::mono_ns()});
+    control_depth_.store(control_.size(), std::memory_order_release);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    control_pushed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool TelemetryQueue::take_control(Entry& out)
+{
+    if (control_depth_.load(std::memory_order_acquire) == 0) {
+        return false; // common case: one load, no lock
+    }
+    std::lock_guard lock(mutex_);
+    return take_control_locked(out);
+}
+
+bool TelemetryQueue::take_control_locked(Entry& out)
+{
+    if (control_.empty()) {
+        return false;
+    }
+    out = std::move(control_.front());
+    control_.pop_front();
+    control_depth_.store(control_.size(), std::memory_order_release);
+    control_sojourn_.record(std::chrono::nanoseconds(device::mono_ns() - out.enqueued_ns));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Mutex backend
+// ---------------------------------------------------------------------------
+
+// Applies the backpressure policy when the queue is full. Returns true if the
+// incoming sample may be enqueued. May release the lock (BlockWithTimeout).
+bool TelemetryQueue::make_room_locked(std::unique_lock<std::mutex>& lock)
+{
+    if (max_size_ == 0 || queue_.size() < max_size_) {
+        return true;
+    }
+    switch (policy_) {
+        case BackpressurePolicy::SpillToDisk: // Conflating: spilling would defeat the index
+        case BackpressurePolicy::DropOldest:
+            pop_front_locked();
+            dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        case BackpressurePolicy::DropNewest:
+            dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        case BackpressurePolicy::DecimateEveryNth:
+            if (!admit_decimated()) {
+                return false;
+            }
+            pop_front_locked();
+            dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        case BackpressurePolicy::BlockWithTimeout: {
+            cv_.notify_all(); // items from an in-progress push_bulk must be visible to consumers
+            wake_async_consumer();
+            space_waiters_.fetch_add(1, std::memory_order_relaxed);
+            const bool has_room = space_cv_.wait_for(lock, block_timeout_, [this] {
+                return shutdown_ || queue_.size() < max_size_;
+            });
+            space_waiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (shutdown_) {
+                return false;
+            }
+            if (!has_room) {
+                block_timeouts_.fetch_add(1, std::memory_order_relaxed);
+                dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
         }
-        if (max_size_ > 0 && queue_.size() >= max_size_) {
-            queue_.pop();
+    }
+    return true;
+}
+
+TelemetryQueue::Entry TelemetryQueue::pop_front_locked()
+{
+    Entry entry = std::move(queue_.front());
+    queue_.pop_front();
+    depth_hint_.store(queue_.size(), std::memory_order_relaxed);
+    if (backend_ == QueueBackend::Conflating) {
+        auto it = index_.find(conflation_key(entry.sample));
+        if (it != index_.end() && it->second == head_pos_) {
+            index_.erase(it);
+        }
+        ++head_pos_;
+    }
+    return entry;
+}
+
+bool TelemetryQueue::push_locked(std::unique_lock<std::mutex>& lock, device::TelemetrySample&& sample)
+{
+    if (shutdown_) {
+        return false; // Do not accept new samples after shutdown
+    }
+    uint64_t key = 0;
+    if (backend_ == QueueBackend::Conflating) {
+        key = conflation_key(sample);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            // Replace in place: keeps the key's place in line, no growth
+            Entry& queued = queue_[static_cast<size_t>(it->second - head_pos_)];
+            queued.sample = std::move(sample);
+            queued.enqueued_ns = device::mono_ns();
+            conflated_.fetch_add(1, std::memory_order_relaxed);
+            pushed_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    if (policy_ == BackpressurePolicy::SpillToDisk && backend_ == QueueBackend::Mutex &&
+        max_size_ > 0 && (queue_.size() >= max_size_ || (spill_ && !spill_->empty()))) {
+        return spill_locked(std::move(sample));
+    }
+    if (!make_room_locked(lock)) {
+        return false;
+    }
+    if (backend_ == QueueBackend::Conflating) {
+        index_[key] = head_pos_ + queue_.size();
+    }
+    // Avoid copy by constructing in-place
+    queue_.push_back(Entry{std::move(sample), device::mono_ns()});
+    depth_hint_.store(queue_.size(), std::memory_order_relaxed);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    note_depth(queue_.size());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Disk spill (SpillToDisk, Mutex backend)
+// ---------------------------------------------------------------------------
+
+bool TelemetryQueue::spill_locked(device::TelemetrySample&& sample)
+{
+    const int64_t start = device::mono_ns();
+    try {
+        if (!spill_) {
+            if (spill_dir_.empty()) {
+                spill_dir_ = std::filesystem::temp_directory_path() / "telemetryhub-spill";
+            }
+            spill_ = std::make_unique<SpillStore>(spill_dir_, spill_segment_bytes_);
         }
-        // Avoid copy by constructing in-place
-        queue_.emplace(std::move(sample));
+        spill_->append(sample, start);
+    } catch (const std::exception&) {
+        // Disk full or unwritable: lose this sample rather than stall the producer
+        dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
-    cv_.notify_one();
+    spill_write_ns_ += static_cast<uint64_t>(device::mono_ns() - start);
+    spilled_.fetch_add(1, std::memory_order_relaxed);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Restores in chunks (once queue_ is down to half) so the cost of touching
+// the segment is spread over many samples rather than paid on every pop.
+void TelemetryQueue::restore_spill_locked(size_t limit)
+{
+    if (limit == 0) {
+        limit = SIZE_MAX; // capacity was lifted while samples were on disk
+    }
+    if (!spill_ || spill_->empty() || (limit != SIZE_MAX && queue_.size() > limit / 2)) {
+        return;
+    }
+    const int64_t start = device::mono_ns();
+    Entry entry;
+    size_t n = 0;
+    // Keeps the original enqueue stamp: the sojourn (and AQM) include time on disk
+    while (queue_.size() < limit && spill_->pop(entry.sample, entry.enqueued_ns)) {
+        queue_.push_back(std::move(entry));
+        ++n;
+    }
+    depth_hint_.store(queue_.size(), std::memory_order_relaxed);
+    restored_.fetch_add(n, std::memory_order_relaxed);
+    spill_read_ns_ += static_cast<uint64_t>(device::mono_ns() - start);
+}
+
+bool TelemetryQueue::push(const device::TelemetrySample& sample)
+{
+    return push(device::TelemetrySample(sample));
+}
+
+bool TelemetryQueue::push(device::TelemetrySample&& sample)
+{
+    if (lane_of(sample) == Lane::Control) {
+        return push_control(std::move(sample));
+    }
+    if (backend_ == QueueBackend::Spsc) {
+        return push_ring(*spsc_, std::move(sample));
+    }
+    if (backend_ == QueueBackend::Mpmc) {
+        return push_ring(*mpmc_, std::move(sample));
+    }
+    bool accepted = false;
+    {
+        std::unique_lock lock(mutex_);
+        accepted = push_locked(lock, std::move(sample));
+    }
+    if (accepted) {
+        cv_.notify_one();
+        wake_async_consumer();
+    }
+    return accepted;
 }
 
 std::optional<device::TelemetrySample> TelemetryQueue::pop()
 {
+    return pop_until(nullptr);
+}
+
+std::optional<device::TelemetrySample> TelemetryQueue::try_pop_for(std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    return pop_until(&deadline);
+}
+
+// Spin phase for the mutex backends: poll the depth hint without the lock.
+// They always park on cv_, whatever the strategy, since a woken consumer has
+// to take mutex_ anyway.
+void TelemetryQueue::spin_for_data(const std::chrono::steady_clock::time_point* deadline)
+{
+    spin_until(wait_strategy_, [this] {
+        return shutdown_.load(std::memory_order_acquire) ||
+               depth_hint_.load(std::memory_order_relaxed) > 0 ||
+               control_depth_.load(std::memory_order_relaxed) > 0;
+    }, deadline);
+}
+
+std::optional<device::TelemetrySample> TelemetryQueue::pop_until(
+    const std::chrono::steady_clock::time_point* deadline)
+{
+    if (backend_ == QueueBackend::Spsc) {
+        return pop_ring(*spsc_, deadline);
+    }
+    if (backend_ == QueueBackend::Mpmc) {
+        return pop_ring(*mpmc_, deadline);
+    }
+
+    spin_for_data(deadline);
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        auto ready = [this] { return shutdown_ || !queue_.empty() || !control_.empty(); };
+        if (!deadline) {
+            cv_.wait(lock, ready);
+        } else if (!cv_.wait_until(lock, *deadline, ready)) {
+            return std::nullopt; // timed out
+        }
+
+        Entry control;
+        if (take_control_locked(control)) {
+            return std::move(control.sample);
+        }
+        if (shutdown_ && queue_.empty()) {
+            return std::nullopt;
+        }
+
+        const int64_t now = device::mono_ns();
+        while (!queue_.empty()) {
+            Entry entry = pop_front_locked();
+            restore_spill_locked(max_size_);
+            if (space_waiters_.load(std::memory_order_relaxed) > 0) {
+                space_cv_.notify_one();
+            }
+            if (deliver(entry, now)) {
+                return std::move(entry.sample);
+            }
+        }
+        // Everything queued was stale; wait for fresh data
+    }
+}
+
+size_t TelemetryQueue::push_bulk(std::span<const device::TelemetrySample> samples)
+{
+    return push_rows(samples.size(), [&samples](size_t i) { return samples[i]; });
+}
+
+size_t TelemetryQueue::push_bulk(const SampleBatch& batch)
+{
+    return push_rows(batch.size(), [&batch](size_t i) { return batch.sample(i); });
+}
+
+template <typename Row>
+size_t TelemetryQueue::push_rows(size_t n, Row row)
+{
+    if (n == 0) {
+        return 0;
+    }
+    size_t accepted = 0;
+    if (uses_ring()) {
+        if (shutdown_.load(std::memory_order_acquire)) {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            device::TelemetrySample sample = row(i);
+            const bool ok = lane_of(sample) == Lane::Control
+                ? push_control(std::move(sample))
+                : backend_ == QueueBackend::Spsc
+                ? enqueue_ring(*spsc_, std::move(sample))
+                : enqueue_ring(*mpmc_, std::move(sample));
+            accepted += ok ? 1 : 0;
+        }
+        wake_ring_consumer(accepted > 1);
+        return accepted;
+    }
+    {
+        std::unique_lock lock(mutex_);
+        for (size_t i = 0; i < n; ++i) {
+            device::TelemetrySample sample = row(i);
+            const bool ok = lane_of(sample) == Lane::Control
+                ? push_control_locked(std::move(sample))
+                : push_locked(lock, std::move(sample));
+            accepted += ok ? 1 : 0;
+        }
+    }
+    if (accepted > 1) {
+        cv_.notify_all();
+    } else if (accepted == 1) {
+        cv_.notify_one();
+    }
+    if (accepted > 0) {
+        wake_async_consumer();
+    }
+    return accepted;
+}
+
+size_t TelemetryQueue::pop_batch(std::vector<device::TelemetrySample>& out, size_t max_items,
+                                 std::chrono::milliseconds timeout)
+{
+    return pop_batch_into(out, max_items, timeout);
+}
+
+size_t TelemetryQueue::pop_batch(SampleBatch& out, size_t max_items, std::chrono::milliseconds timeout)
+{
+    return pop_batch_into(out, max_items, timeout);
+}
+
+template <typename Out>
+size_t TelemetryQueue::pop_batch_into(Out& out, size_t max_items, std::chrono::milliseconds timeout)
+{
+    if (max_items == 0) {
+        return 0;
+    }
+    if (backend_ == QueueBackend::Spsc) {
+        return pop_batch_ring(*spsc_, out, max_items, timeout);
+    }
+    if (backend_ == QueueBackend::Mpmc) {
+        return pop_batch_ring(*mpmc_, out, max_items, timeout);
+    }
+
+    // A zero timeout polls once, like the ring backends. It skips the
+    // condition variable too: waiting on an already-passed deadline still
+    // makes a futex call, which costs a context switch per empty poll.
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    if (timeout.count() > 0) {
+        spin_for_data(&deadline);
+    }
     std::unique_lock lock(mutex_);
-    cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+    if (timeout.count() > 0) {
+        cv_.wait_until(lock, deadline, [this] {
+            return shutdown_ || !queue_.empty() || !control_.empty();
+        });
+    }
+
+    size_t n = 0;
+    Entry control;
+    while (n < max_items && take_control_locked(control)) {
+        out.push_back(std::move(control.sample));
+        ++n;
+    }
+    const int64_t now = device::mono_ns();
+    size_t removed = 0;
+    while (n < max_items && !queue_.empty()) {
+        Entry entry = pop_front_locked();
+        ++removed;
+        if (deliver(entry, now)) {
+            out.push_back(std::move(entry.sample));
+            ++n;
+        }
+        restore_spill_locked(max_size_);
+    }
+    if (removed > 0 && space_waiters_.load(std::memory_order_relaxed) > 0) {
+        space_cv_.notify_all();
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Ring backends (Spsc / Mpmc)
+// ---------------------------------------------------------------------------
 
-    if (shutdown_ && queue_.empty()) {
+template <typename Ring>
+bool TelemetryQueue::push_ring(Ring& ring, device::TelemetrySample&& sample)
+{
+    if (shutdown_.load(std::memory_order_acquire)) {
+        return false; // Do not accept new samples after shutdown
+    }
+    const bool accepted = enqueue_ring(ring, std::move(sample));
+    if (accepted) {
+        wake_ring_consumer();
+    }
+    return accepted;
+}
+
+template <typename Ring>
+bool TelemetryQueue::enqueue_ring(Ring& ring, device::TelemetrySample&& sample)
+{
+    // Ring is physically rounded up to a power of two; enforce the logical
+    // limit here and apply the backpressure policy when it is reached.
+    const size_t limit = max_size_ > 0 ? max_size_ : kDefaultRingCapacity;
+    bool admitted = false; // DecimateEveryNth decides once per sample
+    Entry entry{std::move(sample), {}};
+    Entry evicted;
+    for (;;) {
+        if (ring.size() < limit) {
+            entry.enqueued_ns = device::mono_ns();
+            if (ring.try_push(std::move(entry))) {
+                break;
+            }
+        }
+        switch (policy_) {
+            case BackpressurePolicy::DropNewest:
+                dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case BackpressurePolicy::BlockWithTimeout:
+                if (!wait_ring_space(ring, limit)) {
+                    return false;
+                }
+                continue;
+            case BackpressurePolicy::DecimateEveryNth:
+                if (!admitted) {
+                    if (!admit_decimated()) {
+                        return false;
+                    }
+                    admitted = true;
+                }
+                [[fallthrough]];
+            case BackpressurePolicy::SpillToDisk: // rings: see BackpressurePolicy
+            case BackpressurePolicy::DropOldest:
+                if (ring.try_pop(evicted)) {
+                    dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+        }
+    }
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    note_depth(ring.size());
+    return true;
+}
+
+template <typename Ring>
+bool TelemetryQueue::wait_ring_space(Ring& ring, size_t limit)
+{
+    wake_ring_consumer(true); // samples of an in-progress push_bulk must be visible
+    const auto deadline = std::chrono::steady_clock::now() + block_timeout_;
+    int spins = 0;
+    for (;;) {
+        if (ring.size() < limit) {
+            return true;
+        }
+        if (shutdown_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            block_timeouts_.fetch_add(1, std::memory_order_relaxed);
+            dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (spins < kSpinBeforePark) {
+            ++spins;
+            std::this_thread::yield();
+            continue;
+        }
+
+        space_waiters_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock lock(mutex_);
+            space_cv_.wait_until(lock, deadline, [this, &ring, limit] {
+                return shutdown_ || ring.size() < limit;
+            });
+        }
+        space_waiters_.fetch_sub(1, std::memory_order_relaxed);
+        spins = 0;
+    }
+}
+
+void TelemetryQueue::wake_ring_consumer(bool all)
+{
+    wake_async_consumer();
+    if (wait_strategy_ == WaitStrategy::Futex) {
+        if (all) {
+            data_event_.notify_all();
+        } else {
+            data_event_.notify_one();
+        }
+        return;
+    }
+    // Pairs with the fence in park_ring_consumer(): either the consumer sees
+    // the new element before parking, or we see it registered as a waiter here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring_waiters_.load(std::memory_order_relaxed) > 0) {
+        { std::lock_guard lock(mutex_); }
+        if (all) {
+            cv_.notify_all();
+        } else {
+            cv_.notify_one();
+        }
+    }
+}
+
+void TelemetryQueue::wake_async_consumer()
+{
+    if (async_signal_) {
+        async_signal_->notify();
+    }
+}
+
+void TelemetryQueue::wake_ring_producer(bool all)
+{
+    // Mirror of wake_ring_consumer() for BlockWithTimeout producers
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (space_waiters_.load(std::memory_order_relaxed) > 0) {
+        { std::lock_guard lock(mutex_); }
+        if (all) {
+            space_cv_.notify_all();
+        } else {
+            space_cv_.notify_one();
+        }
+    }
+}
+
+template <typename Ring>
+bool TelemetryQueue::wait_ring(Ring& ring, Entry& first,
+                               const std::chrono::steady_clock::time_point* deadline,
+                               bool* from_control)
+{
+    for (;;) {
+        if (take_control(first)) {
+            return true;
+        }
+        if (ring.try_pop(first)) {
+            if (deliver(first, device::mono_ns())) {
+                if (from_control) {
+                    *from_control = false;
+                }
+                return true;
+            }
+            continue; // stale (AQM), try the next one
+        }
+        if (shutdown_.load(std::memory_order_acquire)) {
+            // Drain anything published before shutdown
+            if (take_control(first)) {
+                return true;
+            }
+            while (ring.try_pop(first)) {
+                if (deliver(first, device::mono_ns())) {
+                    if (from_control) {
+                        *from_control = false;
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+            return false;
+        }
+        auto ready = [this, &ring] {
+            return shutdown_.load(std::memory_order_acquire) || !ring.empty() ||
+                   control_depth_.load(std::memory_order_acquire) > 0;
+        };
+        if (spin_until(wait_strategy_, ready, deadline)) {
+            continue;
+        }
+        if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+            continue; // one last try_pop/shutdown check, then time out
+        }
+        park_ring_consumer(ready, deadline);
+    }
+}
+
+template <typename Ready>
+void TelemetryQueue::park_ring_consumer(Ready& ready,
+                                        const std::chrono::steady_clock::time_point* deadline)
+{
+    if (wait_strategy_ == WaitStrategy::Futex) {
+        const uint32_t epoch = data_event_.prepare_wait();
+        if (ready()) {
+            data_event_.cancel_wait();
+        } else {
+            data_event_.wait(epoch, deadline);
+        }
+        return;
+    }
+
+    ring_waiters_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock lock(mutex_);
+        if (deadline) {
+            cv_.wait_until(lock, *deadline, ready);
+        } else {
+            cv_.wait(lock, ready);
+        }
+    }
+    ring_waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename Ring>
+std::optional<device::TelemetrySample> TelemetryQueue::pop_ring(
+    Ring& ring, const std::chrono::steady_clock::time_point* deadline)
+{
+    Entry entry;
+    if (!wait_ring(ring, entry, deadline)) {
         return std::nullopt;
     }
+    if (policy_ == BackpressurePolicy::BlockWithTimeout) {
+        wake_ring_producer();
+    }
+    return std::move(entry.sample);
+}
 
-    auto sample = queue_.front();
-    queue_.pop();
-    return sample;
+template <typename Ring, typename Out>
+size_t TelemetryQueue::pop_batch_ring(Ring& ring, Out& out, size_t max_items,
+                                      std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    Entry first;
+    bool from_control = true;
+    if (!wait_ring(ring, first, &deadline, &from_control)) {
+        return 0;
+    }
+    size_t n = 0;
+    if (from_control) {
+        out.push_back(std::move(first.sample));
+        ++n;
+    }
+    // Any other control items lead the batch. This also catches a status
+    // pushed between wait_ring's control check and its ring pop, which would
+    // otherwise land behind the measurement it overtook.
+    Entry entry;
+    while (n + (from_control ? 0 : 1) < max_items && take_control(entry)) {
+        out.push_back(std::move(entry.sample));
+        ++n;
+    }
+    if (!from_control) {
+        out.push_back(std::move(first.sample));
+        ++n;
+    }
+    const int64_t now = device::mono_ns();
+    while (n < max_items && ring.try_pop(entry)) {
+        if (deliver(entry, now)) {
+            out.push_back(std::move(entry.sample));
+            ++n;
+        }
+    }
+    if (policy_ == BackpressurePolicy::BlockWithTimeout) {
+        wake_ring_producer(n > 1);
+    }
+    return n;
 }
 
 void TelemetryQueue::shutdown()
@@ -55,12 +979,15 @@ void TelemetryQueue::shutdown()
         shutdown_ = true;
     }
     cv_.notify_all();
+    space_cv_.notify_all();
+    data_event_.notify_all();
+    wake_async_consumer();
 }
 
 size_t TelemetryQueue::size()
 {
     std::lock_guard lock(mutex_);
-    return queue_.size();
+    return control_.size() + (uses_ring() ? ring_size() : queue_.size());
 }
 
-} // namespace telemetryhub::gateway
\ No newline at end of file
+} // namespace telemetryhub::gateway
@@ -0,0 +1,216 @@
+#include "telemetryhub/gateway/ThreadAffinity.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cstdlib>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace telemetryhub::gateway {
+
+namespace {
+bool parse_int(const std::string& s, int& out)
+{
+    if (s.empty() || !std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        return false;
+    }
+    try {
+        out = std::stoi(s);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+std::string trim(const std::string& s)
+{
+    const auto b = s.find_first_not_of(" \t");
+    if (b == std::string::npos) return {};
+    const auto e = s.find_last_not_of(" \t");
+    return s.substr(b, e - b + 1);
+}
+}
+
+bool parse_cpu_list(const std::string& text, std::vector<int>& out)
+{
+    std::vector<int> cpus;
+    const std::string all = trim(text);
+    if (all.empty() || all == "none") {
+        out.clear();
+        return true;
+    }
+    size_t pos = 0;
+    while (pos <= all.size()) {
+        size_t comma = all.find(',', pos);
+        if (comma == std::string::npos) comma = all.size();
+        const std::string item = trim(all.substr(pos, comma - pos));
+        const size_t dash = item.find('-');
+        int lo = 0;
+        int hi = 0;
+        if (dash == std::string::npos) {
+            if (!parse_int(item, lo)) return false;
+            hi = lo;
+        } else if (!parse_int(trim(item.substr(0, dash)), lo) ||
+                   !parse_int(trim(item.substr(dash + 1)), hi) || hi < lo) {
+            return false;
+        }
+        if (hi >= kMaxCpuId) {
+            return false; // a typo like 0-2000000000 must not expand
+        }
+        for (int c = lo; c <= hi; ++c) {
+            cpus.push_back(c);
+        }
+        pos = comma + 1;
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    out = std::move(cpus);
+    return true;
+}
+
+std::string format_cpu_list(const std::vector<int>& cpus)
+{
+    std::string s;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!s.empty()) s += ',';
+        s += std::to_string(cpus[i]);
+        if (j > i) {
+            s += '-';
+            s += std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return s;
+}
+
+#if defined(__linux__)
+
+bool pin_current_thread(const std::vector<int>& cpus)
+{
+    if (cpus.empty()) {
+        return true;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c < 0 || c >= CPU_SETSIZE) return false;
+        CPU_SET(c, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+void set_current_thread_name(const char* name)
+{
+    char buf[16]; // kernel limit including the terminator
+    std::strncpy(buf, name, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    pthread_setname_np(pthread_self(), buf);
+}
+
+std::string current_thread_name()
+{
+    char buf[16] = {};
+    if (pthread_getname_np(pthread_self(), buf, sizeof(buf)) != 0) {
+        return {};
+    }
+    return buf;
+}
+
+int current_cpu()
+{
+    return sched_getcpu();
+}
+
+int numa_node_of_cpu(int cpu)
+{
+    // /sys/devices/system/cpu/cpuN/ holds a "nodeM" link on NUMA kernels
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return -1;
+    }
+    int node = -1;
+    while (dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 && std::isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+#elif defined(_WIN32)
+
+bool pin_current_thread(const std::vector<int>& cpus)
+{
+    if (cpus.empty()) {
+        return true;
+    }
+    DWORD_PTR mask = 0;
+    for (int c : cpus) {
+        if (c < 0 || c >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+        mask |= DWORD_PTR{1} << c;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+void set_current_thread_name(const char* name)
+{
+    std::wstring wide(name, name + std::strlen(name));
+    SetThreadDescription(GetCurrentThread(), wide.c_str());
+}
+
+std::string current_thread_name()
+{
+    return {};
+}
+
+int current_cpu()
+{
+    return static_cast<int>(GetCurrentProcessorNumber());
+}
+
+int numa_node_of_cpu(int cpu)
+{
+    UCHAR node = 0;
+    return GetNumaProcessorNode(static_cast<UCHAR>(cpu), &node) ? node : -1;
+}
+
+#else
+
+bool pin_current_thread(const std::vector<int>& cpus) { return cpus.empty(); }
+void set_current_thread_name(const char*) {}
+std::string current_thread_name() { return {}; }
+int current_cpu() { return -1; }
+int numa_node_of_cpu(int) { return -1; }
+
+#endif
+
+bool cpus_share_numa_node(const std::vector<int>& cpus)
+{
+    if (cpus.empty()) {
+        return false;
+    }
+    const int node = numa_node_of_cpu(cpus.front());
+    if (node < 0) {
+        return false;
+    }
+    return std::all_of(cpus.begin(), cpus.end(), [node](int c) { return numa_node_of_cpu(c) == node; });
+}
+
+} // namespace telemetryhub::gateway
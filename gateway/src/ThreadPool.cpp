@@ -1,100 +1,655 @@
 #include "telemetryhub/gateway/ThreadPool.h"
-#include <chrono>
+#include "telemetryhub/gateway/Log.h"
+#include "telemetryhub/gateway/ThreadAffinity.h"
+#include "telemetryhub/device/Timestamp.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 
 namespace telemetryhub::gateway {
 
-ThreadPool::ThreadPool(size_t num_threads)
-    : stop_(false)
+namespace {
+size_t resolve_thread_count(size_t num_threads)
 {
     // Default to hardware concurrency
     if (num_threads == 0) {
         num_threads = std::thread::hardware_concurrency();
         if (num_threads == 0) num_threads = 4; // Fallback
     }
-    
-    // Spawn worker threads
-    workers_.reserve(num_threads);
-    for (size_t i = 0; i < num_threads; ++i) {
-        workers_.emplace_back(&ThreadPool::worker_loop, this);
+    return num_threads;
+}
+
+// Which pool (if any) the current thread works for, and its deque index.
+// Plain pointer/int: constant-initialized TLS, never allocates.
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local size_t t_worker = 0;
+
+bool is_urgent(JobPriority priority)
+{
+    return priority == JobPriority::Critical || priority == JobPriority::High;
+}
+
+uint64_t next_random(uint64_t& state)
+{
+    // xorshift64
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+}
+
+const char* to_string(JobPriority priority)
+{
+    switch (priority) {
+        case JobPriority::Critical: return "critical";
+        case JobPriority::High:     return "high";
+        case JobPriority::Normal:   return "normal";
+        case JobPriority::Low:      return "low";
+    }
+    return "unknown";
+}
+
+ThreadPool::ElasticConfig ThreadPool::ElasticConfig::resolved() const
+{
+    ElasticConfig r = *this;
+    r.max_threads = resolve_thread_count(max_threads);
+    r.min_threads = std::clamp<size_t>(min_threads, 1, r.max_threads);
+    r.grow_ticks = std::max(1u, grow_ticks);
+    r.shrink_ticks = std::max(1u, shrink_ticks);
+    if (r.interval.count() <= 0) r.interval = std::chrono::milliseconds(1);
+    return r;
+}
+
+ThreadPool::ThreadPool(size_t num_threads, WaitStrategy wait, std::vector<int> cpus)
+    : ThreadPool(ElasticConfig{resolve_thread_count(num_threads), resolve_thread_count(num_threads)},
+                 wait, std::move(cpus))
+{
+}
+
+ThreadPool::ThreadPool(const ElasticConfig& elastic, WaitStrategy wait, std::vector<int> cpus)
+    : elastic_(elastic.resolved()),
+      threads_(elastic_.max_threads),
+      owned_(elastic_.max_threads),
+      slots_(elastic_.max_threads),
+      states_(elastic_.max_threads),
+      job_pool_(elastic_.max_threads * kJobsPerWorker),
+      cpus_(std::move(cpus)),
+      started_(static_cast<std::ptrdiff_t>(elastic_.min_threads)),
+      stop_(false),
+      wait_strategy_(wait),
+      created_ns_(device::mono_ns())
+{
+    // Slots only: every worker allocates its own deque once it is pinned
+    for (size_t i = 0; i < elastic_.min_threads; ++i) {
+        start_worker(i, true);
+    }
+    started_.wait();
+    if (elastic_.min_threads < elastic_.max_threads) {
+        controller_ = std::thread(&ThreadPool::controller_loop, this);
     }
 }
 
 ThreadPool::~ThreadPool()
 {
-    // Signal workers to stop
+    // Signal workers (and the controller) to stop
     {
         std::lock_guard lock(queue_mutex_);
         stop_ = true;
     }
     cv_.notify_all();
-    
+    job_event_.notify_all();
+
+    // The controller first: after it is gone nobody else starts threads
+    if (controller_.joinable()) {
+        { std::lock_guard lock(controller_mutex_); }
+        controller_cv_.notify_all();
+        controller_.join();
+    }
+
     // Wait for all workers to finish
-    for (auto& worker : workers_) {
+    for (auto& worker : threads_) {
         if (worker.joinable()) {
             worker.join();
         }
     }
 }
 
-void ThreadPool::worker_loop()
+void ThreadPool::enqueue(Task&& fn, bool allow_local)
+{
+    const bool on_worker = t_pool == this;
+    if (!on_worker && stop_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("ThreadPool is stopped, cannot submit new jobs");
+    }
+
+    auto job = job_pool_.acquire();
+    job->fn = std::move(fn);
+    job->enqueued_ns = device::mono_ns();
+    job->deadline_ns = 0;
+    job->priority = JobPriority::Normal;
+
+    // Counted before it is visible, so a worker that takes it never sees 0
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+
+    // A worker's own jobs stay in its deque (no lock); a full deque and
+    // outside submitters use the injection queue
+    Worker* own = on_worker && allow_local ? slot(t_worker) : nullptr;
+    if (own && own->local.push(job.get())) {
+        job.release();
+        auto& jobs_local = own->jobs_local;
+        jobs_local.store(jobs_local.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    } else {
+        std::lock_guard lock(queue_mutex_);
+        if (!on_worker && stop_) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            throw std::runtime_error("ThreadPool is stopped, cannot submit new jobs");
+        }
+        injected_.push_back(job.release());
+        injected_size_.fetch_add(1, std::memory_order_release);
+    }
+
+    notify_one();
+}
+
+void ThreadPool::enqueue(Task&& fn, JobPriority priority, int64_t deadline_ns)
+{
+    const bool on_worker = t_pool == this;
+    if (!on_worker && stop_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("ThreadPool is stopped, cannot submit new jobs");
+    }
+
+    auto job = job_pool_.acquire();
+    job->fn = std::move(fn);
+    job->enqueued_ns = device::mono_ns();
+    job->priority = priority;
+    job->deadline_ns = deadline_ns > 0 ? deadline_ns : job->enqueued_ns + default_budget(priority).count();
+
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard lock(queue_mutex_);
+        if (!on_worker && stop_) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            throw std::runtime_error("ThreadPool is stopped, cannot submit new jobs");
+        }
+        edf_.push_back(job.release());
+        std::push_heap(edf_.begin(), edf_.end(), [](const Job* a, const Job* b) {
+            return a->deadline_ns > b->deadline_ns;
+        });
+        if (is_urgent(priority)) {
+            edf_urgent_.fetch_add(1, std::memory_order_relaxed);
+        }
+        edf_due_ns_.store(edf_.front()->deadline_ns, std::memory_order_relaxed);
+        edf_size_.fetch_add(1, std::memory_order_release);
+    }
+
+    notify_one();
+}
+
+ThreadPool::Job* ThreadPool::take_edf(bool urgent_only)
+{
+    // Urgent: a Critical/High job is queued, or the earliest deadline passed
+    auto urgent = [this] {
+        return edf_urgent_.load(std::memory_order_relaxed) > 0 ||
+               device::mono_ns() >= edf_due_ns_.load(std::memory_order_relaxed);
+    };
+    if (urgent_only && !urgent()) {
+        return nullptr;
+    }
+
+    std::lock_guard lock(queue_mutex_);
+    if (edf_.empty() || (urgent_only && !urgent())) {
+        return nullptr;
+    }
+    // Earliest deadline first, whichever class made the heap urgent
+    std::pop_heap(edf_.begin(), edf_.end(), [](const Job* a, const Job* b) {
+        return a->deadline_ns > b->deadline_ns;
+    });
+    Job* job = edf_.back();
+    edf_.pop_back();
+    if (is_urgent(job->priority)) {
+        edf_urgent_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    edf_due_ns_.store(edf_.empty() ? INT64_MAX : edf_.front()->deadline_ns, std::memory_order_relaxed);
+    edf_size_.fetch_sub(1, std::memory_order_relaxed);
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+void ThreadPool::notify_one()
+{
+    // pending_ was raised (seq_cst) before this load: either a parking worker
+    // sees the job in its predicate, or we see it in sleepers_ and wake it.
+    // Taking the mutex orders the notify after its predicate check.
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard lock(queue_mutex_); }
+        cv_.notify_one();
+    }
+    job_event_.notify_one();
+}
+
+ThreadPool::Job* ThreadPool::find_job(size_t index)
+{
+    Worker& self = *slot(index);
+    const bool tagged = edf_size_.load(std::memory_order_acquire) > 0;
+
+    // 0. Urgent tagged jobs, unless this worker has just run kUrgentBurst of
+    //    them in a row: then untagged work gets a turn
+    if (tagged && self.urgent_streak < kUrgentBurst) {
+        if (Job* job = take_edf(true)) {
+            ++self.urgent_streak;
+            return job;
+        }
+    }
+    if (Job* job = find_untagged_job(self, index)) {
+        self.urgent_streak = 0;
+        return job;
+    }
+    // 4. Nothing else to do: tagged jobs in deadline order, urgent or not
+    self.urgent_streak = 0;
+    return tagged ? take_edf(false) : nullptr;
+}
+
+ThreadPool::Job* ThreadPool::find_untagged_job(Worker& self, size_t index)
+{
+    Job* job = nullptr;
+
+    // 1. Own deque, newest first
+    if (self.local.pop(job)) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    // 2. Injection queue (lock only when it looks non-empty)
+    if (injected_size_.load(std::memory_order_acquire) > 0) {
+        std::lock_guard lock(queue_mutex_);
+        if (!injected_.empty()) {
+            job = injected_.front();
+            injected_.pop_front();
+            injected_size_.fetch_sub(1, std::memory_order_relaxed);
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // 3. Steal the oldest job of another worker, starting at a random victim
+    const size_t n = slots_used_.load(std::memory_order_acquire);
+    if (n > 1) {
+        const size_t start = static_cast<size_t>(next_random(self.rng) % n);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t victim = (start + i) % n;
+            Worker* other = slot(victim);
+            if (victim == index || !other) {
+                continue;
+            }
+            self.steal_attempts.store(self.steal_attempts.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_relaxed);
+            if (other->local.steal(job)) {
+                self.jobs_stolen.store(self.jobs_stolen.load(std::memory_order_relaxed) + 1,
+                                       std::memory_order_relaxed);
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::run_job(Job* job)
 {
+    // Back into a Handle: the node returns to the arena (and the callable's
+    // captures are destroyed) once the job has run
+    auto owned = job_pool_.adopt(job);
+    Worker& self = *slot(t_worker);
+
+    const size_t cls = static_cast<size_t>(owned->priority);
+    const int64_t start = device::mono_ns();
+    self.queue_wait[cls].record(static_cast<uint64_t>(std::max<int64_t>(0, start - owned->enqueued_ns)));
+
+    owned->fn();
+
+    const int64_t end = device::mono_ns();
+    const uint64_t ran = static_cast<uint64_t>(std::max<int64_t>(0, end - start));
+    self.run_time.record(ran);
+    if (owned->deadline_ns != 0 && end > owned->deadline_ns) {
+        auto& misses = self.deadline_misses[cls];
+        misses.store(misses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    self.busy_ns.store(self.busy_ns.load(std::memory_order_relaxed) + ran, std::memory_order_relaxed);
+}
+
+void ThreadPool::start_worker(size_t index, bool initial)
+{
+    // Single writer (constructor, then controller), so no CAS needed
+    states_[index].store(SlotState::Running, std::memory_order_release);
+    if (slots_used_.load(std::memory_order_relaxed) <= index) {
+        slots_used_.store(index + 1, std::memory_order_release);
+    }
+    active_.fetch_add(1, std::memory_order_relaxed);
+    threads_[index] = std::thread(&ThreadPool::worker_loop, this, index, initial);
+}
+
+void ThreadPool::worker_loop(size_t index, bool initial)
+{
+    t_pool = this;
+    t_worker = index;
+
+    const std::string name = "thub-pool-" + std::to_string(index);
+    set_current_thread_name(name.c_str());
+    const bool pinned = !cpus_.empty() && pin_current_thread({cpus_[index % cpus_.size()]});
+    if (pinned) {
+        workers_pinned_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // First start of this slot: allocate (and first-touch) it here, pinned.
+    // A restarted slot keeps its Worker: deque, counters and histograms.
+    if (!owned_[index]) {
+        owned_[index] = std::make_unique<Worker>(kJobsPerWorker);
+        owned_[index]->rng = 0x9E3779B97F4A7C15ull * (index + 1);
+        slots_[index].store(owned_[index].get(), std::memory_order_release);
+    }
+    if (initial) {
+        started_.count_down();
+    }
+
+    auto retiring = [this, index] {
+        return states_[index].load(std::memory_order_acquire) == SlotState::Retiring;
+    };
+    auto has_work = [this, &retiring] {
+        return stop_.load(std::memory_order_acquire) || pending_.load(std::memory_order_acquire) > 0 ||
+               retiring();
+    };
+
     while (true) {
-        std::function<void()> job;
-        
+        if (retiring()) {
+            retire_current(*owned_[index]);
+            if (pinned) {
+                workers_pinned_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            states_[index].store(SlotState::Exited, std::memory_order_release);
+            return;
+        }
+
+        if (Job* job = find_job(index)) {
+            run_job(job);
+            continue;
+        }
+
+        // Exit if stopped and no more jobs (jobs still running elsewhere
+        // push follow-ups to their own deque and run them there)
+        if (stop_.load(std::memory_order_acquire) && pending_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+
+        const WaitStrategy wait = wait_strategy_.load(std::memory_order_relaxed);
+
+        // Spin phase (none for Block), then park: Futex workers on the
+        // futex word, the others on the condition variable
+        if (spin_until(wait, has_work, nullptr)) {
+            continue;
+        }
+        if (wait == WaitStrategy::Futex) {
+            const uint32_t epoch = job_event_.prepare_wait();
+            if (has_work()) {
+                job_event_.cancel_wait();
+            } else {
+                job_event_.wait(epoch, nullptr);
+            }
+            continue;
+        }
+
+        std::unique_lock lock(queue_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        cv_.wait(lock, [this, &retiring] {
+            return stop_.load() || pending_.load(std::memory_order_seq_cst) > 0 || retiring();
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void ThreadPool::retire_current(Worker& self)
+{
+    // Only this worker pushes to its deque, so once it is empty it stays
+    // empty; thieves may still probe it, which is why the slot outlives us
+    Job* job = nullptr;
+    while (self.local.pop(job)) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        run_job(job);
+    }
+    self.urgent_streak = 0;
+    // The wakeup that reached us may have been meant for a job: pass it on
+    if (pending_.load(std::memory_order_seq_cst) > 0) {
+        notify_one();
+    }
+}
+
+bool ThreadPool::grow()
+{
+    // Lowest free slot, so the active workers stay packed at the front
+    for (size_t i = 0; i < elastic_.max_threads; ++i) {
+        if (states_[i].load(std::memory_order_acquire) == SlotState::Exited) {
+            threads_[i].join();
+            states_[i].store(SlotState::Empty, std::memory_order_relaxed);
+        }
+        if (states_[i].load(std::memory_order_relaxed) == SlotState::Empty) {
+            workers_started_.fetch_add(1, std::memory_order_relaxed);
+            start_worker(i, false);
+            return true;
+        }
+    }
+    return false; // every slot still running or draining
+}
+
+bool ThreadPool::shrink()
+{
+    // Highest running slot; it exits by itself once its deque is drained
+    for (size_t i = elastic_.max_threads; i-- > 0;) {
+        if (states_[i].load(std::memory_order_relaxed) != SlotState::Running) {
+            continue;
+        }
         {
-            std::unique_lock lock(queue_mutex_);
-            
-            // Wait for job or stop signal
-            cv_.wait(lock, [this] {
-                return stop_.load() || !jobs_.empty();
-            });
-            
-            // Exit if stopped and no more jobs
-            if (stop_ && jobs_.empty()) {
-                return;
+            std::lock_guard lock(queue_mutex_);
+            states_[i].store(SlotState::Retiring, std::memory_order_release);
+        }
+        // Counted before the size changes, so thread_count() and the
+        // resize counters never disagree in a snapshot taken after it
+        workers_retired_.fetch_add(1, std::memory_order_relaxed);
+        active_.fetch_sub(1, std::memory_order_relaxed);
+        cv_.notify_all();
+        job_event_.notify_all();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::controller_loop()
+{
+    set_current_thread_name("thub-pool-ctl");
+
+    std::vector<uint64_t> last_busy(elastic_.max_threads, 0);
+    int64_t last_ns = device::mono_ns();
+    unsigned pressured = 0;
+    unsigned idle = 0;
+
+    std::unique_lock lock(controller_mutex_);
+    while (!controller_cv_.wait_for(lock, elastic_.interval,
+                                    [this] { return stop_.load(std::memory_order_acquire); })) {
+        // Busy time the workers reported during this tick (a job is counted
+        // when it ends, so one long job can land in a single tick: clamp)
+        const int64_t now = device::mono_ns();
+        uint64_t busy = 0;
+        const size_t used = slots_used_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < used; ++i) {
+            if (const Worker* w = slot(i)) {
+                const uint64_t b = w->busy_ns.load(std::memory_order_relaxed);
+                busy += b - last_busy[i];
+                last_busy[i] = b;
             }
-            
-            // Get next job
-            if (!jobs_.empty()) {
-                job = std::move(jobs_.front());
-                jobs_.pop();
+        }
+        const size_t active = active_.load(std::memory_order_relaxed);
+        const double span = static_cast<double>(std::max<int64_t>(1, now - last_ns)) * static_cast<double>(active);
+        const double utilization = std::min(1.0, static_cast<double>(busy) / span);
+        recent_utilization_.store(utilization, std::memory_order_relaxed);
+        last_ns = now;
+
+        const size_t backlog = pending_.load(std::memory_order_relaxed);
+        const bool is_pressured = backlog > elastic_.grow_backlog * active ||
+                                  (backlog > 0 && utilization >= elastic_.grow_utilization);
+        const bool is_idle = backlog == 0 && utilization < elastic_.shrink_utilization;
+        pressured = is_pressured ? pressured + 1 : 0;
+        idle = is_idle ? idle + 1 : 0;
+
+        if (pressured >= elastic_.grow_ticks && active < elastic_.max_threads && grow()) {
+            pressured = 0;
+            TELEMETRYHUB_LOGF(::telemetryhub::LogLevel::Debug, "ThreadPool",
+                "[pool] grew to %zu workers (backlog %zu, utilization %.2f)", active + 1, backlog, utilization);
+        } else if (idle >= elastic_.shrink_ticks && active > elastic_.min_threads && shrink()) {
+            idle = 0;
+            TELEMETRYHUB_LOGF(::telemetryhub::LogLevel::Debug, "ThreadPool",
+                "[pool] shrank to %zu workers (utilization %.2f)", active - 1, utilization);
+        }
+    }
+}
+
+size_t ThreadPool::parallel_grain(size_t n, size_t grain) const
+{
+    if (grain > 0) {
+        return grain;
+    }
+    // About four chunks per worker: enough slack to even out uneven chunks
+    const size_t chunks = 4 * thread_count();
+    return n > chunks ? (n + chunks - 1) / chunks : 1;
+}
+
+size_t ThreadPool::parallel_helpers(size_t n, size_t grain) const
+{
+    // The caller takes a chunk itself, so one chunk needs no helper
+    const size_t chunks = (n + grain - 1) / grain;
+    return std::min(chunks - 1, thread_count());
+}
+
+void ThreadPool::drain_range(ParallelRange& range)
+{
+    while (true) {
+        const size_t chunk = range.next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= range.chunks) {
+            return;
+        }
+        const size_t b = range.begin + chunk * range.grain;
+        const size_t e = std::min(range.end, b + range.grain);
+        try {
+            range.run(range.body, chunk, b, e);
+        } catch (...) {
+            if (!range.failed.exchange(true, std::memory_order_acq_rel)) {
+                range.error = std::current_exception();
             }
+            // Nobody claims further chunks
+            range.next.store(range.chunks, std::memory_order_relaxed);
+            return;
         }
-        
-        // Execute job and measure time
-        if (job) {
-            auto start = std::chrono::steady_clock::now();
-            
-            job();
-            
-            auto end = std::chrono::steady_clock::now();
-            auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-            
-            // Update metrics
-            jobs_processed_.fetch_add(1, std::memory_order_relaxed);
-            total_processing_time_us_.fetch_add(duration_us, std::memory_order_relaxed);
+    }
+}
+
+void ThreadPool::run_parallel(ParallelRange& range, size_t helpers)
+{
+    for (size_t i = 0; i < helpers; ++i) {
+        try {
+            post([&range] {
+                drain_range(range);
+                range.helpers_done.count_down();
+            });
+        } catch (const std::runtime_error&) {
+            // Pool stopping: the caller runs the chunks those helpers would have
+            range.helpers_done.count_down(static_cast<std::ptrdiff_t>(helpers - i));
+            break;
+        }
+    }
+
+    drain_range(range);
+
+    if (t_pool == this) {
+        // Blocking here could starve the pool (our helpers may be queued in
+        // this worker's own deque), so keep running jobs until they are done
+        while (!range.helpers_done.try_wait()) {
+            if (Job* job = find_job(t_worker)) {
+                run_job(job);
+            } else {
+                std::this_thread::yield();
+            }
         }
+    } else {
+        range.helpers_done.wait();
     }
+
+    if (range.failed.load(std::memory_order_acquire)) {
+        std::rethrow_exception(range.error);
+    }
+}
+
+void ThreadPool::reserve(size_t n)
+{
+    std::lock_guard lock(queue_mutex_);
+    injected_.reserve(n);
+    edf_.reserve(n);
+}
+
+size_t ThreadPool::storage_bytes(size_t queued) const
+{
+    // Every slot counts, started or not: that is what the pool can grow to
+    size_t bytes = job_pool_.capacity() * sizeof(Job);
+    bytes += elastic_.max_threads * (sizeof(Worker) + round_up_pow2(kJobsPerWorker) * sizeof(Job*));
+    return bytes + (round_up_pow2(queued) + queued) * sizeof(Job*);
 }
 
 ThreadPool::Metrics ThreadPool::get_metrics() const
 {
     Metrics m;
-    m.jobs_processed = jobs_processed_.load(std::memory_order_relaxed);
-    m.num_threads = workers_.size();
-    
-    {
-        std::lock_guard lock(queue_mutex_);
-        m.jobs_queued = jobs_.size();
+    m.num_threads = thread_count();
+    m.min_threads = elastic_.min_threads;
+    m.max_threads = elastic_.max_threads;
+    m.workers_started = workers_started_.load(std::memory_order_relaxed);
+    m.workers_retired = workers_retired_.load(std::memory_order_relaxed);
+    m.recent_utilization = recent_utilization_.load(std::memory_order_relaxed);
+    m.jobs_queued = pending_.load(std::memory_order_relaxed);
+    m.job_heap_allocations = job_pool_.get_metrics().heap_allocations;
+    m.workers_pinned = workers_pinned_.load(std::memory_order_relaxed);
+
+    // Merged into one snapshot per histogram (heap-allocated, ~4 KB each)
+    auto wait = std::make_unique<LatencyHistogram>();
+    auto run = std::make_unique<LatencyHistogram>();
+    auto class_wait = std::make_unique<std::array<LatencyHistogram, kJobPriorities>>();
+    const double lifetime_ns = static_cast<double>(std::max<int64_t>(1, device::mono_ns() - created_ns_));
+    const size_t used = slots_used_.load(std::memory_order_acquire);
+    m.worker_utilization.reserve(used);
+    for (size_t i = 0; i < used; ++i) {
+        const Worker* q = slot(i);
+        if (!q) {
+            continue; // started, not yet allocated
+        }
+        m.jobs_local += q->jobs_local.load(std::memory_order_relaxed);
+        m.jobs_stolen += q->jobs_stolen.load(std::memory_order_relaxed);
+        m.steal_attempts += q->steal_attempts.load(std::memory_order_relaxed);
+        for (size_t c = 0; c < kJobPriorities; ++c) {
+            wait->merge(q->queue_wait[c]);
+            (*class_wait)[c].merge(q->queue_wait[c]);
+            m.priorities[c].deadline_misses += q->deadline_misses[c].load(std::memory_order_relaxed);
+        }
+        run->merge(q->run_time);
+        const double busy = static_cast<double>(q->busy_ns.load(std::memory_order_relaxed)) / lifetime_ns;
+        m.worker_utilization.push_back(std::min(1.0, busy));
+        m.utilization += m.worker_utilization.back();
     }
-    
-    // Calculate average processing time
-    uint64_t total_jobs = m.jobs_processed;
-    if (total_jobs > 0) {
-        uint64_t total_us = total_processing_time_us_.load(std::memory_order_relaxed);
-        m.avg_processing_ms = static_cast<double>(total_us) / total_jobs / 1000.0;
+    if (!m.worker_utilization.empty()) {
+        m.utilization /= static_cast<double>(m.worker_utilization.size());
     }
-    
+    for (size_t c = 0; c < kJobPriorities; ++c) {
+        m.priorities[c].queue_wait = (*class_wait)[c].summary();
+        m.priorities[c].jobs = m.priorities[c].queue_wait.count;
+    }
+    m.edf_queued = edf_size_.load(std::memory_order_relaxed);
+    m.queue_wait = wait->summary();
+    m.run_time = run->summary();
+    m.jobs_processed = m.run_time.count;
+    m.avg_processing_ms = m.run_time.mean_ns / 1e6;
+
     return m;
 }
 
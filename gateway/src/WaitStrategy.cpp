@@ -0,0 +1,93 @@
+#include "telemetryhub/gateway/WaitStrategy.h"
+
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace telemetryhub::gateway {
+
+const char* to_string(WaitStrategy strategy)
+{
+    switch (strategy) {
+        case WaitStrategy::Block:        return "block";
+        case WaitStrategy::Spin:         return "spin";
+        case WaitStrategy::SpinThenPark: return "spin_then_park";
+        case WaitStrategy::Futex:        return "futex";
+    }
+    return "unknown";
+}
+
+bool parse_wait_strategy(const std::string& s, WaitStrategy& out)
+{
+    if (s == "block")          { out = WaitStrategy::Block;        return true; }
+    if (s == "spin")           { out = WaitStrategy::Spin;         return true; }
+    if (s == "spin_then_park") { out = WaitStrategy::SpinThenPark; return true; }
+    if (s == "futex")          { out = WaitStrategy::Futex;        return true; }
+    return false;
+}
+
+#if defined(__linux__)
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+void FutexEvent::wait(uint32_t epoch, const std::chrono::steady_clock::time_point* deadline)
+{
+    timespec ts{};
+    timespec* timeout = nullptr;
+    if (deadline) {
+        const auto left = *deadline - std::chrono::steady_clock::now();
+        if (left <= std::chrono::steady_clock::duration::zero()) {
+            cancel_wait();
+            return;
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        timeout = &ts;
+    }
+    // Returns at once (EAGAIN) if a notify already moved the epoch on
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, epoch,
+            timeout, nullptr, 0);
+    cancel_wait();
+}
+
+void FutexEvent::wake(bool all)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE,
+            all ? INT_MAX : 1, nullptr, nullptr, 0);
+}
+
+#else
+
+// Portable fallback: std::atomic::wait is futex/WaitOnAddress based where the
+// standard library supports it, but has no timeout, so timed waits poll.
+void FutexEvent::wait(uint32_t epoch, const std::chrono::steady_clock::time_point* deadline)
+{
+    if (!deadline) {
+        epoch_.wait(epoch, std::memory_order_acquire);
+    } else {
+        while (epoch_.load(std::memory_order_acquire) == epoch &&
+               std::chrono::steady_clock::now() < *deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    cancel_wait();
+}
+
+void FutexEvent::wake(bool all)
+{
+    if (all) {
+        epoch_.notify_all();
+    } else {
+        epoch_.notify_one();
+    }
+}
+
+#endif
+
+} // namespace telemetryhub::gateway
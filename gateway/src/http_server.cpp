@@ -9,6 +9,7 @@
 #include <sstream>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 
 // minimal server exposing GatewayCore control/status via HTTP REST API
 namespace telemetryhub::gateway {
@@ -51,12 +52,37 @@ static void apply_cfg_if_any(const telemetryhub::gateway::AppConfig* cfg){
   if (!g_gateway) return;
   g_gateway->set_sampling_interval(cfg->sampling_interval);
   g_gateway->set_queue_capacity(cfg->queue_size);
+  g_gateway->set_producer_batch_size(cfg->producer_batch_size);
+  g_gateway->set_queue_backend(cfg->queue_backend);
+  g_gateway->set_backpressure_policy(cfg->queue_policy);
+  g_gateway->set_block_timeout(cfg->queue_block_timeout);
+  g_gateway->set_decimate_factor(cfg->queue_decimate_n);
+  g_gateway->set_spill_directory(cfg->queue_spill_dir);
+  g_gateway->set_spill_segment_bytes(cfg->queue_spill_segment_mb << 20);
+  g_gateway->set_queue_sojourn_target(cfg->queue_sojourn_target);
+  g_gateway->set_queue_sojourn_interval(cfg->queue_sojourn_interval);
+  g_gateway->set_queue_wait_strategy(cfg->queue_wait_strategy);
+  g_gateway->set_pool_wait_strategy(cfg->pool_wait_strategy);
+  g_gateway->set_zero_heap(cfg->zero_heap);
+  g_gateway->set_producer_cpus(cfg->producer_cpus);
+  g_gateway->set_consumer_cpus(cfg->consumer_cpus);
+  g_gateway->set_pool_cpus(cfg->pool_cpus);
+  g_gateway->set_pool_threads(cfg->pool_min_threads, cfg->pool_max_threads);
+  g_gateway->set_ordered_processing(cfg->pool_ordered);
+  g_gateway->set_offload(cfg->pool_offload, cfg->pool_offload_threshold);
+  g_gateway->set_loop_model(cfg->loop_model);
+  g_gateway->set_numa_local(cfg->numa_local);
   ::telemetryhub::Logger::instance().set_level(cfg->log_level);
 }
 
 int run_http_server(unsigned short port) {
   std::call_once(g_init_flag, []{ g_gateway = std::make_shared<GatewayCore>(); });
   httplib::Server svr;
+  if (g_gateway->loop_model() == LoopModel::Single) {
+    // Single-core deployment: one request thread instead of httplib's
+    // default pool (one per hardware thread, at least 8)
+    svr.new_task_queue = [] { return new httplib::ThreadPool(1); };
+  }
 
   svr.Get("/status", [](const httplib::Request& req, httplib::Response& res){
     (void)req;
@@ -76,7 +102,14 @@ int run_http_server(unsigned short port) {
       res.set_content("{\"error\":\"Gateway not initialized\"}", "application/json");
       return;
     }
-    g_gateway->start();
+    try {
+      g_gateway->start();
+    } catch (const std::invalid_argument& e) {
+      // Configuration that cannot run (e.g. zero_heap with an unbounded queue)
+      res.status = 400;
+      res.set_content(std::string("{\"ok\":false,\"message\":\"") + e.what() + "\"}", "application/json");
+      return;
+    }
     res.set_content("{\"ok\":true}", "application/json");
   });
 
@@ -129,11 +162,106 @@ int run_http_server(unsigned short port) {
     os << "\"queue_depth\":" << metrics.queue_depth << ",";
     os << "\"latency_p99_ms\":" << metrics.latency_p99_ms << ",";
     os << "\"uptime_seconds\":" << metrics.uptime_seconds << ",";
+    os << "\"queue\":{";
+    os << "\"dropped_oldest\":" << metrics.queue_dropped_oldest << ",";
+    os << "\"dropped_newest\":" << metrics.queue_dropped_newest << ",";
+    os << "\"decimated\":" << metrics.queue_decimated << ",";
+    os << "\"block_timeouts\":" << metrics.queue_block_timeouts << ",";
+    os << "\"aqm_dropped\":" << metrics.queue_aqm_dropped << ",";
+    os << "\"conflated\":" << metrics.queue_conflated << ",";
+    os << "\"spill\":{\"spilled\":" << metrics.queue_spilled
+       << ",\"restored\":" << metrics.queue_restored
+       << ",\"depth\":" << metrics.queue_spill_depth
+       << ",\"disk_bytes\":" << metrics.queue_spill_disk_bytes
+       << ",\"write_mb_s\":" << metrics.queue_spill_write_mb_s
+       << ",\"read_mb_s\":" << metrics.queue_spill_read_mb_s << "},";
+    os << "\"high_watermark\":" << metrics.queue_high_watermark << ",";
+    os << "\"sojourn_p50_ms\":" << metrics.queue_sojourn_p50_ms << ",";
+    os << "\"sojourn_p90_ms\":" << metrics.queue_sojourn_p90_ms << ",";
+    os << "\"sojourn_p99_ms\":" << metrics.queue_sojourn_p99_ms << ",";
+    os << "\"sojourn_max_ms\":" << metrics.queue_sojourn_max_ms << ",";
+    os << "\"lanes\":{";
+    os << "\"control\":{\"pushed\":" << metrics.queue_control_pushed
+       << ",\"depth\":" << metrics.queue_control_depth
+       << ",\"sojourn_p50_ms\":" << metrics.queue_control_sojourn_p50_ms
+       << ",\"sojourn_p99_ms\":" << metrics.queue_control_sojourn_p99_ms << "},";
+    os << "\"bulk\":{\"depth\":" << metrics.queue_bulk_depth
+       << ",\"sojourn_p50_ms\":" << metrics.queue_sojourn_p50_ms
+       << ",\"sojourn_p99_ms\":" << metrics.queue_sojourn_p99_ms << "}";
+    os << "}";
+    os << "},";
     os << "\"thread_pool\":{";
     os << "\"jobs_processed\":" << metrics.pool_jobs_processed << ",";
     os << "\"jobs_queued\":" << metrics.pool_jobs_queued << ",";
     os << "\"avg_processing_ms\":" << metrics.pool_avg_processing_ms << ",";
-    os << "\"num_threads\":" << metrics.pool_num_threads;
+    os << "\"num_threads\":" << metrics.pool_num_threads << ",";
+    os << "\"min_threads\":" << metrics.pool_min_threads << ",";
+    os << "\"max_threads\":" << metrics.pool_max_threads << ",";
+    os << "\"workers_started\":" << metrics.pool_workers_started << ",";
+    os << "\"workers_retired\":" << metrics.pool_workers_retired << ",";
+    os << "\"recent_utilization\":" << metrics.pool_recent_utilization << ",";
+    os << "\"jobs_local\":" << metrics.pool_jobs_local << ",";
+    os << "\"jobs_stolen\":" << metrics.pool_jobs_stolen << ",";
+    os << "\"steal_attempts\":" << metrics.pool_steal_attempts << ",";
+    os << "\"queue_wait\":{\"p50_ms\":" << metrics.pool_queue_wait_p50_ms
+       << ",\"p99_ms\":" << metrics.pool_queue_wait_p99_ms
+       << ",\"p999_ms\":" << metrics.pool_queue_wait_p999_ms
+       << ",\"max_ms\":" << metrics.pool_queue_wait_max_ms << "},";
+    os << "\"run_time\":{\"p50_ms\":" << metrics.pool_run_p50_ms
+       << ",\"p99_ms\":" << metrics.pool_run_p99_ms
+       << ",\"p999_ms\":" << metrics.pool_run_p999_ms
+       << ",\"max_ms\":" << metrics.pool_run_max_ms << "},";
+    os << "\"utilization\":" << metrics.pool_utilization << ",";
+    os << "\"worker_utilization\":[";
+    for (size_t i = 0; i < metrics.pool_worker_utilization.size(); ++i) {
+      os << (i ? "," : "") << metrics.pool_worker_utilization[i];
+    }
+    os << "],";
+    os << "\"edf_queued\":" << metrics.pool_edf_queued << ",";
+    os << "\"priorities\":{";
+    for (size_t c = 0; c < kJobPriorities; ++c) {
+      const auto& p = metrics.pool_priorities[c];
+      os << (c ? "," : "") << "\"" << to_string(static_cast<JobPriority>(c)) << "\":{"
+         << "\"jobs\":" << p.jobs
+         << ",\"queue_wait_p50_ms\":" << p.queue_wait_p50_ms
+         << ",\"queue_wait_p99_ms\":" << p.queue_wait_p99_ms
+         << ",\"queue_wait_p999_ms\":" << p.queue_wait_p999_ms
+         << ",\"deadline_misses\":" << p.deadline_misses << "}";
+    }
+    os << "},";
+    os << "\"strands\":{\"jobs\":" << metrics.strand_jobs
+       << ",\"drains\":" << metrics.strand_drains
+       << ",\"yields\":" << metrics.strand_yields
+       << ",\"queued\":" << metrics.strand_queued << "},";
+    os << "\"offload\":{\"mode\":\"" << to_string(metrics.offload_mode) << "\""
+       << ",\"threshold_us\":" << metrics.offload_threshold_us
+       << ",\"inline_batches\":" << metrics.offload_inline_batches
+       << ",\"pool_batches\":" << metrics.offload_pool_batches
+       << ",\"cost_ns_per_sample\":" << metrics.offload_cost_ns_per_sample
+       << ",\"inline_ms\":" << metrics.offload_inline_ms << "}";
+    os << "},";
+    os << "\"batch_pool\":{";
+    os << "\"acquired\":" << metrics.batch_pool_acquired << ",";
+    os << "\"reused\":" << metrics.batch_pool_reused << ",";
+    os << "\"heap_allocations\":" << metrics.batch_pool_heap_allocations << ",";
+    os << "\"in_use\":" << metrics.batch_pool_in_use;
+    os << "},";
+    os << "\"memory\":{";
+    os << "\"zero_heap\":" << (metrics.zero_heap ? "true" : "false") << ",";
+    os << "\"budget_bytes\":" << metrics.memory_budget_bytes << ",";
+    os << "\"hook_installed\":" << (metrics.heap_hook_installed ? "true" : "false") << ",";
+    os << "\"heap_allocations\":" << metrics.heap_allocations << ",";
+    os << "\"heap_violations\":" << metrics.heap_violations << ",";
+    os << "\"heap_exempt\":" << metrics.heap_exempt;
+    os << "},";
+    os << "\"threads\":{";
+    os << "\"pinned\":" << metrics.threads_pinned << ",";
+    os << "\"pin_failures\":" << metrics.pin_failures << ",";
+    os << "\"loops\":{\"model\":\"" << to_string(metrics.loop_model) << "\""
+       << ",\"threads\":" << metrics.loop_threads
+       << ",\"resumes\":" << metrics.loop_resumes
+       << ",\"parks\":" << metrics.loop_parks
+       << ",\"remote_wakeups\":" << metrics.loop_remote_wakeups << "}";
     os << "}";
     os << "}";
     res.set_content(os.str(), "application/json");
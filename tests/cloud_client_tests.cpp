@@ -66,4 +66,47 @@ TEST(CloudClientIntegration, CadenceAndTransitions) {
                 last == telemetryhub::device::DeviceState::Error);
 }
 
+TEST(CloudClientIntegration, ProducerMicroBatchesReachCloudAsOneCall) {
+    auto mock = std::make_shared<MockCloudClient>();
+    telemetryhub::gateway::GatewayCore gw;
+    gw.set_cloud_client(mock, 1); // forward every sample
+    gw.set_sampling_interval(std::chrono::milliseconds(5));
+    gw.set_producer_batch_size(3);
+    gw.start();
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2000)) {
+        if (mock->sample_count() >= 9) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    gw.stop();
+
+    const auto sizes = mock->batch_sizes_snapshot();
+    ASSERT_GE(sizes.size(), 3u);
+    for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+        EXPECT_EQ(sizes[i], 3u); // only the flush on stop may be short
+    }
+    EXPECT_GE(gw.get_metrics().samples_processed, 9u);
+}
+
+TEST(CloudClientIntegration, RingBackendsForwardStatusEvents) {
+    for (auto backend : {QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        auto mock = std::make_shared<MockCloudClient>();
+        telemetryhub::gateway::GatewayCore gw;
+        gw.set_queue_backend(backend);
+        gw.set_cloud_client(mock, 1);
+        gw.set_sampling_interval(std::chrono::milliseconds(2));
+        gw.start();
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2000)) {
+            if (mock->sample_count() >= 5 && mock->status_count() >= 1) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        gw.stop();
+        auto statuses = mock->statuses_snapshot();
+        ASSERT_FALSE(statuses.empty());
+        EXPECT_EQ(statuses.front(), telemetryhub::device::DeviceState::Measuring);
+        EXPECT_GE(mock->sample_count(), 5u);
+    }
+}
+
 } // namespace telemetryhub::gateway
\ No newline at end of file
@@ -22,6 +22,13 @@ namespace telemetryhub::gateway {
             std::lock_guard<std::mutex> lock(mutex_);
             statuses_.push_back(state);
         }
+
+        void push_batch(const SampleBatch& batch) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch_sizes_.push_back(batch.size());
+            batch.append_to(samples_);
+        }
     public:
         // Thread-safe accessors for tests
         size_t sample_count() {
@@ -36,10 +43,15 @@ namespace telemetryhub::gateway {
             std::lock_guard<std::mutex> lock(mutex_);
             return statuses_;
         }
+        std::vector<size_t> batch_sizes_snapshot() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return batch_sizes_;
+        }
 
     private:
         std::vector<telemetryhub::device::TelemetrySample> samples_;
         std::vector<telemetryhub::device::DeviceState> statuses_;
+        std::vector<size_t> batch_sizes_;
         std::mutex mutex_;
     };
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include "telemetryhub/device/TelemetrySample.h"
+#include <cstdint>
+#include <optional>
+
+namespace telemetryhub::device {
+
+    // Measurement for queue/batch tests. The value defaults to the sequence
+    // number, the unit is always "test" and the timestamp is 1000 + seq.
+    inline TelemetrySample make_sample(std::uint32_t seq, std::uint32_t device_id = 0,
+                                       std::uint16_t channel = 0,
+                                       std::optional<double> value = std::nullopt)
+    {
+        TelemetrySample s;
+        s.sequence_id = seq;
+        s.device_id = device_id;
+        s.channel = channel;
+        s.value = value.value_or(static_cast<double>(seq));
+        s.unit = "test";
+        s.timestamp_ns = 1000 + static_cast<std::int64_t>(seq);
+        return s;
+    }
+
+} // namespace telemetryhub::device
@@ -14,7 +14,7 @@ protected:
         s.sequence_id = seq;
         s.value = static_cast<double>(seq);
         s.unit = "test";
-        s.timestamp = std::chrono::system_clock::now();
+        s.timestamp_ns = wall_ns();
         return s;
     }
 };
@@ -197,3 +197,348 @@ TEST_F(BoundedQueueTest, EmptyQueueReturnsNulloptOnShutdown) {
     auto sample = q.pop();
     EXPECT_FALSE(sample.has_value());
 }
+
+TEST_F(BoundedQueueTest, PushBulkKeepsOrderAndDropsOldest) {
+    TelemetryQueue q(3);
+    std::vector<TelemetrySample> burst;
+    for (uint32_t i = 1; i <= 5; ++i) {
+        burst.push_back(make_sample(i));
+    }
+    q.push_bulk(burst);
+    EXPECT_EQ(q.size(), 3u);
+
+    std::vector<TelemetrySample> out;
+    EXPECT_EQ(q.pop_batch(out, 10, std::chrono::milliseconds(0)), 3u);
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0].sequence_id, 3u);
+    EXPECT_EQ(out[2].sequence_id, 5u);
+}
+
+TEST_F(BoundedQueueTest, PopBatchRespectsMaxItemsAndAppends) {
+    TelemetryQueue q;
+    for (uint32_t i = 0; i < 10; ++i) {
+        q.push(make_sample(i));
+    }
+
+    std::vector<TelemetrySample> out{make_sample(99)};
+    EXPECT_EQ(q.pop_batch(out, 4, std::chrono::milliseconds(10)), 4u);
+    ASSERT_EQ(out.size(), 5u);
+    EXPECT_EQ(out[0].sequence_id, 99u); // existing content untouched
+    EXPECT_EQ(out[1].sequence_id, 0u);
+    EXPECT_EQ(out[4].sequence_id, 3u);
+    EXPECT_EQ(q.size(), 6u);
+}
+
+TEST_F(BoundedQueueTest, PopBatchTimesOutWhenEmpty) {
+    TelemetryQueue q;
+    std::vector<TelemetrySample> out;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(q.pop_batch(out, 8, std::chrono::milliseconds(20)), 0u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+    EXPECT_FALSE(q.is_shutdown());
+}
+
+TEST_F(BoundedQueueTest, PopBatchDrainsThenReportsShutdown) {
+    TelemetryQueue q;
+    q.push(make_sample(1));
+    q.shutdown();
+
+    std::vector<TelemetrySample> out;
+    EXPECT_EQ(q.pop_batch(out, 8, std::chrono::milliseconds(1000)), 1u);
+    EXPECT_EQ(q.pop_batch(out, 8, std::chrono::milliseconds(1000)), 0u);
+    EXPECT_TRUE(q.is_shutdown());
+}
+
+TEST_F(BoundedQueueTest, MetricsCountDropOldest) {
+    TelemetryQueue q(3);
+    for (uint32_t i = 1; i <= 5; ++i) {
+        EXPECT_TRUE(q.push(make_sample(i)));
+    }
+    auto m = q.get_metrics();
+    EXPECT_EQ(m.pushed, 5u);
+    EXPECT_EQ(m.dropped_oldest, 2u);
+    EXPECT_EQ(m.dropped_total(), 2u);
+    EXPECT_EQ(m.depth, 3u);
+    EXPECT_EQ(m.high_watermark, 3u);
+}
+
+TEST_F(BoundedQueueTest, DropNewestKeepsQueuedSamples) {
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(3, backend);
+        q.set_backpressure_policy(BackpressurePolicy::DropNewest);
+        for (uint32_t i = 1; i <= 5; ++i) {
+            EXPECT_EQ(q.push(make_sample(i)), i <= 3);
+        }
+        auto m = q.get_metrics();
+        EXPECT_EQ(m.pushed, 3u);
+        EXPECT_EQ(m.dropped_newest, 2u);
+        EXPECT_EQ(m.dropped_oldest, 0u);
+
+        for (uint32_t expected = 1; expected <= 3; ++expected) {
+            auto s = q.pop();
+            ASSERT_TRUE(s.has_value());
+            EXPECT_EQ(s->sequence_id, expected);
+        }
+    }
+}
+
+TEST_F(BoundedQueueTest, DecimateAdmitsEveryNthOnOverflow) {
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(2, backend);
+        q.set_backpressure_policy(BackpressurePolicy::DecimateEveryNth);
+        q.set_decimate_factor(3);
+        // 1,2 fill the queue; 3..8 overflow and only every 3rd (5 and 8) gets in
+        for (uint32_t i = 1; i <= 8; ++i) {
+            q.push(make_sample(i));
+        }
+        auto m = q.get_metrics();
+        EXPECT_EQ(m.decimated, 4u);
+        EXPECT_EQ(m.dropped_oldest, 2u);
+        EXPECT_EQ(m.dropped_total(), 6u);
+
+        std::vector<TelemetrySample> out;
+        EXPECT_EQ(q.pop_batch(out, 8, std::chrono::milliseconds(0)), 2u);
+        EXPECT_EQ(out[0].sequence_id, 5u);
+        EXPECT_EQ(out[1].sequence_id, 8u);
+    }
+}
+
+TEST_F(BoundedQueueTest, BlockTimesOutWhenNobodyConsumes) {
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(1, backend);
+        q.set_backpressure_policy(BackpressurePolicy::BlockWithTimeout);
+        q.set_block_timeout(std::chrono::milliseconds(5));
+        EXPECT_TRUE(q.push(make_sample(1)));
+        EXPECT_FALSE(q.push(make_sample(2)));
+
+        auto m = q.get_metrics();
+        EXPECT_EQ(m.block_timeouts, 1u);
+        EXPECT_EQ(m.dropped_newest, 1u);
+        auto s = q.pop();
+        ASSERT_TRUE(s.has_value());
+        EXPECT_EQ(s->sequence_id, 1u);
+    }
+}
+
+TEST_F(BoundedQueueTest, BlockLosesNothingWithLiveConsumer) {
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(4, backend);
+        q.set_backpressure_policy(BackpressurePolicy::BlockWithTimeout);
+        q.set_block_timeout(std::chrono::seconds(5));
+        constexpr uint32_t total = 2000;
+
+        std::thread producer([&] {
+            for (uint32_t i = 0; i < total; ++i) {
+                q.push(make_sample(i));
+            }
+            q.shutdown();
+        });
+
+        uint32_t expected = 0;
+        bool ordered = true;
+        while (auto s = q.pop()) {
+            ordered = ordered && (s->sequence_id == expected);
+            ++expected;
+        }
+        producer.join();
+
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(expected, total);
+        auto m = q.get_metrics();
+        EXPECT_EQ(m.dropped_total(), 0u);
+        EXPECT_LE(m.high_watermark, 4u);
+    }
+}
+
+TEST_F(BoundedQueueTest, ShutdownReleasesBlockedProducer) {
+    TelemetryQueue q(1);
+    q.set_backpressure_policy(BackpressurePolicy::BlockWithTimeout);
+    q.set_block_timeout(std::chrono::seconds(30));
+    q.push(make_sample(1));
+
+    std::thread producer([&] { EXPECT_FALSE(q.push(make_sample(2))); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.shutdown();
+    producer.join();
+    EXPECT_EQ(q.get_metrics().block_timeouts, 0u);
+}
+
+namespace {
+TelemetrySample keyed_sample(uint32_t seq, uint32_t device_id, uint16_t channel = 0)
+{
+    TelemetrySample s;
+    s.sequence_id = seq;
+    s.device_id = device_id;
+    s.channel = channel;
+    return s;
+}
+}
+
+TEST_F(BoundedQueueTest, ConflatingKeepsLatestPerKeyInPlace) {
+    TelemetryQueue q(0, QueueBackend::Conflating);
+    q.push(keyed_sample(1, 1));
+    q.push(keyed_sample(2, 2));
+    q.push(keyed_sample(3, 1));    // replaces #1, keeps its place in line
+    q.push(keyed_sample(4, 1, 7)); // same device, other channel: new key
+    q.push(keyed_sample(5, 2));    // replaces #2
+    EXPECT_EQ(q.size(), 3u);
+
+    for (uint32_t expected : {3u, 5u, 4u}) {
+        auto s = q.pop();
+        ASSERT_TRUE(s.has_value());
+        EXPECT_EQ(s->sequence_id, expected);
+    }
+    auto m = q.get_metrics();
+    EXPECT_EQ(m.conflated, 2u);
+    EXPECT_EQ(m.pushed, 5u);
+    EXPECT_EQ(m.dropped_total(), 0u); // conflation keeps the latest state
+}
+
+TEST_F(BoundedQueueTest, ConflatingIndexTracksEvictionsAndPops) {
+    TelemetryQueue q(2, QueueBackend::Conflating);
+    q.push(keyed_sample(1, 1));
+    q.push(keyed_sample(2, 2));
+    q.push(keyed_sample(3, 3)); // full: evicts key 1
+    q.push(keyed_sample(4, 1)); // key 1 no longer queued: evicts key 2
+    q.push(keyed_sample(5, 3)); // replaces #3
+    EXPECT_EQ(q.get_metrics().dropped_oldest, 2u);
+
+    std::vector<TelemetrySample> out;
+    EXPECT_EQ(q.pop_batch(out, 1, std::chrono::milliseconds(0)), 1u);
+    q.push(keyed_sample(6, 1)); // replaces #4, which is still queued
+    q.push(keyed_sample(7, 3)); // #5 was popped: queued again as new
+    EXPECT_EQ(q.pop_batch(out, 8, std::chrono::milliseconds(0)), 2u);
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0].sequence_id, 5u);
+    EXPECT_EQ(out[1].sequence_id, 6u);
+    EXPECT_EQ(out[2].sequence_id, 7u);
+}
+
+TEST_F(BoundedQueueTest, ConflatingBoundsDepthByKeyCount) {
+    TelemetryQueue q(0, QueueBackend::Conflating);
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < 20000; ++i) {
+            q.push(keyed_sample(i, i % 8));
+        }
+        q.shutdown();
+    });
+    std::vector<uint32_t> last(8, 0);
+    bool monotonic_per_key = true;
+    while (auto s = q.pop()) {
+        monotonic_per_key = monotonic_per_key && (s->sequence_id >= last[s->device_id]);
+        last[s->device_id] = s->sequence_id;
+    }
+    producer.join();
+
+    EXPECT_TRUE(monotonic_per_key);
+    auto m = q.get_metrics();
+    EXPECT_LE(m.high_watermark, 8u);
+    for (uint32_t k = 0; k < 8; ++k) {
+        EXPECT_EQ(last[k], 20000u - 8u + k); // newest value per key always arrives
+    }
+}
+
+namespace {
+TelemetrySample status_event(uint32_t seq)
+{
+    TelemetrySample s;
+    s.sequence_id = seq;
+    s.kind = SampleKind::Status;
+    return s;
+}
+}
+
+TEST_F(BoundedQueueTest, ControlLaneOvertakesBulkSamples) {
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc,
+                         QueueBackend::Conflating}) {
+        TelemetryQueue q(1000, backend);
+        for (uint32_t i = 1; i <= 500; ++i) {
+            auto s = make_sample(i);
+            s.device_id = i; // distinct keys for the conflating backend
+            q.push(std::move(s));
+        }
+        q.push(status_event(9001));
+        q.push(status_event(9002));
+
+        auto first = q.pop();
+        ASSERT_TRUE(first.has_value());
+        EXPECT_EQ(first->sequence_id, 9001u);
+
+        std::vector<TelemetrySample> out;
+        EXPECT_EQ(q.pop_batch(out, 2, std::chrono::milliseconds(0)), 2u);
+        EXPECT_EQ(out[0].sequence_id, 9002u);
+        EXPECT_EQ(out[1].sequence_id, 1u);
+
+        auto m = q.get_metrics();
+        const auto& control = m.lanes[static_cast<size_t>(Lane::Control)];
+        const auto& bulk = m.lanes[static_cast<size_t>(Lane::Bulk)];
+        EXPECT_EQ(control.pushed, 2u);
+        EXPECT_EQ(control.depth, 0u);
+        EXPECT_EQ(control.sojourn.count, 2u);
+        EXPECT_EQ(bulk.pushed, 500u);
+        EXPECT_EQ(bulk.depth, 499u);
+        EXPECT_EQ(m.depth, 499u);
+    }
+}
+
+TEST_F(BoundedQueueTest, ControlLaneIsNeverDropped) {
+    TelemetryQueue q(2);
+    q.set_backpressure_policy(BackpressurePolicy::DropNewest);
+    q.push(make_sample(1));
+    q.push(make_sample(2));
+    EXPECT_FALSE(q.push(make_sample(3)));   // bulk lane full
+    EXPECT_TRUE(q.push(status_event(100))); // control lane unaffected
+    EXPECT_EQ(q.size(), 3u);
+    EXPECT_EQ(q.pop()->sequence_id, 100u);
+}
+
+TEST_F(BoundedQueueTest, ControlEventWakesParkedRingConsumer) {
+    for (auto backend : {QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(16, backend);
+        std::optional<TelemetrySample> got;
+        std::thread consumer([&] { got = q.pop(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        q.push(status_event(7));
+        consumer.join();
+        ASSERT_TRUE(got.has_value());
+        EXPECT_EQ(got->kind, SampleKind::Status);
+        q.shutdown();
+    }
+}
+
+TEST_F(BoundedQueueTest, ControlEventLeadsRingBatchWhenConsumerWasParked) {
+    for (auto backend : {QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        for (uint32_t round = 0; round < 50; ++round) {
+            TelemetryQueue q(16, backend);
+            std::vector<std::vector<TelemetrySample>> batches;
+            std::thread consumer([&] {
+                size_t seen = 0;
+                while (seen < 2) {
+                    std::vector<TelemetrySample> out;
+                    seen += q.pop_batch(out, 8, std::chrono::milliseconds(1000));
+                    batches.push_back(std::move(out));
+                }
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // consumer parks
+            q.push(make_sample(round));
+            q.push(status_event(9000 + round));
+            consumer.join();
+
+            bool got_status = false;
+            for (const auto& batch : batches) {
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    if (batch[i].kind == SampleKind::Status) {
+                        got_status = true;
+                        EXPECT_EQ(batch[i].sequence_id, 9000u + round);
+                        // Only other control items may precede it in its batch
+                        for (size_t j = 0; j < i; ++j) {
+                            EXPECT_EQ(batch[j].kind, SampleKind::Status);
+                        }
+                    }
+                }
+            }
+            EXPECT_TRUE(got_status);
+            q.shutdown();
+        }
+    }
+}
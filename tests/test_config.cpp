@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include <filesystem>
+#include <vector>
 
 using namespace telemetryhub::gateway;
 
@@ -55,6 +56,10 @@ log_level = info  ; another inline
     EXPECT_EQ(cfg.sampling_interval.count(), 100);
     EXPECT_EQ(cfg.queue_size, 256u);
     EXPECT_EQ(cfg.log_level, ::telemetryhub::LogLevel::Info);
+    EXPECT_EQ(cfg.queue_backend, QueueBackend::Mutex);
+    EXPECT_EQ(cfg.queue_policy, BackpressurePolicy::DropOldest);
+    EXPECT_EQ(cfg.queue_wait_strategy, WaitStrategy::SpinThenPark);
+    EXPECT_EQ(cfg.pool_wait_strategy, WaitStrategy::Block);
 }
 
 TEST_F(ConfigTest, LoadConfigWithWhitespace) {
@@ -158,9 +163,98 @@ another_unknown = value
     EXPECT_EQ(cfg.queue_size, 1000u);
 }
 
+TEST_F(ConfigTest, LoadQueueBackend) {
+    auto path = write_config(R"(
+queue_backend = SPSC
+)");
+
+    AppConfig cfg;
+    ASSERT_TRUE(load_config(path, cfg));
+    EXPECT_EQ(cfg.queue_backend, QueueBackend::Spsc);
+
+    path = write_config("queue_backend = bogus\n");
+    ASSERT_TRUE(load_config(path, cfg));
+    EXPECT_EQ(cfg.queue_backend, QueueBackend::Spsc); // unknown value ignored
+
+    path = write_config("queue_backend = conflating\n");
+    ASSERT_TRUE(load_config(path, cfg));
+    EXPECT_EQ(cfg.queue_backend, QueueBackend::Conflating);
+}
+
+TEST_F(ConfigTest, LoadQueuePolicy) {
+    auto path = write_config(R"(
+queue_policy = Block
+queue_block_timeout_ms = 25
+queue_decimate_n = 8
+producer_batch_size = 16
+queue_spill_dir = /var/spool/telemetryhub
+queue_spill_segment_mb = 64
+queue_sojourn_target_ms = 50
+queue_sojourn_interval_ms = 0
+queue_wait_strategy = futex
+pool_wait_strategy = Spin_Then_Park
+zero_heap = Yes
+producer_cpus = 0
+consumer_cpus = 1
+pool_cpus = 2-4, 8
+pool_min_threads = 2
+pool_max_threads = 16
+pool_ordered = true
+pool_offload = Inline
+pool_offload_threshold_us = 50
+loop_model = Coroutines
+numa_local = on
+)");
+
+    AppConfig cfg;
+    ASSERT_TRUE(load_config(path, cfg));
+    EXPECT_EQ(cfg.queue_policy, BackpressurePolicy::BlockWithTimeout);
+    EXPECT_EQ(cfg.queue_block_timeout.count(), 25);
+    EXPECT_EQ(cfg.queue_decimate_n, 8u);
+    EXPECT_EQ(cfg.producer_batch_size, 16u);
+    EXPECT_EQ(cfg.queue_spill_dir, "/var/spool/telemetryhub");
+    EXPECT_EQ(cfg.queue_spill_segment_mb, 64u);
+    EXPECT_EQ(cfg.queue_sojourn_target.count(), 50);
+    EXPECT_EQ(cfg.queue_sojourn_interval.count(), 0);
+    EXPECT_EQ(cfg.queue_wait_strategy, WaitStrategy::Futex);
+    EXPECT_EQ(cfg.pool_wait_strategy, WaitStrategy::SpinThenPark);
+    EXPECT_TRUE(cfg.zero_heap);
+    EXPECT_EQ(cfg.producer_cpus, std::vector<int>{0});
+    EXPECT_EQ(cfg.consumer_cpus, std::vector<int>{1});
+    EXPECT_EQ(cfg.pool_cpus, (std::vector<int>{2, 3, 4, 8}));
+    EXPECT_EQ(cfg.pool_min_threads, 2u);
+    EXPECT_EQ(cfg.pool_max_threads, 16u);
+    EXPECT_TRUE(cfg.pool_ordered);
+    EXPECT_EQ(cfg.pool_offload, OffloadMode::Inline);
+    EXPECT_EQ(cfg.pool_offload_threshold, std::chrono::microseconds(50));
+    EXPECT_EQ(cfg.loop_model, LoopModel::Coroutines);
+    EXPECT_TRUE(cfg.numa_local);
+
+    path = write_config("queue_policy = Spill\n");
+    ASSERT_TRUE(load_config(path, cfg));
+    EXPECT_EQ(cfg.queue_policy, BackpressurePolicy::SpillToDisk);
+
+    path = write_config("queue_policy = sometimes\n");
+    ASSERT_TRUE(load_config(path, cfg));
+    EXPECT_EQ(cfg.queue_policy, BackpressurePolicy::SpillToDisk); // unknown value ignored
+}
+
 TEST_F(ConfigTest, DefaultValues) {
     AppConfig cfg;
     EXPECT_EQ(cfg.sampling_interval.count(), 100); // default
     EXPECT_EQ(cfg.queue_size, 0u); // unbounded
     EXPECT_EQ(cfg.log_level, ::telemetryhub::LogLevel::Info);
+    EXPECT_EQ(cfg.queue_backend, QueueBackend::Mutex);
+    EXPECT_EQ(cfg.queue_policy, BackpressurePolicy::DropOldest);
+    EXPECT_EQ(cfg.queue_wait_strategy, WaitStrategy::SpinThenPark);
+    EXPECT_EQ(cfg.pool_wait_strategy, WaitStrategy::Block);
+    EXPECT_FALSE(cfg.zero_heap);
+    EXPECT_TRUE(cfg.pool_cpus.empty());
+    EXPECT_EQ(cfg.pool_min_threads, 1u);
+    EXPECT_EQ(cfg.pool_max_threads, 0u);
+    EXPECT_FALSE(cfg.pool_ordered);
+    EXPECT_EQ(cfg.pool_offload, OffloadMode::Auto);
+    EXPECT_EQ(cfg.pool_offload_threshold, kDefaultOffloadThreshold);
+    EXPECT_EQ(cfg.loop_model, LoopModel::Threads);
+    EXPECT_FALSE(cfg.numa_local);
 }
@@ -0,0 +1,193 @@
+#include "telemetryhub/gateway/CoroExecutor.h"
+#include "telemetryhub/device/SerialPortSim.h"
+#include "telemetryhub/gateway/GatewayCore.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+using namespace std::chrono_literals;
+
+namespace {
+CoTask sleeper(std::chrono::milliseconds delay, char tag, std::string& order, std::set<std::thread::id>& threads)
+{
+    co_await sleep_for(delay);
+    order += tag;
+    threads.insert(std::this_thread::get_id());
+}
+
+CoTask consumer(TelemetryQueue& queue, std::atomic<size_t>& received, std::atomic<size_t>& wakeups)
+{
+    SampleBatch batch;
+    batch.reserve(64);
+    for (;;) {
+        const size_t n = co_await async_pop_batch(queue, batch, 64);
+        if (n == 0 && queue.is_shutdown()) {
+            break;
+        }
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+        received.fetch_add(n, std::memory_order_relaxed);
+        batch.clear();
+    }
+}
+
+CoTask bus_reader(telemetryhub::device::IBus& bus, std::chrono::milliseconds timeout,
+                  std::atomic<int>& result, std::string& data)
+{
+    std::vector<uint8_t> bytes;
+    const bool ok = co_await async_read(bus, bytes, 64, timeout, 1ms);
+    data.assign(bytes.begin(), bytes.end());
+    result = ok ? 1 : 0;
+}
+
+CoTask device_loop(int samples, std::atomic<int>& done)
+{
+    for (int i = 0; i < samples; ++i) {
+        co_await sleep_for(1ms);
+    }
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+}
+
+TEST(CoroExecutorTest, TimersInterleaveCoroutinesOnOneThread)
+{
+    std::string order;
+    std::set<std::thread::id> threads;
+    {
+        CoroExecutor executor(1);
+        executor.spawn(sleeper(30ms, 'c', order, threads));
+        executor.spawn(sleeper(10ms, 'a', order, threads));
+        executor.spawn(sleeper(20ms, 'b', order, threads));
+    } // waits for all three
+    EXPECT_EQ(order, "abc");
+    ASSERT_EQ(threads.size(), 1u);
+    EXPECT_NE(*threads.begin(), std::this_thread::get_id());
+}
+
+TEST(CoroExecutorTest, QueuePopSuspendsUntilPush)
+{
+    for (QueueBackend backend : {QueueBackend::Mutex, QueueBackend::Spsc}) {
+        TelemetryQueue queue;
+        queue.set_backend(backend);
+        queue.set_capacity(256);
+        AsyncSignal signal;
+        queue.set_async_signal(&signal);
+        std::atomic<size_t> received{0};
+        std::atomic<size_t> wakeups{0};
+        {
+            CoroExecutor executor(1);
+            executor.spawn(consumer(queue, received, wakeups));
+            std::this_thread::sleep_for(20ms);
+            EXPECT_EQ(wakeups.load(), 0u); // suspended, not polling
+
+            for (uint32_t i = 0; i < 100; ++i) {
+                telemetryhub::device::TelemetrySample s;
+                s.sequence_id = i;
+                queue.push(s);
+                if (i % 10 == 9) {
+                    std::this_thread::sleep_for(1ms);
+                }
+            }
+            queue.shutdown();
+        }
+        EXPECT_EQ(received.load(), 100u) << to_string(backend);
+        EXPECT_GE(wakeups.load(), 1u);
+    }
+}
+
+TEST(CoroExecutorTest, BusReadWaitsForDataOrTimesOut)
+{
+    telemetryhub::device::SerialPortSim port;
+    std::atomic<int> got{-1};
+    std::atomic<int> timed_out{-1};
+    std::string data;
+    std::string none;
+    {
+        CoroExecutor executor(1);
+        telemetryhub::device::SerialPortSim silent;
+        executor.spawn(bus_reader(port, 2s, got, data));
+        executor.spawn(bus_reader(silent, 20ms, timed_out, none));
+        std::this_thread::sleep_for(30ms);
+        port.inject_command("GET_STATUS");
+        executor.wait_idle();
+    }
+    EXPECT_EQ(got.load(), 1);
+    EXPECT_EQ(data, "GET_STATUS\n");
+    EXPECT_EQ(timed_out.load(), 0);
+    EXPECT_TRUE(none.empty());
+}
+
+TEST(CoroExecutorTest, ThousandDevicesOnTwoThreads)
+{
+    constexpr int kDevices = 1000;
+    constexpr int kSamples = 5;
+    std::atomic<int> done{0};
+    CoroExecutor executor(2);
+    for (int d = 0; d < kDevices; ++d) {
+        executor.spawn(device_loop(kSamples, done));
+    }
+    executor.wait_idle();
+    EXPECT_EQ(done.load(), kDevices);
+    const auto m = executor.get_metrics();
+    EXPECT_EQ(m.threads, 2u);
+    EXPECT_EQ(m.tasks_spawned, static_cast<uint64_t>(kDevices));
+    EXPECT_EQ(m.tasks_live, 0u);
+    // A sleep already due when awaited (slow machine) does not suspend
+    EXPECT_LE(m.timers_fired, static_cast<uint64_t>(kDevices * kSamples));
+    EXPECT_GT(m.timers_fired, 0u);
+    // The first resume of each coroutine plus one per timer
+    EXPECT_EQ(m.resumes, kDevices + m.timers_fired);
+}
+
+TEST(CoroExecutorTest, GatewayRunsBothLoopsOnOneThread)
+{
+    GatewayCore gw;
+    gw.set_loop_model(LoopModel::Coroutines);
+    gw.set_queue_capacity(256);
+    gw.set_sampling_interval(2ms);
+    gw.start();
+    std::this_thread::sleep_for(200ms);
+    auto m = gw.get_metrics();
+    EXPECT_EQ(m.loop_model, LoopModel::Coroutines);
+    EXPECT_EQ(m.loop_threads, 1u);
+    EXPECT_GT(m.loop_resumes, 0u);
+    gw.stop();
+
+    m = gw.get_metrics();
+    EXPECT_GT(m.samples_processed, 0u);
+    EXPECT_TRUE(gw.latest_sample().has_value());
+
+    GatewayCore blocking;
+    blocking.set_loop_model(LoopModel::Coroutines);
+    blocking.set_backpressure_policy(BackpressurePolicy::BlockWithTimeout);
+    EXPECT_THROW(blocking.start(), std::invalid_argument);
+}
+
+TEST(CoroExecutorTest, SingleThreadModeRunsWholePipelineOnTheLoop)
+{
+    GatewayCore gw;
+    gw.set_loop_model(LoopModel::Single);
+    gw.set_queue_capacity(256);
+    gw.set_sampling_interval(2ms);
+    gw.start();
+    std::this_thread::sleep_for(200ms);
+    auto m = gw.get_metrics();
+    EXPECT_EQ(m.loop_model, LoopModel::Single);
+    EXPECT_EQ(m.loop_threads, 1u);
+    EXPECT_EQ(m.pool_num_threads, 0u); // pool released
+    gw.stop();
+
+    m = gw.get_metrics();
+    EXPECT_GT(m.samples_processed, 0u);
+    EXPECT_EQ(m.offload_mode, OffloadMode::Inline);
+    EXPECT_GT(m.offload_inline_batches, 0u);
+    EXPECT_EQ(m.offload_pool_batches, 0u);
+    EXPECT_EQ(m.pool_jobs_processed, 0u);
+    EXPECT_EQ(gw.memory_budget().job_ring_bytes, 0u);
+}
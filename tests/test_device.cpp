@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "telemetryhub/device/Device.h"
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace telemetryhub::device;
 
@@ -83,4 +86,70 @@ TEST(DeviceTests, StartDoesNotRecoverFromSafeState)
     // In a latched fault design, SafeState should remain (no restart).
     // If implementation keeps Error first, still acceptable as "not recovered".
     EXPECT_TRUE(st_after == DeviceState::SafeState || st_after == DeviceState::Error);
-}
\ No newline at end of file
+}
+
+TEST(UnitRegistryTests, InterningIsStableAndDeduplicated)
+{
+    TelemetrySample s;
+    EXPECT_EQ(s.unit, "unitless"); // id 0
+    EXPECT_EQ(s.unit.id(), 0u);
+
+    s.unit = "mV";
+    Unit same("mV");
+    Unit other("degC");
+    EXPECT_EQ(s.unit, same);
+    EXPECT_FALSE(s.unit == other);
+    EXPECT_EQ(s.unit.str(), "mV");
+    EXPECT_EQ(Unit::from_id(s.unit.id()), s.unit);
+
+    std::ostringstream os;
+    os << s.unit;
+    EXPECT_EQ(os.str(), "mV");
+}
+
+TEST(UnitRegistryTests, SampleIsCompactAndTriviallyCopyable)
+{
+    static_assert(std::is_trivially_copyable_v<TelemetrySample>);
+    EXPECT_LE(sizeof(TelemetrySample), 32u);
+
+    Device dev;
+    dev.start();
+    auto a = dev.read_sample();
+    ASSERT_TRUE(a.has_value());
+    TelemetrySample b = *a; // plain copy keeps the unit
+    EXPECT_EQ(b.unit, "arb.units");
+}
+
+TEST(UnitRegistryTests, ConcurrentInterningAgreesOnIds)
+{
+    std::vector<std::uint16_t> ids(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); ++t) {
+        threads.emplace_back([&ids, t] {
+            for (int i = 0; i < 100; ++i) {
+                Unit("concurrent-" + std::to_string(i)); // readers and writers interleave
+            }
+            ids[t] = Unit("concurrent-42").id();
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (auto id : ids) {
+        EXPECT_EQ(id, ids[0]);
+    }
+    EXPECT_EQ(Unit::from_id(ids[0]).str(), "concurrent-42");
+}
+
+TEST(UnitRegistryTests, ReinterningNeverAddsNames)
+{
+    auto& registry = UnitRegistry::instance();
+    std::vector<std::uint16_t> ids;
+    for (size_t i = 0; i < UnitRegistry::kFastScan + 8; ++i) {
+        ids.push_back(registry.intern("reintern-" + std::to_string(i)));
+    }
+    const size_t size = registry.size();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        // Both the lock-free scan and the map lookup find the existing id
+        EXPECT_EQ(registry.intern("reintern-" + std::to_string(i)), ids[i]);
+    }
+    EXPECT_EQ(registry.size(), size);
+}
@@ -0,0 +1,282 @@
+#include "sample_factory.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/SpscRingBuffer.h"
+#include "telemetryhub/gateway/MpmcRingBuffer.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+using namespace telemetryhub::device;
+
+TEST(SpscRingBufferTest, CapacityRoundsUpToPowerOfTwo)
+{
+    SpscRingBuffer<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(99)); // full
+    EXPECT_EQ(ring.size(), 8u);
+
+    int v = -1;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(ring.try_pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.try_pop(v));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingBufferTest, WrapsAroundManyLaps)
+{
+    SpscRingBuffer<int> ring(4);
+    int v = 0;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(ring.try_push(i));
+        ASSERT_TRUE(ring.try_pop(v));
+        EXPECT_EQ(v, i);
+    }
+}
+
+TEST(LockFreeQueueTest, SpscDropsOldestWhenFull)
+{
+    TelemetryQueue q(3, QueueBackend::Spsc);
+    for (uint32_t i = 1; i <= 5; ++i) {
+        q.push(make_sample(i));
+    }
+    EXPECT_EQ(q.size(), 3u);
+
+    for (uint32_t expected = 3; expected <= 5; ++expected) {
+        auto s = q.pop();
+        ASSERT_TRUE(s.has_value());
+        EXPECT_EQ(s->sequence_id, expected);
+        EXPECT_EQ(s->unit, "test");
+    }
+}
+
+TEST(LockFreeQueueTest, SpscShutdownDrainsThenReturnsNullopt)
+{
+    TelemetryQueue q(8, QueueBackend::Spsc);
+    q.push(make_sample(1));
+    q.shutdown();
+    q.push(make_sample(2)); // rejected after shutdown
+
+    auto s = q.pop();
+    ASSERT_TRUE(s.has_value());
+    EXPECT_EQ(s->sequence_id, 1u);
+    EXPECT_FALSE(q.pop().has_value());
+}
+
+TEST(LockFreeQueueTest, SpscShutdownWakesParkedConsumer)
+{
+    TelemetryQueue q(8, QueueBackend::Spsc);
+    std::atomic<bool> returned{false};
+    std::thread consumer([&] {
+        EXPECT_FALSE(q.pop().has_value());
+        returned = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.shutdown();
+    consumer.join();
+    EXPECT_TRUE(returned.load());
+}
+
+TEST(LockFreeQueueTest, SetBackendCarriesQueuedItems)
+{
+    TelemetryQueue q(4);
+    q.push(make_sample(1));
+    q.push(make_sample(2));
+    q.set_backend(QueueBackend::Spsc);
+    EXPECT_EQ(q.backend(), QueueBackend::Spsc);
+    EXPECT_EQ(q.size(), 2u);
+
+    q.set_backend(QueueBackend::Mutex);
+    auto s = q.pop();
+    ASSERT_TRUE(s.has_value());
+    EXPECT_EQ(s->sequence_id, 1u);
+}
+
+TEST(LockFreeQueueTest, SpscConcurrentPreservesOrder)
+{
+    // Large enough that nothing is evicted, so every sample must arrive in order
+    TelemetryQueue q(1 << 16, QueueBackend::Spsc);
+    constexpr uint32_t total = 20000;
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total; ++i) {
+            q.push(make_sample(i));
+        }
+        q.shutdown();
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (auto s = q.pop()) {
+        ordered = ordered && (s->sequence_id == expected);
+        ++expected;
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(expected, total);
+}
+
+TEST(LockFreeQueueTest, SpscConcurrentWithEvictionStaysMonotonic)
+{
+    TelemetryQueue q(16, QueueBackend::Spsc);
+    constexpr uint32_t total = 50000;
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total; ++i) {
+            q.push(make_sample(i));
+        }
+        q.shutdown();
+    });
+
+    int64_t last = -1;
+    bool monotonic = true;
+    size_t consumed = 0;
+    while (auto s = q.pop()) {
+        monotonic = monotonic && (static_cast<int64_t>(s->sequence_id) > last);
+        last = s->sequence_id;
+        ++consumed;
+    }
+    producer.join();
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_GT(consumed, 0u);
+    EXPECT_LE(consumed, total);
+    EXPECT_EQ(last, static_cast<int64_t>(total - 1)); // newest sample is never dropped
+}
+
+TEST(MpmcRingBufferTest, FullAndEmpty)
+{
+    MpmcRingBuffer<int> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.try_pop(v));
+}
+
+TEST(MpmcRingBufferTest, ManyProducersManyConsumersNoLossNoDuplicates)
+{
+    MpmcRingBuffer<uint32_t> ring(1024);
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t consumers = 4;
+    constexpr uint32_t per_producer = 20000;
+
+    std::vector<std::atomic<uint8_t>> seen(producers * per_producer);
+    std::atomic<uint32_t> consumed{0};
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                uint32_t v = p * per_producer + i;
+                while (!ring.try_push(std::move(v))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (uint32_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            uint32_t v = 0;
+            while (consumed.load() < producers * per_producer) {
+                if (ring.try_pop(v)) {
+                    seen[v].fetch_add(1);
+                    consumed.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(consumed.load(), producers * per_producer);
+    bool exactly_once = true;
+    for (auto& s : seen) {
+        exactly_once = exactly_once && (s.load() == 1);
+    }
+    EXPECT_TRUE(exactly_once);
+}
+
+TEST(LockFreeQueueTest, MpmcDropsOldestWhenFull)
+{
+    TelemetryQueue q(3, QueueBackend::Mpmc);
+    for (uint32_t i = 1; i <= 5; ++i) {
+        q.push(make_sample(i));
+    }
+    for (uint32_t expected = 3; expected <= 5; ++expected) {
+        auto s = q.pop();
+        ASSERT_TRUE(s.has_value());
+        EXPECT_EQ(s->sequence_id, expected);
+    }
+}
+
+TEST(LockFreeQueueTest, MpmcMultipleProducersConsumers)
+{
+    TelemetryQueue q(1 << 16, QueueBackend::Mpmc);
+    constexpr int num_producers = 4;
+    constexpr int num_consumers = 3;
+    constexpr int per_producer = 5000;
+    std::atomic<int> consumed{0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < num_consumers; ++c) {
+        consumers.emplace_back([&] {
+            while (q.pop()) {
+                consumed++;
+            }
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                q.push(make_sample(static_cast<uint32_t>(p * per_producer + i)));
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    q.shutdown();
+    for (auto& t : consumers) t.join();
+
+    // Ring is large enough that nothing is evicted
+    EXPECT_EQ(consumed.load(), num_producers * per_producer);
+}
+
+TEST(LockFreeQueueTest, RingPushBulkPopBatch)
+{
+    for (auto backend : {QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(4, backend);
+        std::vector<TelemetrySample> burst;
+        for (uint32_t i = 1; i <= 6; ++i) {
+            burst.push_back(make_sample(i));
+        }
+        q.push_bulk(burst);
+
+        std::vector<TelemetrySample> out;
+        EXPECT_EQ(q.pop_batch(out, 3, std::chrono::milliseconds(0)), 3u);
+        EXPECT_EQ(q.pop_batch(out, 3, std::chrono::milliseconds(0)), 1u);
+        ASSERT_EQ(out.size(), 4u);
+        EXPECT_EQ(out.front().sequence_id, 3u); // 1 and 2 evicted (drop-oldest)
+        EXPECT_EQ(out.back().sequence_id, 6u);
+
+        EXPECT_EQ(q.pop_batch(out, 3, std::chrono::milliseconds(5)), 0u); // timeout
+        q.shutdown();
+        EXPECT_EQ(q.pop_batch(out, 3, std::chrono::milliseconds(1000)), 0u);
+        EXPECT_TRUE(q.is_shutdown());
+    }
+}
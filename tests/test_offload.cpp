@@ -0,0 +1,104 @@
+#include "telemetryhub/gateway/OffloadPolicy.h"
+#include "telemetryhub/gateway/GatewayCore.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace telemetryhub::gateway;
+using namespace std::chrono_literals;
+
+TEST(OffloadPolicyTest, AutoFollowsMeasuredCost)
+{
+    OffloadPolicy policy(OffloadMode::Auto, 10us);
+    EXPECT_TRUE(policy.offload(64)); // nothing measured yet
+
+    policy.record(64, 64ns, false); // 1 ns per sample
+    EXPECT_DOUBLE_EQ(policy.get_metrics().cost_ns_per_item, 1.0);
+    EXPECT_FALSE(policy.offload(64));
+    EXPECT_TRUE(policy.offload(100'000)); // 100 us at that rate
+    EXPECT_TRUE(policy.offload(64, true)); // an earlier job is still queued
+
+    // The stage gets expensive while running inline: back to the pool
+    for (int i = 0; i < 50; ++i) {
+        policy.record(64, 64us, true);
+    }
+    EXPECT_TRUE(policy.offload(64));
+
+    const auto m = policy.get_metrics();
+    EXPECT_EQ(m.inline_jobs, 50u);
+    EXPECT_EQ(m.offloaded_jobs, 1u);
+    EXPECT_NEAR(m.inline_ms, 3.2, 1e-9);
+    EXPECT_DOUBLE_EQ(m.threshold_us, 10.0);
+}
+
+TEST(OffloadPolicyTest, FixedModesIgnoreCost)
+{
+    OffloadPolicy policy(OffloadMode::Pool);
+    policy.record(1, 1ns, false);
+    EXPECT_TRUE(policy.offload(1));
+
+    policy.reset(OffloadMode::Inline, 1ns);
+    EXPECT_EQ(policy.get_metrics().cost_ns_per_item, 0.0);
+    policy.record(1, 1s, true);
+    EXPECT_FALSE(policy.offload(1'000'000));
+    EXPECT_TRUE(policy.offload(1, true));
+
+    OffloadMode mode{};
+    EXPECT_TRUE(parse_offload_mode("inline", mode));
+    EXPECT_EQ(mode, OffloadMode::Inline);
+    EXPECT_FALSE(parse_offload_mode("sometimes", mode));
+    EXPECT_STREQ(to_string(OffloadMode::Auto), "auto");
+}
+
+TEST(OffloadPolicyTest, MetricsCanBeReadDuringReset)
+{
+    OffloadPolicy policy;
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load()) {
+            const auto m = policy.get_metrics();
+            EXPECT_TRUE(m.threshold_us == 20.0 || m.threshold_us == 5.0);
+        }
+    });
+    for (int i = 0; i < 1000; ++i) {
+        policy.reset(i % 2 ? OffloadMode::Pool : OffloadMode::Inline, i % 2 ? 5us : 20us);
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(policy.mode(), OffloadMode::Pool);
+    EXPECT_EQ(policy.threshold(), 5us);
+}
+
+TEST(OffloadPolicyTest, GatewayProcessesCheapBatchesInline)
+{
+    GatewayCore gw;
+    gw.set_queue_capacity(256);
+    gw.set_producer_batch_size(4);
+    gw.set_sampling_interval(1ms);
+    gw.start();
+    std::this_thread::sleep_for(300ms);
+    gw.stop();
+
+    auto m = gw.get_metrics();
+    EXPECT_EQ(m.offload_mode, OffloadMode::Auto);
+    EXPECT_GT(m.offload_cost_ns_per_sample, 0.0);
+    // Scaling a few samples is far below 20 us: only the unmeasured first
+    // batch (and any that ran while the machine stalled) went to the pool
+    EXPECT_GT(m.offload_inline_batches, 10u);
+    EXPECT_GT(m.offload_inline_batches, m.offload_pool_batches);
+    EXPECT_GT(m.offload_inline_ms, 0.0);
+
+    GatewayCore pooled;
+    pooled.set_offload(OffloadMode::Pool);
+    pooled.set_queue_capacity(256);
+    pooled.set_sampling_interval(1ms);
+    pooled.start();
+    std::this_thread::sleep_for(100ms);
+    pooled.stop();
+
+    m = pooled.get_metrics();
+    EXPECT_EQ(m.offload_inline_batches, 0u);
+    EXPECT_GT(m.offload_pool_batches, 0u);
+    EXPECT_EQ(m.offload_pool_batches, m.pool_jobs_processed);
+}
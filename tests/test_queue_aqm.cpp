@@ -0,0 +1,177 @@
+#include "sample_factory.h"
+#include "telemetryhub/gateway/GatewayCore.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/LatencyHistogram.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+using namespace telemetryhub::device;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, EmptyReportsZero)
+{
+    LatencyHistogram h;
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.percentile(99.0), 0u);
+    EXPECT_EQ(h.summary().p50_ns, 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact)
+{
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 7; ++v) {
+        h.record(v);
+    }
+    EXPECT_EQ(h.percentile(0.0), 1u);
+    EXPECT_EQ(h.percentile(50.0), 4u);
+    EXPECT_EQ(h.percentile(100.0), 7u);
+    EXPECT_EQ(h.max(), 7u);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketError)
+{
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        h.record(v * 1000); // 1us .. 100ms
+    }
+    const auto s = h.summary();
+    EXPECT_EQ(s.count, 100000u);
+    EXPECT_NEAR(static_cast<double>(s.p50_ns), 50e6, 50e6 * 0.125);
+    EXPECT_NEAR(static_cast<double>(s.p99_ns), 99e6, 99e6 * 0.125);
+    EXPECT_LE(s.p99_ns, s.max_ns);
+    EXPECT_EQ(s.max_ns, 100000000u);
+    EXPECT_NEAR(s.mean_ns, 50.0005e6, 1.0);
+
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.max(), 0u);
+}
+
+TEST(LatencyHistogramTest, MergeMatchesRecordingIntoOne)
+{
+    LatencyHistogram a;
+    LatencyHistogram b;
+    LatencyHistogram both;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        (v % 3 ? a : b).record(v * 977);
+        both.record(v * 977);
+    }
+    LatencyHistogram merged;
+    merged.merge(a);
+    merged.merge(b);
+    const auto m = merged.summary();
+    const auto w = both.summary();
+    EXPECT_EQ(m.count, w.count);
+    EXPECT_EQ(m.p50_ns, w.p50_ns);
+    EXPECT_EQ(m.p999_ns, w.p999_ns);
+    EXPECT_EQ(m.max_ns, w.max_ns);
+    EXPECT_DOUBLE_EQ(m.mean_ns, w.mean_ns);
+}
+
+TEST(QueueAqmTest, SojournIsRecordedForDeliveredSamples)
+{
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(16, backend);
+        q.push(make_sample(1));
+        std::this_thread::sleep_for(5ms);
+        ASSERT_TRUE(q.pop().has_value());
+
+        auto m = q.get_metrics();
+        EXPECT_EQ(m.sojourn.count, 1u);
+        EXPECT_GE(m.sojourn.max_ns, 4000000u);
+        EXPECT_EQ(m.aqm_dropped, 0u); // AQM off by default
+    }
+}
+
+TEST(QueueAqmTest, HardAgeLimitDropsStaleSamples)
+{
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(16, backend);
+        q.set_sojourn_target(10ms);
+        q.set_sojourn_interval(0ms);
+        q.push(make_sample(1));
+        q.push(make_sample(2));
+        std::this_thread::sleep_for(20ms);
+        q.push(make_sample(3));
+
+        std::vector<TelemetrySample> out;
+        EXPECT_EQ(q.pop_batch(out, 8, 0ms), 1u);
+        ASSERT_EQ(out.size(), 1u);
+        EXPECT_EQ(out[0].sequence_id, 3u);
+
+        auto m = q.get_metrics();
+        EXPECT_EQ(m.aqm_dropped, 2u);
+        EXPECT_EQ(m.dropped_total(), 2u);
+        EXPECT_EQ(m.sojourn.count, 1u);
+        EXPECT_LT(m.sojourn.max_ns, 10000000u);
+    }
+}
+
+TEST(QueueAqmTest, ShortBurstAboveTargetIsNotDropped)
+{
+    TelemetryQueue q;
+    q.set_sojourn_target(5ms);
+    q.set_sojourn_interval(1s); // delay must persist for a second before dropping
+    for (uint32_t i = 1; i <= 3; ++i) {
+        q.push(make_sample(i));
+    }
+    std::this_thread::sleep_for(10ms);
+
+    for (uint32_t expected = 1; expected <= 3; ++expected) {
+        auto s = q.pop();
+        ASSERT_TRUE(s.has_value());
+        EXPECT_EQ(s->sequence_id, expected);
+    }
+    EXPECT_EQ(q.get_metrics().aqm_dropped, 0u);
+}
+
+TEST(QueueAqmTest, StandingQueueIsDroppedAfterInterval)
+{
+    TelemetryQueue q;
+    q.set_sojourn_target(5ms);
+    q.set_sojourn_interval(10ms);
+    for (uint32_t i = 1; i <= 4; ++i) {
+        q.push(make_sample(i));
+    }
+    std::this_thread::sleep_for(10ms);
+
+    // First stale sample arms the interval and is still delivered
+    auto s = q.pop();
+    ASSERT_TRUE(s.has_value());
+    EXPECT_EQ(s->sequence_id, 1u);
+
+    std::this_thread::sleep_for(15ms);
+    q.push(make_sample(5));
+    s = q.pop(); // 2..4 have been stale for longer than the interval
+    ASSERT_TRUE(s.has_value());
+    EXPECT_EQ(s->sequence_id, 5u);
+    EXPECT_EQ(q.get_metrics().aqm_dropped, 3u);
+}
+
+TEST(QueueAqmTest, ShutdownAfterAllStaleReturnsNullopt)
+{
+    TelemetryQueue q(8, QueueBackend::Spsc);
+    q.set_sojourn_target(1ms);
+    q.set_sojourn_interval(0ms);
+    q.push(make_sample(1));
+    std::this_thread::sleep_for(5ms);
+    q.shutdown();
+    EXPECT_FALSE(q.pop().has_value());
+    EXPECT_EQ(q.get_metrics().aqm_dropped, 1u);
+}
+
+TEST(QueueAqmTest, GatewayReportsQueueLatencyP99)
+{
+    GatewayCore gw;
+    gw.set_sampling_interval(1ms);
+    gw.start();
+    std::this_thread::sleep_for(100ms);
+    gw.stop();
+
+    const auto m = gw.get_metrics();
+    EXPECT_GT(m.latency_p99_ms, 0.0);
+    EXPECT_EQ(m.latency_p99_ms, m.queue_sojourn_p99_ms);
+}
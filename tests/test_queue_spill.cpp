@@ -0,0 +1,217 @@
+#include "sample_factory.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/SpillStore.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+using namespace telemetryhub::gateway;
+using namespace telemetryhub::device;
+namespace fs = std::filesystem;
+
+namespace {
+size_t files_in(const fs::path& dir)
+{
+    size_t n = 0;
+    for ([[maybe_unused]] const auto& e : fs::directory_iterator(dir)) {
+        ++n;
+    }
+    return n;
+}
+
+class SpillTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        dir_ = fs::temp_directory_path() /
+               ("telemetryhub-spill-test-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(dir_);
+    }
+    void TearDown() override { fs::remove_all(dir_); }
+
+    fs::path dir_;
+};
+}
+
+TEST_F(SpillTest, StoreRoundTripsAcrossSegments)
+{
+    {
+        SpillStore store(dir_, 4096); // 40 bytes per record: many segments
+        for (uint32_t i = 0; i < 1000; ++i) {
+            store.append(make_sample(i, i % 3, static_cast<uint16_t>(i % 5), i * 0.5), 1000 + i);
+        }
+        EXPECT_EQ(store.size(), 1000u);
+        EXPECT_GT(store.disk_bytes(), 4096u);
+        EXPECT_GT(files_in(dir_), 1u);
+
+        TelemetrySample s;
+        int64_t enqueued = 0;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            ASSERT_TRUE(store.pop(s, enqueued));
+            EXPECT_EQ(s.sequence_id, i);
+            EXPECT_EQ(s.value, static_cast<double>(i) * 0.5);
+            EXPECT_EQ(s.unit, "test");
+            EXPECT_EQ(s.device_id, i % 3);
+            EXPECT_EQ(s.channel, i % 5);
+            EXPECT_EQ(enqueued, 1000 + static_cast<int64_t>(i));
+        }
+        EXPECT_FALSE(store.pop(s, enqueued));
+        EXPECT_TRUE(store.empty());
+        EXPECT_EQ(files_in(dir_), 1u); // drained segments deleted, tail kept for reuse
+        EXPECT_EQ(store.bytes_read(), store.bytes_written());
+    }
+    EXPECT_EQ(files_in(dir_), 0u);
+}
+
+TEST_F(SpillTest, QueueSpillsOverflowAndRestoresInOrder)
+{
+    TelemetryQueue q(8);
+    q.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    q.set_spill_directory(dir_);
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(q.push(make_sample(i)));
+    }
+
+    auto m = q.get_metrics();
+    EXPECT_EQ(m.pushed, 100u);
+    EXPECT_EQ(m.spilled, 92u);
+    EXPECT_EQ(m.spill_depth, 92u);
+    EXPECT_GT(m.spill_disk_bytes, 0u);
+    EXPECT_EQ(m.depth, 8u); // memory stays bounded
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        auto s = q.try_pop();
+        ASSERT_TRUE(s.has_value());
+        EXPECT_EQ(s->sequence_id, i);
+    }
+    EXPECT_FALSE(q.try_pop().has_value());
+
+    m = q.get_metrics();
+    EXPECT_EQ(m.restored, 92u);
+    EXPECT_EQ(m.spill_depth, 0u);
+    EXPECT_EQ(m.dropped_total(), 0u);
+    EXPECT_EQ(m.spill_bytes_read, m.spill_bytes_written);
+    EXPECT_GT(m.spill_write_mb_s, 0.0);
+}
+
+TEST_F(SpillTest, PopBatchAndShutdownDrainTheSpill)
+{
+    TelemetryQueue q(4);
+    q.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    q.set_spill_directory(dir_);
+    for (uint32_t i = 0; i < 50; ++i) {
+        q.push(make_sample(i));
+    }
+    q.shutdown();
+
+    std::vector<TelemetrySample> out;
+    while (q.pop_batch(out, 16, std::chrono::milliseconds(0)) > 0) {
+    }
+    ASSERT_EQ(out.size(), 50u);
+    for (uint32_t i = 0; i < 50; ++i) {
+        EXPECT_EQ(out[i].sequence_id, i);
+    }
+}
+
+TEST_F(SpillTest, ConcurrentBurstLosesNothing)
+{
+    TelemetryQueue q(16);
+    q.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    q.set_spill_directory(dir_);
+    q.set_spill_segment_bytes(4096);
+    constexpr uint32_t total = 20000;
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total; ++i) {
+            q.push(make_sample(i));
+        }
+        q.shutdown();
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (auto s = q.pop()) {
+        ordered = ordered && (s->sequence_id == expected);
+        ++expected;
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(expected, total);
+    EXPECT_EQ(q.get_metrics().dropped_total(), 0u);
+}
+
+TEST_F(SpillTest, UnusableDirectoryFallsBackToDropNewest)
+{
+    fs::create_directories(dir_);
+    std::ofstream(dir_ / "not-a-dir") << "x";
+
+    TelemetryQueue q(2);
+    q.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    q.set_spill_directory(dir_ / "not-a-dir" / "spill");
+    EXPECT_TRUE(q.push(make_sample(1)));
+    EXPECT_TRUE(q.push(make_sample(2)));
+    EXPECT_FALSE(q.push(make_sample(3)));
+
+    const auto m = q.get_metrics();
+    EXPECT_EQ(m.dropped_newest, 1u);
+    EXPECT_EQ(m.spilled, 0u);
+    EXPECT_EQ(q.try_pop()->sequence_id, 1u);
+}
+
+#if defined(__linux__)
+TEST_F(SpillTest, SegmentThatCannotBeAllocatedDropsInsteadOfCrashing)
+{
+    // A file size limit below the segment size stands in for a full disk:
+    // the segment's blocks cannot be reserved (EFBIG rather than ENOSPC,
+    // same path). SIGXFSZ would otherwise kill the test.
+    const auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit old_limit{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    rlimit limit = old_limit;
+    limit.rlim_cur = 64 * 1024;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+    {
+        SpillStore store(dir_, 1 << 20);
+        EXPECT_THROW(store.append(make_sample(1), 1), std::runtime_error);
+    }
+
+    TelemetryQueue q(2);
+    q.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    q.set_spill_directory(dir_);
+    q.set_spill_segment_bytes(1 << 20);
+    EXPECT_TRUE(q.push(make_sample(1)));
+    EXPECT_TRUE(q.push(make_sample(2)));
+    EXPECT_FALSE(q.push(make_sample(3)));
+    EXPECT_FALSE(q.push(make_sample(4)));
+
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    std::signal(SIGXFSZ, old_handler);
+
+    const auto m = q.get_metrics();
+    EXPECT_EQ(m.dropped_newest, 2u);
+    EXPECT_EQ(m.spilled, 0u);
+    EXPECT_EQ(q.try_pop()->sequence_id, 1u);
+}
+#endif
+
+TEST_F(SpillTest, RingBackendsTreatSpillAsDropOldest)
+{
+    TelemetryQueue q(4, QueueBackend::Spsc);
+    q.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    q.set_spill_directory(dir_);
+    for (uint32_t i = 0; i < 6; ++i) {
+        q.push(make_sample(i));
+    }
+    EXPECT_EQ(q.get_metrics().dropped_oldest, 2u);
+    EXPECT_EQ(q.try_pop()->sequence_id, 2u);
+    EXPECT_FALSE(fs::exists(dir_));
+}
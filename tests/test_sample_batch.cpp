@@ -0,0 +1,142 @@
+#include "sample_factory.h"
+#include "telemetryhub/gateway/SampleBatch.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+using namespace telemetryhub::device;
+
+TEST(SampleBatchTest, RowsRoundTripThroughColumns)
+{
+    std::vector<TelemetrySample> in;
+    for (uint32_t i = 0; i < 5; ++i) {
+        in.push_back(make_sample(i, i % 2, static_cast<uint16_t>(i % 3), i * 2.0));
+    }
+    SampleBatch batch(in);
+    ASSERT_EQ(batch.size(), 5u);
+    EXPECT_EQ(batch.values()[3], 6.0);
+    EXPECT_EQ(batch.sequence_ids()[4], 4u);
+    EXPECT_EQ(batch.timestamps_ns()[2], 1002);
+    EXPECT_EQ(batch.unit_ids()[0], Unit("test").id());
+
+    std::vector<TelemetrySample> out;
+    batch.append_to(out);
+    ASSERT_EQ(out.size(), in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        EXPECT_EQ(out[i].sequence_id, in[i].sequence_id);
+        EXPECT_EQ(out[i].value, in[i].value);
+        EXPECT_EQ(out[i].unit, "test");
+        EXPECT_EQ(out[i].device_id, in[i].device_id);
+        EXPECT_EQ(out[i].channel, in[i].channel);
+        EXPECT_EQ(out[i].timestamp_ns, in[i].timestamp_ns);
+    }
+
+    batch.erase_front(2);
+    ASSERT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch.front().sequence_id, 2u);
+    EXPECT_EQ(batch.back().sequence_id, 4u);
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST(SampleBatchTest, ExtractDeviceKeepsRowOrder)
+{
+    SampleBatch batch;
+    for (uint32_t i = 0; i < 9; ++i) {
+        batch.push_back(make_sample(i, i % 3, static_cast<uint16_t>(i)));
+    }
+    SampleBatch device1;
+    EXPECT_EQ(batch.extract_device(1, device1), 3u);
+    EXPECT_EQ(batch.extract_device(7, device1), 0u);
+
+    ASSERT_EQ(device1.size(), 3u);
+    for (size_t i = 0; i < device1.size(); ++i) {
+        EXPECT_EQ(device1.device_ids()[i], 1u);
+        EXPECT_EQ(device1.sequence_ids()[i], 1u + 3u * i);
+        EXPECT_EQ(device1.channels()[i], 1u + 3u * i);
+    }
+    const uint32_t rest[] = {0, 2, 3, 5, 6, 8};
+    ASSERT_EQ(batch.size(), 6u);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(batch.sequence_ids()[i], rest[i]);
+        EXPECT_EQ(batch.values()[i], static_cast<double>(rest[i]));
+        EXPECT_EQ(batch.timestamps_ns()[i], 1000 + static_cast<int64_t>(rest[i]));
+        EXPECT_NE(batch.device_ids()[i], 1u);
+    }
+}
+
+TEST(SampleBatchTest, ValueKernelsMatchScalarLoop)
+{
+    for (size_t n : {1u, 3u, 4u, 7u, 64u, 1001u}) {
+        SampleBatch batch;
+        double sum = 0.0, lo = 1e300, hi = -1e300;
+        for (size_t i = 0; i < n; ++i) {
+            const double v = static_cast<double>((i * 7919) % 113) - 50.0;
+            batch.push_back(make_sample(static_cast<uint32_t>(i), 0, 0, v));
+            sum += v;
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+        const auto st = batch.value_stats();
+        EXPECT_EQ(st.count, n);
+        EXPECT_DOUBLE_EQ(st.sum, sum);
+        EXPECT_EQ(st.min, lo);
+        EXPECT_EQ(st.max, hi);
+
+        batch.scale_values(2.0, 1.0);
+        const auto scaled = batch.value_stats();
+        EXPECT_EQ(scaled.min, lo * 2.0 + 1.0);
+        EXPECT_EQ(scaled.max, hi * 2.0 + 1.0);
+    }
+    EXPECT_EQ(SampleBatch().value_stats().count, 0u);
+}
+
+TEST(SampleBatchTest, SliceStatsMergeToWholeColumnStats)
+{
+    SampleBatch batch;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        batch.push_back(make_sample(i, 0, 0, static_cast<double>((i * 7919) % 113) - 50.0));
+    }
+    const auto whole = batch.value_stats();
+
+    SampleBatch::ValueStats merged;
+    merged.merge(SampleBatch::ValueStats{}); // empty side is a no-op
+    for (size_t b = 0; b < batch.size(); b += 300) {
+        const size_t len = std::min<size_t>(300, batch.size() - b);
+        merged.merge(SampleBatch::value_stats(batch.values().subspan(b, len)));
+    }
+    EXPECT_EQ(merged.count, whole.count);
+    EXPECT_DOUBLE_EQ(merged.sum, whole.sum);
+    EXPECT_EQ(merged.min, whole.min);
+    EXPECT_EQ(merged.max, whole.max);
+}
+
+TEST(SampleBatchTest, QueueTransportsBatchesControlFirst)
+{
+    for (auto backend : {QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc}) {
+        TelemetryQueue q(16, backend);
+        SampleBatch in;
+        for (uint32_t i = 0; i < 6; ++i) {
+            in.push_back(make_sample(i));
+        }
+        TelemetrySample status;
+        status.kind = SampleKind::Status;
+        status.value = 3.0;
+        in.push_back(status);
+        EXPECT_EQ(q.push_bulk(in), 7u);
+
+        SampleBatch out;
+        EXPECT_EQ(q.pop_batch(out, 4, std::chrono::milliseconds(0)), 4u);
+        EXPECT_EQ(q.pop_batch(out, 8, std::chrono::milliseconds(0)), 3u);
+        ASSERT_EQ(out.size(), 7u);
+        EXPECT_EQ(out.kinds()[0], SampleKind::Status); // control lane overtakes
+        EXPECT_EQ(out.values()[0], 3.0);
+        for (uint32_t i = 0; i < 6; ++i) {
+            EXPECT_EQ(out.sequence_ids()[i + 1], i) << to_string(backend);
+        }
+        EXPECT_EQ(q.get_metrics().pushed, 7u);
+    }
+}
@@ -0,0 +1,124 @@
+#include "telemetryhub/gateway/GatewayCore.h"
+#include "telemetryhub/gateway/ThreadAffinity.h"
+#include "telemetryhub/gateway/ThreadPool.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+
+namespace {
+// A CPU this process may run on: wherever the test thread is right now
+std::vector<int> this_cpu()
+{
+    const int cpu = current_cpu();
+    return cpu >= 0 ? std::vector<int>{cpu} : std::vector<int>{};
+}
+}
+
+TEST(ThreadAffinityTest, ParsesAndFormatsCpuLists)
+{
+    std::vector<int> cpus;
+    ASSERT_TRUE(parse_cpu_list("4-6, 0,2 ,5", cpus));
+    EXPECT_EQ(cpus, (std::vector<int>{0, 2, 4, 5, 6}));
+    EXPECT_EQ(format_cpu_list(cpus), "0,2,4-6");
+
+    ASSERT_TRUE(parse_cpu_list("none", cpus));
+    EXPECT_TRUE(cpus.empty());
+    EXPECT_EQ(format_cpu_list(cpus), "");
+
+    cpus = {1};
+    EXPECT_FALSE(parse_cpu_list("3-1", cpus));
+    EXPECT_FALSE(parse_cpu_list("1,,2", cpus));
+    EXPECT_FALSE(parse_cpu_list("-1", cpus));
+    EXPECT_FALSE(parse_cpu_list("cpu0", cpus));
+    EXPECT_FALSE(parse_cpu_list("0-2000000000", cpus));
+    EXPECT_FALSE(parse_cpu_list("4096", cpus));
+    EXPECT_EQ(cpus, std::vector<int>{1}); // untouched on error
+    EXPECT_TRUE(parse_cpu_list("4095", cpus));
+    EXPECT_EQ(cpus, std::vector<int>{kMaxCpuId - 1});
+}
+
+#if defined(__linux__)
+TEST(ThreadAffinityTest, PinsAndNamesTheCallingThread)
+{
+    const auto cpus = this_cpu();
+    ASSERT_FALSE(cpus.empty());
+
+    std::thread t([&] {
+        set_current_thread_name("thub-test-thread-long-name");
+        EXPECT_EQ(current_thread_name(), "thub-test-threa"); // 15 chars max
+        ASSERT_TRUE(pin_current_thread(cpus));
+        std::this_thread::yield();
+        EXPECT_EQ(current_cpu(), cpus.front());
+        EXPECT_FALSE(pin_current_thread({1 << 20})); // beyond any CPU set
+    });
+    t.join();
+    EXPECT_TRUE(pin_current_thread({})); // no-op
+}
+
+TEST(ThreadAffinityTest, RunPinnedRunsOnTheGivenCpuAndRethrows)
+{
+    const auto cpus = this_cpu();
+    int seen = -1;
+    run_pinned(cpus, [&] { seen = current_cpu(); });
+    EXPECT_EQ(seen, cpus.front());
+    EXPECT_THROW(run_pinned(cpus, [] { throw std::runtime_error("placement failed"); }), std::runtime_error);
+}
+
+TEST(ThreadAffinityTest, PoolWorkersArePinnedAndNamed)
+{
+    const auto cpus = this_cpu();
+    ThreadPool pool(3, WaitStrategy::Block, cpus);
+    EXPECT_EQ(pool.cpus(), cpus);
+    EXPECT_EQ(pool.get_metrics().workers_pinned, 3u);
+
+    const auto name = pool.submit([] { return current_thread_name(); }).get();
+    EXPECT_EQ(name.rfind("thub-pool-", 0), 0u) << name;
+    EXPECT_EQ(pool.submit([] { return current_cpu(); }).get(), cpus.front());
+
+    ThreadPool unpinned(2);
+    EXPECT_EQ(unpinned.get_metrics().workers_pinned, 0u);
+}
+
+TEST(ThreadAffinityTest, GatewayPinsEveryRole)
+{
+    const auto cpus = this_cpu();
+    GatewayCore gw;
+    gw.set_sampling_interval(std::chrono::milliseconds(1));
+    gw.set_producer_cpus(cpus);
+    gw.set_consumer_cpus(cpus);
+    gw.set_pool_cpus(cpus);
+    gw.set_pool_threads(2, 2); // fixed, so the pinned count cannot move mid-snapshot
+    gw.set_numa_local(true);
+    gw.set_queue_backend(QueueBackend::Spsc);
+    gw.set_queue_capacity(256);
+
+    gw.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const auto running = gw.get_metrics();
+    gw.stop();
+
+    EXPECT_EQ(running.threads_pinned, running.pool_num_threads + 2);
+    EXPECT_EQ(running.pin_failures, 0u);
+    EXPECT_GT(running.samples_processed, 0u);
+    EXPECT_EQ(gw.get_metrics().threads_pinned, running.pool_num_threads); // roles exited
+}
+#endif
+
+TEST(ThreadAffinityTest, RejectedCpuSetIsCountedNotFatal)
+{
+    GatewayCore gw;
+    gw.set_sampling_interval(std::chrono::milliseconds(1));
+    gw.set_producer_cpus({1 << 20});
+    gw.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    gw.stop();
+
+    const auto m = gw.get_metrics();
+    EXPECT_EQ(m.pin_failures, 1u);
+    EXPECT_GT(m.samples_processed, 0u);
+}
@@ -0,0 +1,501 @@
+#include "telemetryhub/device/TelemetrySample.h"
+#include "telemetryhub/gateway/Task.h"
+#include "telemetryhub/gateway/ThreadPool.h"
+#include "telemetryhub/gateway/WorkStealingDeque.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+using namespace std::chrono_literals;
+
+TEST(WorkStealingDequeTest, OwnerPopsNewestThiefStealsOldest)
+{
+    WorkStealingDeque<int> dq(4);
+    EXPECT_EQ(dq.capacity(), 4u);
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(dq.push(i));
+    }
+    EXPECT_FALSE(dq.push(5)); // full: caller spills elsewhere
+    EXPECT_EQ(dq.size(), 4u);
+
+    int v = 0;
+    ASSERT_TRUE(dq.steal(v));
+    EXPECT_EQ(v, 1);
+    ASSERT_TRUE(dq.pop(v));
+    EXPECT_EQ(v, 4);
+    ASSERT_TRUE(dq.pop(v));
+    EXPECT_EQ(v, 3);
+    ASSERT_TRUE(dq.steal(v));
+    EXPECT_EQ(v, 2);
+    EXPECT_FALSE(dq.pop(v));
+    EXPECT_FALSE(dq.steal(v));
+    EXPECT_TRUE(dq.empty());
+}
+
+TEST(WorkStealingDequeTest, EveryElementTakenExactlyOnceUnderContention)
+{
+    constexpr int kItems = 200000;
+    constexpr int kThieves = 3;
+    WorkStealingDeque<int> dq(256);
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < kThieves; ++t) {
+        thieves.emplace_back([&] {
+            int v = 0;
+            while (!done.load(std::memory_order_acquire) || !dq.empty()) {
+                if (dq.steal(v)) {
+                    taken[v].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    int v = 0;
+    for (int i = 0; i < kItems; ++i) {
+        while (!dq.push(i)) {
+            if (dq.pop(v)) {
+                taken[v].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (i % 3 == 0 && dq.pop(v)) {
+            taken[v].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (dq.pop(v)) {
+        taken[v].fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : thieves) {
+        t.join();
+    }
+
+    int wrong = 0;
+    for (auto& count : taken) {
+        wrong += count.load() != 1;
+    }
+    EXPECT_EQ(wrong, 0);
+}
+
+TEST(TaskTest, StoresSampleSizedCallablesInline)
+{
+    struct SampleJob {
+        void* self;
+        telemetryhub::device::TelemetrySample sample;
+        void operator()() {}
+    };
+    struct Oversized {
+        char payload[Task::kInlineSize + 1];
+        void operator()() {}
+    };
+    static_assert(sizeof(Task) == 64);
+    static_assert(Task::fits_inline<SampleJob>());
+    static_assert(Task::fits_inline<std::packaged_task<int()>>());
+    static_assert(!Task::fits_inline<Oversized>());
+
+    int calls = 0;
+    Task big([&calls, o = Oversized{}]() mutable { (void)o; ++calls; });
+    Task moved(std::move(big));
+    EXPECT_FALSE(big);
+    ASSERT_TRUE(moved);
+    moved();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TaskTest, MoveOnlyCapturesAreDestroyedOnReset)
+{
+    auto counter = std::make_shared<int>(0);
+    std::weak_ptr<int> alive = counter;
+    Task task([p = std::make_unique<std::shared_ptr<int>>(std::move(counter))] { ++**p; });
+
+    Task other;
+    other = std::move(task);
+    other();
+    EXPECT_EQ(*alive.lock(), 1);
+    other.reset();
+    EXPECT_TRUE(alive.expired());
+    EXPECT_FALSE(other);
+}
+
+TEST(ThreadPoolTest, SubmitReturnsResults)
+{
+    ThreadPool pool(3);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.submit([](int x) { return x * 2; }, i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(futures[i].get(), i * 2);
+    }
+    const auto m = pool.get_metrics();
+    EXPECT_EQ(m.jobs_processed, 100u);
+    EXPECT_EQ(m.num_threads, 3u);
+    EXPECT_EQ(m.jobs_local, 0u); // submitted from outside the pool
+}
+
+TEST(ThreadPoolTest, PostAcceptsMoveOnlyJobs)
+{
+    ThreadPool pool(2);
+    std::promise<int> result;
+    auto value = std::make_unique<int>(7);
+    pool.post([v = std::move(value), &result] { result.set_value(*v * 6); });
+    EXPECT_EQ(result.get_future().get(), 42);
+}
+
+TEST(ThreadPoolTest, JobsSpawnedByWorkersStayLocalAndGetStolen)
+{
+    constexpr int kChildren = 100;
+    ThreadPool pool(4);
+    std::atomic<int> done{0};
+
+    pool.submit([&] {
+        for (int i = 0; i < kChildren; ++i) {
+            pool.post([&done] {
+                std::this_thread::sleep_for(100us);
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        // Keep the owner busy so idle workers have to steal
+        std::this_thread::sleep_for(20ms);
+    }).get();
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (done.load() < kChildren && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(done.load(), kChildren);
+
+    const auto m = pool.get_metrics();
+    EXPECT_EQ(m.jobs_local, static_cast<uint64_t>(kChildren));
+    EXPECT_GT(m.jobs_stolen, 0u);
+    EXPECT_GE(m.steal_attempts, m.jobs_stolen);
+    EXPECT_EQ(m.job_heap_allocations, 0u);
+}
+
+TEST(ThreadPoolTest, FullLocalDequeSpillsToInjectionQueue)
+{
+    constexpr int kChildren = static_cast<int>(ThreadPool::kJobsPerWorker) * 2;
+    std::atomic<int> done{0};
+    {
+        ThreadPool pool(1);
+        pool.post([&] {
+            for (int i = 0; i < kChildren; ++i) {
+                pool.post([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+        // Destructor drains everything, including jobs queued by jobs
+    }
+    EXPECT_EQ(done.load(), kChildren);
+}
+
+TEST(ThreadPoolTest, DestructorRunsNestedJobs)
+{
+    std::atomic<int> done{0};
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 50; ++i) {
+            pool.post([&] {
+                pool.post([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }
+    EXPECT_EQ(done.load(), 100);
+}
+
+TEST(ThreadPoolTest, SeparatesQueueWaitFromRunTime)
+{
+    ThreadPool pool(1);
+    // One slow job holds the only worker; the quick ones queue behind it
+    auto slow = pool.submit([] { std::this_thread::sleep_for(30ms); });
+    std::vector<std::future<void>> quick;
+    for (int i = 0; i < 20; ++i) {
+        quick.push_back(pool.submit([] {}));
+    }
+    slow.get();
+    for (auto& f : quick) {
+        f.get();
+    }
+    std::this_thread::sleep_for(5ms); // let the last job's metrics land
+
+    const auto m = pool.get_metrics();
+    EXPECT_EQ(m.jobs_processed, 21u);
+    EXPECT_EQ(m.queue_wait.count, 21u);
+    EXPECT_GE(m.queue_wait.p50_ns, 20'000'000u); // waited out the slow job
+    EXPECT_LT(m.run_time.p50_ns, 5'000'000u);    // but ran in no time
+    EXPECT_GE(m.run_time.max_ns, 30'000'000u);
+    EXPECT_LE(m.queue_wait.p50_ns, m.queue_wait.p999_ns);
+    EXPECT_NEAR(m.avg_processing_ms, m.run_time.mean_ns / 1e6, 1e-9);
+
+    ASSERT_EQ(m.worker_utilization.size(), 1u);
+    EXPECT_GT(m.worker_utilization[0], 0.0);
+    EXPECT_LE(m.worker_utilization[0], 1.0);
+    EXPECT_DOUBLE_EQ(m.utilization, m.worker_utilization[0]);
+}
+
+namespace {
+// Holds a one-worker pool busy until release(), so jobs queue up behind it
+struct Blocker {
+    std::promise<void> gate;
+    explicit Blocker(ThreadPool& pool)
+    {
+        std::promise<void> started;
+        auto running = started.get_future();
+        pool.post([this, &started, wait = gate.get_future().share()] {
+            started.set_value();
+            wait.wait();
+        });
+        running.wait();
+    }
+    void release() { gate.set_value(); }
+};
+}
+
+TEST(PriorityTest, TaggedJobsRunEarliestDeadlineFirst)
+{
+    ThreadPool pool(1);
+    std::vector<int> order;
+    Blocker blocker(pool);
+    const auto base = std::chrono::steady_clock::now() + 10s; // none of them urgent
+    for (int i : {3, 0, 4, 1, 2}) {
+        pool.post([&order, i] { order.push_back(i); }, JobPriority::Normal, base + i * 1ms);
+    }
+    EXPECT_EQ(pool.get_metrics().edf_queued, 5u);
+    blocker.release();
+    pool.submit([] {}).get(); // untagged: runs before the non-urgent tagged jobs
+    while (pool.get_metrics().edf_queued > 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    pool.submit(JobPriority::Low, [] {}).get();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(PriorityTest, CriticalJobsOvertakeUntaggedBacklogInBursts)
+{
+    ThreadPool pool(1);
+    std::vector<char> order; // 'u' untagged, 'c' critical
+    Blocker blocker(pool);
+    for (int i = 0; i < 3; ++i) {
+        pool.post([&order] { order.push_back('u'); });
+    }
+    for (int i = 0; i < 20; ++i) {
+        pool.post([&order] { order.push_back('c'); }, JobPriority::Critical);
+    }
+    blocker.release();
+    pool.submit(JobPriority::Low, [] {}).get(); // runs last
+
+    // kUrgentBurst critical jobs, then one untagged job gets through
+    const std::string seq(order.begin(), order.end());
+    EXPECT_EQ(seq, std::string(8, 'c') + "u" + std::string(8, 'c') + "u" + "cccc" + "u");
+    const auto m = pool.get_metrics();
+    EXPECT_EQ(m.priorities[static_cast<size_t>(JobPriority::Critical)].jobs, 20u);
+    EXPECT_EQ(m.priorities[static_cast<size_t>(JobPriority::Normal)].jobs, 4u); // 3 + the blocker
+    EXPECT_EQ(m.priorities[static_cast<size_t>(JobPriority::Low)].jobs, 1u);
+}
+
+TEST(PriorityTest, OverdueLowJobsAreNotStarved)
+{
+    ThreadPool pool(1);
+    std::vector<char> order;
+    Blocker blocker(pool);
+    for (int i = 0; i < 5; ++i) {
+        pool.post([&order] { order.push_back('u'); });
+    }
+    // Default budget: 1 s away, so it waits for the untagged backlog
+    pool.post([&order] { order.push_back('l'); }, JobPriority::Low);
+    // Already past its deadline: urgent, whatever its class (1 ms back, as
+    // mono_ns() may trail steady_clock by a few microseconds after a re-anchor)
+    pool.post([&order] { order.push_back('o'); }, JobPriority::Low, std::chrono::steady_clock::now() - 1ms);
+    blocker.release();
+    pool.submit(JobPriority::Low, [] {}).get();
+
+    EXPECT_EQ(std::string(order.begin(), order.end()), "ouuuuul");
+    const auto low = pool.get_metrics().priorities[static_cast<size_t>(JobPriority::Low)];
+    EXPECT_EQ(low.jobs, 3u);
+    EXPECT_GE(low.deadline_misses, 1u);
+    EXPECT_GT(low.queue_wait.max_ns, 0u);
+}
+
+TEST(ParallelTest, ParallelForCoversEveryIndexOnce)
+{
+    ThreadPool pool(4);
+    for (size_t grain : {0, 1, 7, 1000, 5000}) {
+        std::vector<std::atomic<int>> hits(3000);
+        pool.parallel_for(0, hits.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, grain);
+        int wrong = 0;
+        for (auto& h : hits) {
+            wrong += h.load() != 1;
+        }
+        EXPECT_EQ(wrong, 0) << "grain " << grain;
+    }
+
+    bool called = false;
+    pool.parallel_for(5, 5, [&](size_t, size_t) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(ParallelTest, ParallelReduceFoldsChunksInOrder)
+{
+    ThreadPool pool(3);
+    std::vector<double> values(100000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 0.1 * static_cast<double>(i % 97);
+    }
+    auto chunk_sum = [&](size_t b, size_t e) {
+        double s = 0.0;
+        for (size_t i = b; i < e; ++i) {
+            s += values[i];
+        }
+        return s;
+    };
+    auto plus = [](double a, double b) { return a + b; };
+
+    // Same grain -> bit-identical result, however the chunks were scheduled
+    const double first = pool.parallel_reduce(size_t{0}, values.size(), 0.0, chunk_sum, plus, 1024);
+    for (int run = 0; run < 5; ++run) {
+        EXPECT_EQ(pool.parallel_reduce(size_t{0}, values.size(), 0.0, chunk_sum, plus, 1024), first);
+    }
+    EXPECT_NEAR(first, chunk_sum(0, values.size()), 1e-6);
+
+    // Order is preserved for non-commutative folds too
+    const auto digits = pool.parallel_reduce(size_t{0}, size_t{10}, std::string{},
+        [](size_t b, size_t) { return std::to_string(b); },
+        [](std::string acc, std::string part) { return acc + part; }, 1);
+    EXPECT_EQ(digits, "0123456789");
+}
+
+TEST(ParallelTest, NestedInsidePoolJobDoesNotDeadlock)
+{
+    ThreadPool pool(1); // the only worker is the caller
+    std::atomic<size_t> total{0};
+    pool.submit([&] {
+        pool.parallel_for(0, 1000, [&](size_t b, size_t e) {
+            total.fetch_add(e - b, std::memory_order_relaxed);
+        }, 10);
+    }).get();
+    EXPECT_EQ(total.load(), 1000u);
+}
+
+TEST(ParallelTest, FirstExceptionIsRethrown)
+{
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.parallel_for(0, 1000, [&](size_t b, size_t) {
+        if (b % 100 == 0) {
+            throw std::runtime_error("bad chunk");
+        }
+    }, 1), std::runtime_error);
+
+    // Pool still usable afterwards
+    EXPECT_EQ(pool.submit([] { return 1; }).get(), 1);
+}
+
+namespace {
+// Polls until pred() holds or the timeout passes
+template <typename Pred>
+bool eventually(Pred pred, std::chrono::milliseconds timeout = 3s)
+{
+    const auto until = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > until) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+ThreadPool::ElasticConfig fast_elastic(size_t min_threads, size_t max_threads)
+{
+    ThreadPool::ElasticConfig cfg;
+    cfg.min_threads = min_threads;
+    cfg.max_threads = max_threads;
+    cfg.interval = 5ms;
+    cfg.shrink_ticks = 4;
+    return cfg;
+}
+}
+
+TEST(ElasticPoolTest, BoundsAreResolved)
+{
+    ThreadPool::ElasticConfig cfg;
+    cfg.min_threads = 8;
+    cfg.max_threads = 3;
+    EXPECT_EQ(cfg.resolved().min_threads, 3u);
+    cfg.min_threads = 0;
+    EXPECT_EQ(cfg.resolved().min_threads, 1u);
+    cfg.max_threads = 0;
+    EXPECT_GE(cfg.resolved().max_threads, 1u);
+
+    ThreadPool fixed(2);
+    const auto m = fixed.get_metrics();
+    EXPECT_EQ(m.min_threads, 2u);
+    EXPECT_EQ(m.max_threads, 2u);
+    EXPECT_EQ(m.workers_started, 0u);
+}
+
+TEST(ElasticPoolTest, GrowsUnderBacklogAndShrinksWhenIdle)
+{
+    ThreadPool pool(fast_elastic(1, 3));
+    EXPECT_EQ(pool.thread_count(), 1u);
+
+    std::atomic<int> done{0};
+    for (int i = 0; i < 200; ++i) {
+        pool.post([&done] {
+            std::this_thread::sleep_for(2ms);
+            done.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    EXPECT_TRUE(eventually([&] { return pool.thread_count() == 3; }));
+    EXPECT_TRUE(eventually([&] { return done.load() == 200; }));
+
+    // Idle for shrink_ticks in a row: back down to min, one worker at a time
+    EXPECT_TRUE(eventually([&] { return pool.thread_count() == 1; }));
+    const auto m = pool.get_metrics();
+    EXPECT_EQ(m.workers_started, 2u);
+    EXPECT_EQ(m.workers_retired, 2u);
+    EXPECT_EQ(m.num_threads, 1u);
+    EXPECT_EQ(m.worker_utilization.size(), 3u); // every slot that ever ran
+    EXPECT_EQ(m.jobs_processed, 200u);
+}
+
+TEST(ElasticPoolTest, ResizingLosesNoJobs)
+{
+    auto cfg = fast_elastic(1, 4);
+    cfg.interval = 1ms;
+    cfg.grow_ticks = 1;
+    cfg.shrink_ticks = 1;
+    ThreadPool pool(cfg);
+
+    // Bursts of fan-out from inside a job (local deques) separated by lulls,
+    // so workers are started and retired while their deques hold jobs
+    std::atomic<int> done{0};
+    for (int burst = 0; burst < 30; ++burst) {
+        pool.submit([&] {
+            for (int i = 0; i < 20; ++i) {
+                pool.post([&done] {
+                    std::this_thread::sleep_for(100us);
+                    done.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        }).get();
+        ASSERT_TRUE(eventually([&] { return done.load() == 20 * (burst + 1); })) << "burst " << burst;
+        std::this_thread::sleep_for(3ms);
+    }
+    const auto m = pool.get_metrics();
+    EXPECT_GT(m.workers_started, 0u);
+    EXPECT_EQ(m.jobs_queued, 0u);
+    EXPECT_LE(m.num_threads, 4u);
+    EXPECT_GE(m.num_threads, 1u);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "telemetryhub/device/Timestamp.h"
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::device;
+
+TEST(TimestampTests, MonoTracksSteadyClock)
+{
+    // Same epoch as steady_clock, so the two must bracket each other
+    for (int i = 0; i < 100; ++i) {
+        const int64_t before = detail::steady_ns();
+        const int64_t mono = mono_ns();
+        const int64_t after = detail::steady_ns();
+        EXPECT_GE(mono, before - 1'000'000) << to_string(timestamp_source());
+        EXPECT_LE(mono, after + 1'000'000) << to_string(timestamp_source());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+TEST(TimestampTests, WallTracksSystemClock)
+{
+    const int64_t sys = detail::system_ns();
+    const int64_t wall = wall_ns();
+    EXPECT_LT(std::llabs(wall - sys), 5'000'000); // a few ms at most
+
+    const auto tp = to_system_time(wall);
+    EXPECT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count(),
+              wall / 1000);
+}
+
+TEST(TimestampTests, MonotonicPerThreadAcrossReanchors)
+{
+    // Runs past at least one re-anchor (about once a second)
+    std::vector<std::thread> threads;
+    std::vector<int> regressions(4, 0);
+    for (size_t t = 0; t < regressions.size(); ++t) {
+        threads.emplace_back([&regressions, t] {
+            const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1200);
+            int64_t last = mono_ns();
+            while (std::chrono::steady_clock::now() < end) {
+                const int64_t now = mono_ns();
+                regressions[t] += now < last ? 1 : 0;
+                last = now;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int r : regressions) {
+        EXPECT_EQ(r, 0);
+    }
+}
+
+TEST(TimestampTests, SourceIsReported)
+{
+    const auto source = timestamp_source();
+    EXPECT_TRUE(source == TimestampSource::Tsc || source == TimestampSource::SteadyClock);
+    EXPECT_STRNE(to_string(source), "unknown");
+}
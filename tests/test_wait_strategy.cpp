@@ -0,0 +1,141 @@
+#include "sample_factory.h"
+#include "telemetryhub/gateway/WaitStrategy.h"
+#include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/ThreadPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace telemetryhub::gateway;
+using namespace telemetryhub::device;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr WaitStrategy kAllStrategies[] = {
+    WaitStrategy::Block, WaitStrategy::Spin, WaitStrategy::SpinThenPark, WaitStrategy::Futex};
+constexpr QueueBackend kAllBackends[] = {
+    QueueBackend::Mutex, QueueBackend::Spsc, QueueBackend::Mpmc, QueueBackend::Conflating};
+}
+
+TEST(WaitStrategyTest, ParseRoundTrips)
+{
+    for (auto s : kAllStrategies) {
+        WaitStrategy parsed = WaitStrategy::Block;
+        ASSERT_TRUE(parse_wait_strategy(to_string(s), parsed));
+        EXPECT_EQ(parsed, s);
+    }
+    WaitStrategy out = WaitStrategy::Spin;
+    EXPECT_FALSE(parse_wait_strategy("sleepy", out));
+    EXPECT_EQ(out, WaitStrategy::Spin);
+}
+
+TEST(WaitStrategyTest, FutexEventTimesOutAndWakes)
+{
+    FutexEvent ev;
+    const auto deadline = std::chrono::steady_clock::now() + 10ms;
+    ev.wait(ev.prepare_wait(), &deadline);
+    EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+
+    std::atomic<bool> flag{false};
+    std::thread waiter([&] {
+        while (!flag.load()) {
+            const uint32_t epoch = ev.prepare_wait();
+            if (flag.load()) {
+                ev.cancel_wait();
+                break;
+            }
+            ev.wait(epoch, nullptr);
+        }
+    });
+    std::this_thread::sleep_for(10ms);
+    flag = true;
+    ev.notify_all();
+    waiter.join();
+}
+
+TEST(WaitStrategyTest, QueueHandoffLosesNothing)
+{
+    for (auto backend : kAllBackends) {
+        for (auto wait : kAllStrategies) {
+            TelemetryQueue q(1 << 12, backend);
+            q.set_wait_strategy(wait);
+            constexpr uint32_t total = 3000;
+
+            std::thread producer([&] {
+                // Distinct device ids, so the conflating backend keeps all of them
+                for (uint32_t i = 0; i < total; ++i) {
+                    q.push(make_sample(i, i));
+                    if (i % 500 == 0) {
+                        std::this_thread::sleep_for(1ms); // let the consumer go idle
+                    }
+                }
+                q.shutdown();
+            });
+            uint32_t consumed = 0;
+            while (q.pop()) {
+                ++consumed;
+            }
+            producer.join();
+            EXPECT_EQ(consumed, total) << to_string(backend) << "/" << to_string(wait);
+        }
+    }
+}
+
+TEST(WaitStrategyTest, TimedTryPop)
+{
+    for (auto backend : kAllBackends) {
+        for (auto wait : kAllStrategies) {
+            TelemetryQueue q(16, backend);
+            q.set_wait_strategy(wait);
+            EXPECT_FALSE(q.try_pop().has_value());
+
+            const auto start = std::chrono::steady_clock::now();
+            EXPECT_FALSE(q.try_pop_for(10ms).has_value());
+            EXPECT_GE(std::chrono::steady_clock::now() - start, 10ms);
+
+            q.push(make_sample(7));
+            auto s = q.try_pop_for(1s);
+            ASSERT_TRUE(s.has_value());
+            EXPECT_EQ(s->sequence_id, 7u);
+        }
+    }
+}
+
+TEST(WaitStrategyTest, ShutdownWakesParkedConsumer)
+{
+    for (auto backend : kAllBackends) {
+        for (auto wait : kAllStrategies) {
+            TelemetryQueue q(16, backend);
+            q.set_wait_strategy(wait);
+            std::thread consumer([&] { EXPECT_FALSE(q.pop().has_value()); });
+            std::this_thread::sleep_for(5ms);
+            q.shutdown();
+            consumer.join();
+        }
+    }
+}
+
+TEST(WaitStrategyTest, ThreadPoolRunsAllJobs)
+{
+    for (auto wait : kAllStrategies) {
+        std::atomic<int> done{0};
+        {
+            ThreadPool pool(2, wait);
+            std::vector<std::future<void>> futures;
+            for (int i = 0; i < 200; ++i) {
+                futures.push_back(pool.submit([&done] { done++; }));
+                if (i % 50 == 0) {
+                    std::this_thread::sleep_for(1ms); // workers go idle and park
+                }
+            }
+            for (auto& f : futures) {
+                f.get();
+            }
+            pool.set_wait_strategy(WaitStrategy::Block);
+            pool.submit([&done] { done++; }).get();
+        }
+        EXPECT_EQ(done.load(), 201) << to_string(wait);
+    }
+}
@@ -0,0 +1,230 @@
+#include "telemetryhub/gateway/GatewayCore.h"
+#include "telemetryhub/gateway/HeapGuard.h"
+#include "telemetryhub/gateway/Log.h"
+#include "telemetryhub/gateway/ThreadPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Linked with heap_guard_hook, so HeapGuard sees every operator new.
+using namespace telemetryhub::gateway;
+
+TEST(HeapGuardTest, CountsViolationsOnlyOnGuardedThreads)
+{
+    const auto before = HeapGuard::get_metrics();
+    ASSERT_TRUE(before.hook_installed);
+
+    auto unguarded = std::make_unique<int>(1);
+    {
+        HeapGuard::ThreadScope guard;
+        EXPECT_TRUE(HeapGuard::thread_guarded());
+        auto violation = std::make_unique<int>(2);
+        {
+            HeapGuard::Exempt io;
+            EXPECT_FALSE(HeapGuard::thread_guarded());
+            auto allowed = std::make_unique<int>(3);
+        }
+        std::thread other([] { auto elsewhere = std::make_unique<int>(4); }); // creating it allocates too
+        other.join();
+    }
+    HeapGuard::ThreadScope disabled(false);
+    auto after_scope = std::make_unique<int>(5);
+
+    const auto after = HeapGuard::get_metrics();
+    EXPECT_GE(after.allocations - before.allocations, 5u);
+    EXPECT_GE(after.violations - before.violations, 2u); // make_unique<int>(2) + std::thread state
+    EXPECT_EQ(after.exempt - before.exempt, 1u);
+}
+
+TEST(HeapGuardTest, ZeroSizeOverAlignedNewSucceeds)
+{
+    struct alignas(64) Line {
+        char bytes[64];
+    };
+    Line* empty = nullptr;
+    ASSERT_NO_THROW(empty = new Line[0]);
+    ASSERT_NE(empty, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(empty) % 64, 0u);
+    delete[] empty;
+
+    void* raw = ::operator new(0, std::align_val_t{128});
+    EXPECT_NE(raw, nullptr);
+    ::operator delete(raw, std::align_val_t{128});
+}
+
+TEST(HeapGuardTest, LogfFormatsWithoutAllocating)
+{
+    telemetryhub::Logger::instance().logf(telemetryhub::LogLevel::Info, "test", "warm-up %d", 0);
+    const auto before = HeapGuard::get_metrics();
+    {
+        HeapGuard::ThreadScope guard;
+        TELEMETRYHUB_LOGIF("test", "batch of %zu sample(s), mean=%f, unit=%s", size_t{64}, 42.5, "V");
+        // Filtered out: not even formatted
+        TELEMETRYHUB_LOGF(telemetryhub::LogLevel::Trace, "test", "%s", "invisible");
+    }
+    EXPECT_EQ(HeapGuard::get_metrics().violations, before.violations);
+}
+
+TEST(HeapGuardTest, ThreadPoolPostIsAllocationFreeAfterReserve)
+{
+    ThreadPool pool(2);
+    pool.reserve(64);
+    std::atomic<int> done{0};
+    telemetryhub::device::TelemetrySample sample{};
+    auto post_round = [&] {
+        const int target = done.load() + 64;
+        for (int i = 0; i < 32; ++i) {
+            pool.post([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            // Sample-sized captures fit Task's inline buffer too
+            pool.post([&done, sample] { done.fetch_add(sample.value > 0 ? 2 : 1, std::memory_order_relaxed); });
+        }
+        while (done.load() < target) {
+            std::this_thread::yield();
+        }
+    };
+    post_round(); // warm-up
+
+    const auto before = HeapGuard::get_metrics();
+    {
+        HeapGuard::ThreadScope guard;
+        for (int round = 0; round < 50; ++round) {
+            post_round();
+        }
+    }
+    EXPECT_EQ(HeapGuard::get_metrics().violations - before.violations, 0u);
+    EXPECT_EQ(done.load(), 51 * 64);
+}
+
+TEST(ZeroHeapGatewayTest, SteadyStateRunHasNoViolations)
+{
+    GatewayCore gw;
+    gw.set_zero_heap(true);
+    gw.set_queue_capacity(256);
+    gw.set_producer_batch_size(4);
+    gw.set_sampling_interval(std::chrono::milliseconds(1));
+
+    const auto before = HeapGuard::get_metrics();
+    gw.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    gw.stop();
+
+    const auto m = gw.get_metrics();
+    EXPECT_TRUE(m.zero_heap);
+    EXPECT_TRUE(m.heap_hook_installed);
+    EXPECT_GT(m.samples_processed, 20u);
+    EXPECT_EQ(m.heap_violations - before.violations, 0u);
+    EXPECT_EQ(m.batch_pool_heap_allocations, 0u);
+    EXPECT_EQ(m.memory_budget_bytes, gw.memory_budget().total());
+}
+
+TEST(ZeroHeapGatewayTest, OrderedProcessingStaysOffTheHeap)
+{
+    GatewayCore gw;
+    gw.set_zero_heap(true);
+    gw.set_ordered_processing(true);
+    gw.set_offload(OffloadMode::Pool); // exercise the strands, not inline processing
+    gw.set_queue_capacity(256);
+    gw.set_producer_batch_size(4);
+    gw.set_sampling_interval(std::chrono::milliseconds(1));
+
+    const auto before = HeapGuard::get_metrics();
+    gw.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    gw.stop();
+
+    const auto m = gw.get_metrics();
+    EXPECT_GT(m.strand_jobs, 0u);
+    EXPECT_GE(m.strand_drains, 1u);
+    EXPECT_EQ(m.heap_violations - before.violations, 0u);
+    EXPECT_EQ(m.batch_pool_heap_allocations, 0u);
+
+    GatewayCore unordered;
+    EXPECT_GT(gw.memory_budget().job_ring_bytes, unordered.memory_budget().job_ring_bytes);
+}
+
+TEST(ZeroHeapGatewayTest, CoroutineLoopsStayOffTheHeap)
+{
+    GatewayCore gw;
+    gw.set_zero_heap(true);
+    gw.set_loop_model(LoopModel::Coroutines);
+    gw.set_queue_capacity(256);
+    gw.set_producer_batch_size(4);
+    gw.set_sampling_interval(std::chrono::milliseconds(1));
+
+    const auto before = HeapGuard::get_metrics();
+    gw.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_GT(gw.get_metrics().loop_resumes, 0u);
+    gw.stop();
+
+    const auto m = gw.get_metrics();
+    EXPECT_GT(m.samples_processed, 0u);
+    EXPECT_EQ(m.heap_violations - before.violations, 0u);
+}
+
+TEST(ZeroHeapGatewayTest, RejectsConfigurationsThatCannotPreallocate)
+{
+    GatewayCore unbounded;
+    unbounded.set_zero_heap(true);
+    EXPECT_THROW(unbounded.start(), std::invalid_argument);
+
+    GatewayCore conflating;
+    conflating.set_zero_heap(true);
+    conflating.set_queue_capacity(64);
+    conflating.set_queue_backend(QueueBackend::Conflating);
+    EXPECT_THROW(conflating.start(), std::invalid_argument);
+
+    GatewayCore spill;
+    spill.set_zero_heap(true);
+    spill.set_queue_capacity(64);
+    spill.set_backpressure_policy(BackpressurePolicy::SpillToDisk);
+    EXPECT_THROW(spill.start(), std::invalid_argument);
+}
+
+TEST(ZeroHeapGatewayTest, MemoryBudgetFollowsConfiguration)
+{
+    GatewayCore gw;
+    gw.set_queue_capacity(1000); // rounded up to 1024 slots
+    gw.set_producer_batch_size(8);
+    const auto small = gw.memory_budget();
+    EXPECT_EQ(small.queue_bytes, TelemetryQueue::storage_bytes(QueueBackend::Mutex, 1024));
+    EXPECT_EQ(small.producer_bytes, 2 * 8 * SampleBatch::bytes_per_row());
+    EXPECT_GT(small.batch_pool_bytes, 0u);
+
+    gw.set_queue_capacity(4096);
+    EXPECT_EQ(gw.memory_budget().queue_bytes, 4 * small.queue_bytes);
+
+    gw.set_queue_backend(QueueBackend::Spsc);
+    EXPECT_GT(gw.memory_budget().queue_bytes, 4 * small.queue_bytes); // + sequence number per slot
+}
+
+TEST(ZeroHeapGatewayTest, JobStorageCoversEveryPoolSlot)
+{
+    // The pool's storage is sized for max_threads up front, so growing under
+    // load never allocates job nodes or deques
+    ThreadPool::ElasticConfig one_to_four;
+    one_to_four.min_threads = 1;
+    one_to_four.max_threads = 4;
+    ThreadPool elastic(one_to_four);
+    ThreadPool fixed(4);
+    EXPECT_EQ(elastic.thread_count(), 1u);
+    EXPECT_EQ(elastic.storage_bytes(16), fixed.storage_bytes(16));
+
+    GatewayCore gw;
+    gw.set_pool_threads(1, 4);
+    gw.set_queue_capacity(256);
+    gw.set_sampling_interval(std::chrono::milliseconds(1));
+    gw.start();
+    const auto m = gw.get_metrics();
+    gw.stop();
+    EXPECT_EQ(m.pool_min_threads, 1u);
+    EXPECT_EQ(m.pool_max_threads, 4u);
+    EXPECT_GE(m.pool_num_threads, 1u);
+    EXPECT_EQ(gw.memory_budget().job_ring_bytes, fixed.storage_bytes(16));
+}
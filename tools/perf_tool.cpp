@@ -1,13 +1,55 @@
+#include "telemetryhub/gateway/CoroExecutor.h"
+#include "telemetryhub/gateway/GatewayCore.h"
+#include "telemetryhub/gateway/HeapGuard.h"
+#include "telemetryhub/gateway/LatencyHistogram.h"
+#include "telemetryhub/gateway/Log.h"
+#include "telemetryhub/gateway/OffloadPolicy.h"
+#include "telemetryhub/gateway/SampleBatch.h"
+#include "telemetryhub/gateway/Strand.h"
 #include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/ThreadPool.h"
 #include "telemetryhub/device/TelemetrySample.h"
+#include "telemetryhub/device/Timestamp.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
 #include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#if defined(__unix__)
+#include <sys/resource.h>
+#endif
+
+using telemetryhub::gateway::CoTask;
+using telemetryhub::gateway::CoroExecutor;
+using telemetryhub::gateway::GatewayCore;
+using telemetryhub::gateway::HeapGuard;
+using telemetryhub::gateway::JobPriority;
+using telemetryhub::gateway::LatencyHistogram;
+using telemetryhub::gateway::LoopModel;
+using telemetryhub::gateway::OffloadMode;
+using telemetryhub::gateway::OffloadPolicy;
+using telemetryhub::gateway::QueueBackend;
+using telemetryhub::gateway::SampleBatch;
+using telemetryhub::gateway::StrandPool;
 using telemetryhub::gateway::TelemetryQueue;
+using telemetryhub::gateway::ThreadPool;
+using telemetryhub::gateway::WaitStrategy;
 using telemetryhub::device::TelemetrySample;
+using telemetryhub::device::Unit;
 
 namespace chrono = std::chrono;
 
@@ -15,16 +57,24 @@ struct Stats {
     double seconds{};
     std::size_t ops{};
     double ops_per_sec{};
+    std::size_t consumed{};
 };
 
-Stats run_test_move(std::size_t n)
+// Ring backends are bounded (drop-oldest); size the ring so a short consumer
+// stall does not turn the run into a drop benchmark.
+constexpr std::size_t kRingCapacity = 1 << 16;
+
+// Interned once; assigning the string in the loop would time the registry
+const Unit kPerfUnit{"perf"};
+
+Stats run_test_move(std::size_t n, QueueBackend backend = QueueBackend::Mutex)
 {
-    TelemetryQueue q;
+    TelemetryQueue q(backend == QueueBackend::Mutex ? 0 : kRingCapacity, backend);
+    std::size_t consumed = 0;
 
     auto start = chrono::steady_clock::now();
 
     std::thread consumer([&]() {
-        std::size_t consumed = 0;
         while (consumed < n) {
             auto s = q.pop();
             if (!s) break;
@@ -36,7 +86,7 @@ Stats run_test_move(std::size_t n)
         TelemetrySample s{};
         s.sequence_id = static_cast<std::uint32_t>(i);
         s.value = 123.0 + static_cast<double>(i % 100);
-        s.unit = "perf";
+        s.unit = kPerfUnit;
         q.push(std::move(s));
     }
     q.shutdown();
@@ -45,7 +95,7 @@ Stats run_test_move(std::size_t n)
 
     auto end = chrono::steady_clock::now();
     double secs = chrono::duration<double>(end - start).count();
-    return Stats{secs, n, n / secs};
+    return Stats{secs, n, n / secs, consumed};
 }
 
 Stats run_test_copy(std::size_t n)
@@ -64,7 +114,7 @@ Stats run_test_copy(std::size_t n)
     });
 
     TelemetrySample s{};
-    s.unit = "perf";
+    s.unit = kPerfUnit;
     for (std::size_t i = 0; i < n; ++i) {
         s.sequence_id = static_cast<std::uint32_t>(i);
         s.value = 123.0 + static_cast<double>(i % 100);
@@ -79,6 +129,682 @@ Stats run_test_copy(std::size_t n)
     return Stats{secs, n, n / secs};
 }
 
+// Copy vs move of the sample itself, without the queue in the way: the cost a
+// queue hop, `latest_ = sample` or a pool submit pays per sample. Returns ns/sample.
+double time_sample_transfer(std::size_t n, bool move)
+{
+    std::vector<TelemetrySample> src(n);
+    std::vector<TelemetrySample> dst(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        src[i].sequence_id = static_cast<std::uint32_t>(i);
+        src[i].unit = kPerfUnit;
+    }
+    auto start = chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = move ? std::move(src[i]) : src[i];
+    }
+    auto end = chrono::steady_clock::now();
+    volatile std::uint32_t sink = dst[n / 2].sequence_id; // keep the loop
+    (void)sink;
+    return chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(n);
+}
+
+// push_bulk()/pop_batch() with `batch` samples per call on each side
+Stats run_test_batch(std::size_t n, std::size_t batch, QueueBackend backend = QueueBackend::Mutex)
+{
+    TelemetryQueue q(backend == QueueBackend::Mutex ? 0 : kRingCapacity, backend);
+    std::size_t consumed = 0;
+
+    std::vector<TelemetrySample> chunk(batch);
+    for (auto& s : chunk) {
+        s.unit = kPerfUnit;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    std::thread consumer([&]() {
+        std::vector<TelemetrySample> out;
+        out.reserve(batch);
+        while (consumed < n) {
+            out.clear();
+            auto got = q.pop_batch(out, batch, chrono::milliseconds(100));
+            if (got == 0 && q.is_shutdown()) break;
+            consumed += got;
+        }
+    });
+
+    for (std::size_t i = 0; i < n; i += batch) {
+        const std::size_t len = std::min(batch, n - i);
+        for (std::size_t j = 0; j < len; ++j) {
+            chunk[j].sequence_id = static_cast<std::uint32_t>(i + j);
+            chunk[j].value = 123.0 + static_cast<double>((i + j) % 100);
+        }
+        q.push_bulk(std::span<const TelemetrySample>(chunk.data(), len));
+    }
+    q.shutdown();
+
+    consumer.join();
+
+    auto end = chrono::steady_clock::now();
+    double secs = chrono::duration<double>(end - start).count();
+    return Stats{secs, n, n / secs, consumed};
+}
+
+struct WaitStats {
+    double p50_us{};
+    double p99_us{};
+    double cpu_percent{}; // process CPU time / wall time (100% = one core)
+};
+
+// Handoff latency when the consumer is idle between samples: the producer
+// pushes one sample every `gap`, so each pop() has to wake up. Latency is the
+// queue's own enqueue->dequeue sojourn.
+WaitStats run_wait_latency(std::size_t samples, WaitStrategy wait, QueueBackend backend,
+                           chrono::microseconds gap = chrono::microseconds(50))
+{
+    TelemetryQueue q(kRingCapacity, backend);
+    q.set_wait_strategy(wait);
+
+    const auto wall_start = chrono::steady_clock::now();
+    const std::clock_t cpu_start = std::clock();
+
+    std::thread consumer([&]() {
+        while (q.pop()) {
+        }
+    });
+    for (std::size_t i = 0; i < samples; ++i) {
+        const auto next = chrono::steady_clock::now() + gap;
+        TelemetrySample s{};
+        s.sequence_id = static_cast<std::uint32_t>(i);
+        q.push(std::move(s));
+        std::this_thread::sleep_until(next);
+    }
+    q.shutdown();
+    consumer.join();
+
+    const double wall = chrono::duration<double>(chrono::steady_clock::now() - wall_start).count();
+    const double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    const auto sojourn = q.get_metrics().sojourn;
+    return WaitStats{sojourn.p50_ns / 1e3, sojourn.p99_ns / 1e3, 100.0 * cpu / wall};
+}
+
+// Calibrate + sum/min/max over n samples, as the pool's batch job does:
+// row by row over TelemetrySample (AoS) vs over SampleBatch columns (SoA).
+// Returns ns/sample for each layout.
+std::pair<double, double> time_batch_stats(std::size_t n)
+{
+    std::vector<TelemetrySample> rows(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        rows[i].sequence_id = static_cast<std::uint32_t>(i);
+        rows[i].value = static_cast<double>(i % 1000);
+    }
+    SampleBatch batch(rows);
+
+    auto start = chrono::steady_clock::now();
+    double sum = 0.0, lo = rows[0].value * 1.5, hi = lo;
+    for (auto& s : rows) {
+        s.value *= 1.5;
+        sum += s.value;
+        lo = std::min(lo, s.value);
+        hi = std::max(hi, s.value);
+    }
+    const double aos = chrono::duration<double, std::nano>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    batch.scale_values(1.5);
+    const auto st = batch.value_stats();
+    const double soa = chrono::duration<double, std::nano>(chrono::steady_clock::now() - start).count();
+
+    volatile double keep = sum + lo + hi + st.sum + st.min + st.max;
+    (void)keep;
+    return {aos / static_cast<double>(n), soa / static_cast<double>(n)};
+}
+
+// Average cost of one clock read in ns; `read` returns something to sum so
+// the calls cannot be optimized away.
+template <typename Read>
+double time_clock_read(std::size_t n, Read read)
+{
+    std::int64_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        sink += read();
+    }
+    auto end = chrono::steady_clock::now();
+    volatile std::int64_t keep = sink;
+    (void)keep;
+    return chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(n);
+}
+
+// A few hundred ns of arithmetic: the size of a small derived-metric job
+void burn_job()
+{
+    volatile double x = 1.0;
+    for (int i = 0; i < 100; ++i) {
+        x = x * 1.000001 + 0.5;
+    }
+}
+
+// Runs `count` jobs: this one, plus halves handed back to the pool until
+// each piece is a single job (recursive fan-out, as a batch split would)
+void split_job(ThreadPool& pool, std::atomic<std::size_t>& done, std::size_t count)
+{
+    while (count > 1) {
+        const std::size_t half = count / 2;
+        pool.post([&pool, &done, half] { split_job(pool, done, half); });
+        count -= half;
+    }
+    burn_job();
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct PoolStats {
+    double jobs_per_sec{};
+    ThreadPool::Metrics metrics{};
+};
+
+// `jobs` small jobs through a pool of `threads` workers, either posted one by
+// one from this thread (injection queue) or fanned out from one root job
+// (worker-local deques + stealing)
+PoolStats run_pool_scaling(std::size_t jobs, std::size_t threads, bool fan_out)
+{
+    ThreadPool pool(threads);
+    std::atomic<std::size_t> done{0};
+
+    auto start = chrono::steady_clock::now();
+    if (fan_out) {
+        pool.post([&pool, &done, jobs] { split_job(pool, done, jobs); });
+    } else {
+        for (std::size_t i = 0; i < jobs; ++i) {
+            pool.post([&done] {
+                burn_job();
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }
+    while (done.load(std::memory_order_relaxed) < jobs) {
+        std::this_thread::yield();
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return PoolStats{jobs / secs, pool.get_metrics()};
+}
+
+struct AlarmLatency {
+    LatencyHistogram::Summary latency; // post -> start of the alarm job
+    uint64_t deadline_misses{};        // critical alarms past their 1 ms budget
+};
+
+// One "alarm" job per millisecond into a 2-worker pool kept saturated with a
+// backlog of ~200 derived-metric jobs (~20 us each): untagged alarms queue
+// behind the backlog (FIFO), JobPriority::Critical ones are dispatched EDF
+AlarmLatency run_alarm_latency(std::size_t alarms, bool critical)
+{
+    namespace device = telemetryhub::device;
+    ThreadPool pool(2);
+    std::atomic<std::size_t> backlog{0};
+    std::atomic<std::size_t> alarms_done{0};
+    LatencyHistogram latency;
+
+    auto metric_job = [&backlog] {
+        for (int i = 0; i < 100; ++i) {
+            burn_job();
+        }
+        backlog.fetch_sub(1, std::memory_order_relaxed);
+    };
+    auto next_alarm = chrono::steady_clock::now();
+    for (std::size_t sent = 0; sent < alarms;) {
+        while (backlog.load(std::memory_order_relaxed) < 200) {
+            backlog.fetch_add(1, std::memory_order_relaxed);
+            pool.post(metric_job);
+        }
+        if (chrono::steady_clock::now() < next_alarm) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int64_t posted = device::mono_ns();
+        auto alarm = [&latency, &alarms_done, posted] {
+            latency.record(static_cast<uint64_t>(device::mono_ns() - posted));
+            alarms_done.fetch_add(1, std::memory_order_relaxed);
+        };
+        if (critical) {
+            pool.post(alarm, JobPriority::Critical);
+        } else {
+            pool.post(alarm);
+        }
+        ++sent;
+        next_alarm += chrono::milliseconds(1);
+    }
+    while (alarms_done.load(std::memory_order_relaxed) < alarms) {
+        std::this_thread::yield();
+    }
+    const auto m = pool.get_metrics();
+    return AlarmLatency{latency.summary(),
+                        m.priorities[static_cast<std::size_t>(JobPriority::Critical)].deadline_misses};
+}
+
+struct ElasticRun {
+    double burst_ms{};           // mean time to drain one burst
+    uint64_t queue_wait_p99_ns{};
+    double idle_threads{};       // mean workers left at the end of each lull
+    ThreadPool::Metrics metrics{};
+};
+
+// `bursts` bursts of `jobs` derived-metric jobs (~20 us each) with a 150 ms
+// lull after each: fixed pools pay for their size either way, an elastic
+// one should drain bursts like the big pool and idle like the small one.
+// The controller runs 5x faster than the gateway default (10 ms ticks, one
+// worker retired per 30 ms idle) so a lull this short shows the shrink.
+ElasticRun run_elastic_bursts(std::size_t bursts, std::size_t jobs, ThreadPool::ElasticConfig cfg)
+{
+    cfg.interval = chrono::milliseconds(10);
+    cfg.shrink_ticks = 3;
+    ThreadPool pool(cfg);
+    std::atomic<std::size_t> done{0};
+    ElasticRun r;
+
+    for (std::size_t b = 0; b < bursts; ++b) {
+        const auto start = chrono::steady_clock::now();
+        for (std::size_t i = 0; i < jobs; ++i) {
+            pool.post([&done] {
+                for (int k = 0; k < 100; ++k) {
+                    burn_job();
+                }
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        while (done.load(std::memory_order_relaxed) < (b + 1) * jobs) {
+            std::this_thread::yield();
+        }
+        r.burst_ms += chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+        std::this_thread::sleep_for(chrono::milliseconds(150));
+        r.idle_threads += static_cast<double>(pool.thread_count());
+    }
+    r.burst_ms /= static_cast<double>(bursts);
+    r.idle_threads /= static_cast<double>(bursts);
+    r.metrics = pool.get_metrics();
+    r.queue_wait_p99_ns = r.metrics.queue_wait.p99_ns;
+    return r;
+}
+
+enum class KeyedMode { Unordered, GlobalSerial, StrandsUnbounded, Strands };
+
+struct FairnessRun {
+    double ms{};
+    LatencyHistogram::Summary hot;  // post -> start, the flooding key
+    LatencyHistogram::Summary cold; // post -> start, the other 63 keys
+    uint64_t out_of_order{};        // jobs that ran before an earlier job of their key
+};
+
+// `jobs` ~2 us jobs over 64 keys on 4 workers, posted in one burst; key 0
+// gets half of them. Unordered = plain post() (fast, but per-key order is
+// lost); GlobalSerial = one strand for everything (ordered, no
+// parallelism); StrandsUnbounded = per-key strands whose drains run until
+// empty (a hot key holds its worker); Strands = per-key with the default
+// budget, the hot strand yields after every kDefaultBudget jobs
+FairnessRun run_strand_fairness(std::size_t jobs, KeyedMode mode)
+{
+    namespace device = telemetryhub::device;
+    constexpr std::size_t kKeys = 64;
+    ThreadPool pool(4);
+    // One pointer in each job's captures keeps it within Task's inline buffer
+    struct Shared {
+        LatencyHistogram hot;
+        LatencyHistogram cold;
+        std::vector<std::atomic<std::size_t>> last = std::vector<std::atomic<std::size_t>>(kKeys);
+        std::atomic<uint64_t> out_of_order{0};
+        std::atomic<std::size_t> done{0};
+    } shared;
+    std::unique_ptr<StrandPool> strands;
+    if (mode != KeyedMode::Unordered) {
+        strands = std::make_unique<StrandPool>(pool, mode == KeyedMode::GlobalSerial ? 1 : 256, jobs,
+            mode == KeyedMode::StrandsUnbounded ? SIZE_MAX : StrandPool::kDefaultBudget);
+    }
+
+    const auto start = chrono::steady_clock::now();
+    for (std::size_t i = 0; i < jobs; ++i) {
+        const std::size_t key = i % 2 == 0 ? 0 : 1 + (i / 2) % (kKeys - 1);
+        const int64_t posted = device::mono_ns();
+        auto job = [&shared, key, i, posted] {
+            (key == 0 ? shared.hot : shared.cold).record(static_cast<uint64_t>(device::mono_ns() - posted));
+            for (int k = 0; k < 10; ++k) {
+                burn_job();
+            }
+            // Jobs of one key are numbered in post order (i + 1, 0 = none yet)
+            if (shared.last[key].exchange(i + 1, std::memory_order_relaxed) > i + 1) {
+                shared.out_of_order.fetch_add(1, std::memory_order_relaxed);
+            }
+            shared.done.fetch_add(1, std::memory_order_relaxed);
+        };
+        if (strands) {
+            strands->post(key, job);
+        } else {
+            pool.post(job);
+        }
+    }
+    while (shared.done.load(std::memory_order_relaxed) < jobs) {
+        std::this_thread::yield();
+    }
+    const double ms = chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+    return FairnessRun{ms, shared.hot.summary(), shared.cold.summary(), shared.out_of_order.load()};
+}
+
+// Voluntary + involuntary context switches of the whole process so far
+// (0 where getrusage is unavailable)
+uint64_t context_switches()
+{
+#if defined(__unix__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<uint64_t>(usage.ru_nvcsw) + static_cast<uint64_t>(usage.ru_nivcsw);
+    }
+#endif
+    return 0;
+}
+
+struct DeviceLoopRun {
+    std::size_t threads{};         // threads running the device loops
+    uint64_t context_switches{};
+    double cpu_ms{};
+    LatencyHistogram::Summary late; // scheduled wake -> actually running
+};
+
+CoTask periodic_device(chrono::steady_clock::time_point next, int ticks, chrono::microseconds period,
+                       LatencyHistogram& late)
+{
+    for (int i = 0; i < ticks; ++i) {
+        next += period;
+        co_await telemetryhub::gateway::sleep_until(next);
+        late.record(static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - next).count()));
+    }
+}
+
+// `devices` periodic acquisition loops, each waking every `period` for
+// `ticks` samples: one sleeping OS thread per device (coro_threads == 0) or
+// coroutines on a CoroExecutor with coro_threads loops. Devices are spread
+// evenly over the period, as independent devices would be.
+DeviceLoopRun run_device_loops(std::size_t devices, int ticks, chrono::microseconds period,
+                               std::size_t coro_threads)
+{
+    LatencyHistogram late;
+    DeviceLoopRun r;
+    const uint64_t switches_before = context_switches();
+    const std::clock_t cpu_start = std::clock();
+    const auto start = chrono::steady_clock::now();
+    auto phase = [&](std::size_t d) {
+        return start + period * static_cast<int64_t>(d) / static_cast<int64_t>(devices);
+    };
+    if (coro_threads == 0) {
+        std::vector<std::thread> threads;
+        threads.reserve(devices);
+        for (std::size_t d = 0; d < devices; ++d) {
+            threads.emplace_back([&late, next = phase(d), ticks, period]() mutable {
+                for (int i = 0; i < ticks; ++i) {
+                    next += period;
+                    std::this_thread::sleep_until(next);
+                    late.record(static_cast<uint64_t>(
+                        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - next).count()));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        r.threads = devices;
+    } else {
+        CoroExecutor executor(coro_threads);
+        for (std::size_t d = 0; d < devices; ++d) {
+            executor.spawn(periodic_device(phase(d), ticks, period, late));
+        }
+        executor.wait_idle();
+        r.threads = coro_threads;
+    }
+    r.cpu_ms = 1000.0 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    r.context_switches = context_switches() - switches_before;
+    r.late = late.summary();
+    return r;
+}
+
+CoTask ping_pong(int rounds)
+{
+    for (int i = 0; i < rounds; ++i) {
+        co_await telemetryhub::gateway::yield();
+    }
+}
+
+// Cost of handing control back and forth `rounds` times: two threads
+// trading a flag through mutex + condition variable vs two coroutines
+// yielding to each other on one loop. Returns ns per switch for each.
+std::pair<double, double> time_switch_cost(int rounds)
+{
+    std::mutex m;
+    std::condition_variable cv;
+    bool ping = true;
+    auto side = [&](bool mine) {
+        for (int i = 0; i < rounds; ++i) {
+            std::unique_lock lock(m);
+            cv.wait(lock, [&] { return ping == mine; });
+            ping = !mine;
+            cv.notify_one();
+        }
+    };
+    auto start = chrono::steady_clock::now();
+    std::thread other(side, false);
+    side(true);
+    other.join();
+    const double thread_ns = chrono::duration<double, std::nano>(chrono::steady_clock::now() - start).count();
+
+    CoroExecutor executor(1);
+    start = chrono::steady_clock::now();
+    executor.spawn(ping_pong(rounds));
+    executor.spawn(ping_pong(rounds));
+    executor.wait_idle();
+    const double coro_ns = chrono::duration<double, std::nano>(chrono::steady_clock::now() - start).count();
+    return {thread_ns / (2.0 * rounds), coro_ns / (2.0 * rounds)};
+}
+
+struct OffloadRun {
+    double ns_per_batch{};
+    LatencyHistogram::Summary latency; // batch ready -> processed
+    OffloadPolicy::Metrics policy;
+};
+
+// A consumer processing `batches` batches of 16 samples back to back, the
+// stage being scale + stats plus `burns` burn_job()s, with OffloadPolicy
+// deciding between running it inline and posting it to a 2-worker pool
+OffloadRun run_offload(std::size_t batches, int burns, OffloadMode mode)
+{
+    namespace device = telemetryhub::device;
+    constexpr std::size_t kSlots = 64;
+    constexpr std::size_t kSamples = 16;
+    ThreadPool pool(2);
+    OffloadPolicy policy(mode);
+    // One pointer in each job's captures keeps it within Task's inline buffer
+    struct Shared {
+        std::vector<SampleBatch> batch = std::vector<SampleBatch>(kSlots);
+        std::vector<std::atomic<bool>> busy = std::vector<std::atomic<bool>>(kSlots);
+        LatencyHistogram latency;
+        std::atomic<std::size_t> done{0};
+    } shared;
+    for (auto& b : shared.batch) {
+        for (std::size_t i = 0; i < kSamples; ++i) {
+            TelemetrySample s{};
+            s.value = static_cast<double>(i);
+            s.unit = kPerfUnit;
+            b.push_back(s);
+        }
+    }
+    auto process = [&shared, &policy, burns](std::size_t slot, int64_t ready, bool ran_inline) {
+        const int64_t started = device::mono_ns();
+        SampleBatch& b = shared.batch[slot];
+        b.scale_values(1.0000001);
+        volatile double keep = b.value_stats().sum;
+        (void)keep;
+        for (int k = 0; k < burns; ++k) {
+            burn_job();
+        }
+        const int64_t finished = device::mono_ns();
+        policy.record(kSamples, chrono::nanoseconds(finished - started), ran_inline);
+        shared.latency.record(static_cast<uint64_t>(finished - ready));
+        shared.busy[slot].store(false, std::memory_order_release);
+        shared.done.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    const auto start = chrono::steady_clock::now();
+    for (std::size_t i = 0; i < batches; ++i) {
+        const std::size_t slot = i % kSlots;
+        while (shared.busy[slot].load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        shared.busy[slot].store(true, std::memory_order_relaxed);
+        const int64_t ready = device::mono_ns();
+        if (policy.offload(kSamples)) {
+            pool.post([&process, slot, ready] { process(slot, ready, false); });
+        } else {
+            process(slot, ready, true);
+        }
+    }
+    while (shared.done.load(std::memory_order_relaxed) < batches) {
+        std::this_thread::yield();
+    }
+    const double ns = chrono::duration<double, std::nano>(chrono::steady_clock::now() - start).count();
+    return OffloadRun{ns / static_cast<double>(batches), shared.latency.summary(), policy.get_metrics()};
+}
+
+// Threads in this process right now (0 where /proc is unavailable)
+std::size_t process_threads()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("Threads:", 0) == 0) {
+            return static_cast<std::size_t>(std::stoul(line.substr(8)));
+        }
+    }
+    return 0;
+}
+
+struct PipelineRun {
+    double samples_per_sec{};
+    std::size_t threads{};          // process threads while running (incl. main)
+    double switches_per_sample{};
+    double cpu_us_per_sample{};
+    double sojourn_p50_ms{};
+    double sojourn_p99_ms{};
+};
+
+// The whole GatewayCore pipeline (simulated device -> queue -> processing)
+// for `duration`, sampling every `interval`, under one loop model / offload mode
+PipelineRun run_pipeline(LoopModel model, OffloadMode offload, chrono::microseconds interval,
+                         chrono::milliseconds duration)
+{
+    GatewayCore gw;
+    gw.set_loop_model(model);
+    gw.set_offload(offload);
+    gw.set_queue_capacity(1024);
+    gw.set_sampling_interval(chrono::duration_cast<chrono::milliseconds>(interval));
+    const uint64_t switches_before = context_switches();
+    const std::clock_t cpu_start = std::clock();
+    const auto start = chrono::steady_clock::now();
+    gw.start();
+    std::this_thread::sleep_for(duration / 2);
+    PipelineRun r;
+    r.threads = process_threads();
+    std::this_thread::sleep_for(duration / 2);
+    gw.stop();
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    const double cpu_us = 1e6 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    const auto m = gw.get_metrics();
+    const double samples = static_cast<double>(std::max<uint64_t>(1, m.samples_processed));
+    r.samples_per_sec = samples / seconds;
+    r.switches_per_sample = static_cast<double>(context_switches() - switches_before) / samples;
+    r.cpu_us_per_sample = cpu_us / samples;
+    r.sojourn_p50_ms = m.queue_sojourn_p50_ms;
+    r.sojourn_p99_ms = m.queue_sojourn_p99_ms;
+    return r;
+}
+
+struct JobCost {
+    double ns_per_job{};
+    double allocs_per_job{}; // operator new calls (perf_tool links the HeapGuard hook)
+};
+
+// Submission + dispatch overhead of trivial jobs on a one-worker pool, at
+// most 64 in flight (within the job arena); `enqueue(pool, done)` queues one
+// job that bumps `done` by one
+template <typename Enqueue>
+JobCost time_pool_jobs(std::size_t jobs, Enqueue enqueue)
+{
+    ThreadPool pool(1);
+    std::atomic<std::size_t> done{0};
+    pool.reserve(jobs);
+
+    const auto allocs_before = HeapGuard::get_metrics().allocations;
+    auto start = chrono::steady_clock::now();
+    for (std::size_t i = 0; i < jobs; ++i) {
+        while (i - done.load(std::memory_order_relaxed) >= 64) {
+            std::this_thread::yield();
+        }
+        enqueue(pool, done);
+    }
+    while (done.load(std::memory_order_relaxed) < jobs) {
+        std::this_thread::yield();
+    }
+    const double ns = chrono::duration<double, std::nano>(chrono::steady_clock::now() - start).count();
+    const auto allocs = HeapGuard::get_metrics().allocations - allocs_before;
+    return JobCost{ns / static_cast<double>(jobs),
+                   static_cast<double>(allocs) / static_cast<double>(jobs)};
+}
+
+struct RangeTimes {
+    double serial_ms{};
+    double futures_ms{};
+    double reduce_ms{};
+};
+
+// Stats over one large value column (a history window): the serial kernel,
+// one submit() + future per chunk, and parallel_reduce over the same chunks
+RangeTimes time_range_stats(std::size_t n, std::size_t threads, std::size_t grain)
+{
+    std::vector<double> values(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        values[i] = static_cast<double>(i % 1000);
+    }
+    const std::span<const double> column(values);
+    auto chunk_stats = [&](std::size_t b, std::size_t e) {
+        return SampleBatch::value_stats(column.subspan(b, e - b));
+    };
+    ThreadPool pool(threads);
+    RangeTimes t;
+
+    auto start = chrono::steady_clock::now();
+    auto serial = SampleBatch::value_stats(column);
+    t.serial_ms = chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    std::vector<std::future<SampleBatch::ValueStats>> futures;
+    for (std::size_t b = 0; b < n; b += grain) {
+        futures.push_back(pool.submit(chunk_stats, b, std::min(n, b + grain)));
+    }
+    SampleBatch::ValueStats via_futures;
+    for (auto& f : futures) {
+        via_futures.merge(f.get());
+    }
+    t.futures_ms = chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    auto reduced = pool.parallel_reduce(std::size_t{0}, n, SampleBatch::ValueStats{}, chunk_stats,
+        [](SampleBatch::ValueStats acc, const SampleBatch::ValueStats& part) {
+            acc.merge(part);
+            return acc;
+        }, grain);
+    t.reduce_ms = chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count();
+
+    volatile double keep = serial.sum + via_futures.sum + reduced.sum;
+    (void)keep;
+    return t;
+}
+
 int main(int argc, char** argv)
 {
     std::size_t n = 1'000'000; // default ops
@@ -105,5 +831,196 @@ int main(int argc, char** argv)
     double speedup = move_stats.ops_per_sec / copy_stats.ops_per_sec;
     std::cout << "speedup (move/copy): " << speedup << "x\n";
 
+    const double copy_ns = time_sample_transfer(n, false);
+    const double move_ns = time_sample_transfer(n, true);
+    std::cout << "sample (" << sizeof(TelemetrySample) << " bytes): copy " << copy_ns
+              << " ns, move " << move_ns << " ns\n";
+
+    // Lock-free SPSC ring (same single producer -> single consumer hop as GatewayCore)
+    auto spsc_stats = run_test_move(n, QueueBackend::Spsc);
+    std::cout << "spsc:  "
+              << spsc_stats.ops << " ops in " << spsc_stats.seconds << " s, "
+              << static_cast<long long>(spsc_stats.ops_per_sec) << " ops/s"
+              << " (consumed " << spsc_stats.consumed << ", dropped "
+              << (spsc_stats.ops - spsc_stats.consumed) << ")\n";
+    std::cout << "speedup (spsc/mutex move): "
+              << spsc_stats.ops_per_sec / move_stats.ops_per_sec << "x\n";
+
+    // Batched push_bulk/pop_batch: one lock + one wakeup per batch instead of per sample
+    for (std::size_t batch : {1, 8, 64, 256}) {
+        auto b = run_test_batch(n, batch);
+        std::cout << "batch " << batch << ":"
+                  << std::string(batch < 10 ? 3 : batch < 100 ? 2 : 1, ' ')
+                  << b.ops << " ops in " << b.seconds << " s, "
+                  << static_cast<long long>(b.ops_per_sec) << " ops/s"
+                  << " (x" << b.ops_per_sec / move_stats.ops_per_sec << " vs move)\n";
+    }
+
+    const auto [aos_ns, soa_ns] = time_batch_stats(n);
+    std::cout << "batch stats: aos " << aos_ns << " ns/sample, soa " << soa_ns
+              << " ns/sample (x" << aos_ns / soa_ns << ")\n";
+
+    // Per-read cost of the timestamp sources (one per sample and per pipeline stamp)
+    namespace device = telemetryhub::device;
+    (void)device::mono_ns(); // calibrate outside the timed loop
+    std::cout << "clock (" << device::to_string(device::timestamp_source()) << "): "
+              << "system_clock " << time_clock_read(n, [] {
+                     return chrono::system_clock::now().time_since_epoch().count();
+                 })
+              << " ns, steady_clock " << time_clock_read(n, [] {
+                     return chrono::steady_clock::now().time_since_epoch().count();
+                 })
+              << " ns, mono_ns " << time_clock_read(n, [] { return device::mono_ns(); })
+              << " ns, wall_ns " << time_clock_read(n, [] { return device::wall_ns(); }) << " ns\n";
+
+    // Idle-consumer wakeup latency vs CPU burned while waiting
+    const std::size_t wait_samples = std::max<std::size_t>(1000, n / 200);
+    for (auto wait : {WaitStrategy::Block, WaitStrategy::SpinThenPark, WaitStrategy::Futex,
+                      WaitStrategy::Spin}) {
+        auto w = run_wait_latency(wait_samples, wait, QueueBackend::Spsc);
+        std::cout << "wait " << telemetryhub::gateway::to_string(wait) << ":"
+                  << std::string(15 - std::string(telemetryhub::gateway::to_string(wait)).size(), ' ')
+                  << "p50 " << w.p50_us << " us, p99 " << w.p99_us << " us, cpu "
+                  << static_cast<int>(w.cpu_percent) << "%\n";
+    }
+
+    // Per-job pool overhead: submit() with a discarded future (the old
+    // consumer pattern) vs fire-and-forget post() of a sample-sized job
+    const std::size_t cost_jobs = std::max<std::size_t>(10000, n / 10);
+    TelemetrySample job_sample{};
+    job_sample.unit = kPerfUnit;
+    auto report_cost = [](const char* label, JobCost c) {
+        std::cout << "pool job " << label << c.ns_per_job << " ns/job, "
+                  << c.allocs_per_job << " allocs/job\n";
+    };
+    report_cost("submit (future):  ", time_pool_jobs(cost_jobs, [&](ThreadPool& pool, auto& done) {
+        (void)pool.submit([&done](TelemetrySample s) {
+            done.fetch_add(1 + s.sequence_id, std::memory_order_relaxed);
+        }, job_sample);
+    }));
+    report_cost("post (pointer):   ", time_pool_jobs(cost_jobs, [&](ThreadPool& pool, auto& done) {
+        pool.post([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+    }));
+    report_cost("post (sample):    ", time_pool_jobs(cost_jobs, [&](ThreadPool& pool, auto& done) {
+        pool.post([&done, s = job_sample] { done.fetch_add(1 + s.sequence_id, std::memory_order_relaxed); });
+    }));
+
+    // Inline vs pool for a trivial and a heavier processing stage
+    const std::size_t offload_batches = std::max<std::size_t>(20000, n / 20);
+    for (auto [stage, burns] : {std::pair{"cheap stage (scale + stats)", 0},
+                                std::pair{"heavy stage (+100 burn jobs)", 100}}) {
+        const std::size_t count = burns == 0 ? offload_batches : offload_batches / 20;
+        std::cout << "offload, " << stage << ", " << count << " batches of 16:\n";
+        for (auto mode : {OffloadMode::Pool, OffloadMode::Inline, OffloadMode::Auto}) {
+            auto o = run_offload(count, burns, mode);
+            std::cout << "  " << telemetryhub::gateway::to_string(mode) << ":"
+                      << std::string(8 - std::string(telemetryhub::gateway::to_string(mode)).size(), ' ')
+                      << o.ns_per_batch << " ns/batch, latency p50 " << o.latency.p50_ns / 1000.0
+                      << " us, p99 " << o.latency.p99_ns / 1000.0 << " us, inline " << o.policy.inline_jobs
+                      << ", pool " << o.policy.offloaded_jobs << ", cost " << o.policy.cost_ns_per_item
+                      << " ns/sample\n";
+        }
+    }
+
+    // Time-critical jobs in a saturated pool: FIFO vs EDF (JobPriority::Critical)
+    const std::size_t alarms = std::max<std::size_t>(200, n / 1000);
+    for (bool critical : {false, true}) {
+        auto a = run_alarm_latency(alarms, critical);
+        std::cout << "alarm latency (" << (critical ? "critical" : "untagged") << "):"
+                  << std::string(critical ? 1 : 2, ' ')
+                  << "p50 " << a.latency.p50_ns / 1000.0 << " us, p99 "
+                  << a.latency.p99_ns / 1000.0 << " us, max " << a.latency.max_ns / 1000.0 << " us";
+        if (critical) {
+            std::cout << ", deadline misses " << a.deadline_misses << "/" << alarms;
+        }
+        std::cout << "\n";
+    }
+
+    // Per-key ordering: plain pool vs one global strand vs per-key strands
+    const std::size_t keyed_jobs = std::max<std::size_t>(20000, n / 50);
+    std::cout << "keyed jobs (" << keyed_jobs << " jobs, 64 keys, key 0 gets half, 4 workers):\n";
+    for (auto [label, mode] : {std::pair{"unordered:        ", KeyedMode::Unordered},
+                               std::pair{"global serial:    ", KeyedMode::GlobalSerial},
+                               std::pair{"strands unbounded:", KeyedMode::StrandsUnbounded},
+                               std::pair{"strands budget 16:", KeyedMode::Strands}}) {
+        auto f = run_strand_fairness(keyed_jobs, mode);
+        std::cout << "  " << label << " " << f.ms << " ms, hot p99 " << f.hot.p99_ns / 1000.0
+                  << " us, cold p50 " << f.cold.p50_ns / 1000.0 << " us, cold p99 " << f.cold.p99_ns / 1000.0
+                  << " us, out of order " << f.out_of_order << "\n";
+    }
+
+    // Many slow devices: one sleeping thread each vs coroutines on an executor
+    const std::size_t devices = 1000;
+    const int device_ticks = 100;
+    std::cout << "device loops (" << devices << " devices, 10 ms period, " << device_ticks << " samples each):\n";
+    for (auto [label, coro_threads] : {std::pair{"thread per device:", std::size_t{0}},
+                                       std::pair{"coroutines, 1 loop:", std::size_t{1}},
+                                       std::pair{"coroutines, 2 loops:", std::size_t{2}}}) {
+        auto d = run_device_loops(devices, device_ticks, chrono::milliseconds(10), coro_threads);
+        std::cout << "  " << label << std::string(21 - std::string(label).size(), ' ') << d.threads
+                  << " threads, " << d.context_switches << " context switches, cpu " << d.cpu_ms
+                  << " ms, wake late p50 " << d.late.p50_ns / 1000.0 << " us, p99 " << d.late.p99_ns / 1000.0
+                  << " us\n";
+    }
+    const int switch_rounds = static_cast<int>(std::max<std::size_t>(10000, n / 20));
+    const auto [thread_switch_ns, coro_switch_ns] = time_switch_cost(switch_rounds);
+    std::cout << "switch cost: threads (condvar) " << thread_switch_ns << " ns, coroutines (yield) "
+              << coro_switch_ns << " ns\n";
+
+    // Full pipeline: thread per role vs everything on one loop thread.
+    // Per-batch log lines would dominate, so only warnings are logged here.
+    telemetryhub::Logger::instance().set_level(telemetryhub::LogLevel::Warn);
+    std::cout << "gateway pipeline (1 ms sampling, 2 s each, "
+              << std::thread::hardware_concurrency() << " hardware threads):\n";
+    for (auto [label, model, offload] : {std::tuple{"threads, pool offload:", LoopModel::Threads, OffloadMode::Pool},
+                                         std::tuple{"threads, auto offload:", LoopModel::Threads, OffloadMode::Auto},
+                                         std::tuple{"coroutines, auto:     ", LoopModel::Coroutines, OffloadMode::Auto},
+                                         std::tuple{"single thread:        ", LoopModel::Single, OffloadMode::Auto}}) {
+        auto p = run_pipeline(model, offload, chrono::milliseconds(1), chrono::milliseconds(2000));
+        std::cout << "  " << label << " " << p.threads << " threads, "
+                  << static_cast<long long>(p.samples_per_sec) << " samples/s, "
+                  << p.switches_per_sample << " switches/sample, cpu " << p.cpu_us_per_sample
+                  << " us/sample, sojourn p50 " << p.sojourn_p50_ms << " ms, p99 " << p.sojourn_p99_ms
+                  << " ms\n";
+    }
+
+    // Fixed vs elastic pool sizing under bursty load
+    const std::size_t big = std::max<std::size_t>(4, std::thread::hardware_concurrency());
+    const std::size_t burst_jobs = std::max<std::size_t>(2000, n / 500);
+    std::cout << "elastic pool (10 bursts of " << burst_jobs << " jobs, 150 ms lulls):\n";
+    for (auto [label, min_threads, max_threads] : {std::tuple{"fixed 1:      ", std::size_t{1}, std::size_t{1}},
+                                                   std::tuple{"fixed max:    ", big, big},
+                                                   std::tuple{"elastic 1-max:", std::size_t{1}, big}}) {
+        ThreadPool::ElasticConfig cfg;
+        cfg.min_threads = min_threads;
+        cfg.max_threads = max_threads;
+        auto e = run_elastic_bursts(10, burst_jobs, cfg);
+        std::cout << "  " << label << " burst " << e.burst_ms << " ms, queue wait p99 "
+                  << e.queue_wait_p99_ns / 1e6 << " ms, idle workers " << e.idle_threads
+                  << ", started " << e.metrics.workers_started << ", retired " << e.metrics.workers_retired
+                  << "\n";
+    }
+
+    // Chunked range analytics: N futures vs one parallel_reduce
+    for (std::size_t grain : {4096, 65536}) {
+        auto r = time_range_stats(std::max<std::size_t>(n, 1 << 20), 4, grain);
+        std::cout << "range stats (grain " << grain << "): serial " << r.serial_ms << " ms, futures "
+                  << r.futures_ms << " ms, parallel_reduce " << r.reduce_ms << " ms\n";
+    }
+
+    // Work-stealing pool scaling: external posts vs fan-out from inside the pool
+    const std::size_t pool_jobs = std::max<std::size_t>(10000, n / 10);
+    std::cout << "pool scaling (" << pool_jobs << " jobs, "
+              << std::thread::hardware_concurrency() << " hardware threads):\n";
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        auto ext = run_pool_scaling(pool_jobs, threads, false);
+        auto fan = run_pool_scaling(pool_jobs, threads, true);
+        std::cout << "  " << threads << " worker(s):" << std::string(threads < 10 ? 2 : 1, ' ')
+                  << "post " << static_cast<long long>(ext.jobs_per_sec) << " jobs/s, "
+                  << "fan-out " << static_cast<long long>(fan.jobs_per_sec) << " jobs/s "
+                  << "(local " << fan.metrics.jobs_local << ", stolen " << fan.metrics.jobs_stolen
+                  << ")\n";
+    }
+
     return 0;
 }
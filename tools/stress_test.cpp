@@ -2,8 +2,12 @@
 // Stress test for TelemetryQueue with multiple producers and consumers
 // Run 10 producers, 5 consumers for configurable duration
 // Measure: throughput, memory usage, CPU usage, queue performance
+// --backend selects the queue storage; --sweep compares backends across
+// producer/consumer counts; --pin-compare runs the same shape unpinned and
+// pinned (--pin) back to back.
 
 #include "telemetryhub/gateway/TelemetryQueue.h"
+#include "telemetryhub/gateway/ThreadAffinity.h"
 #include <iostream>
 #include <thread>
 #include <vector>
@@ -11,6 +15,10 @@
 #include <chrono>
 #include <cstring>
 #include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <utility>
 
 using namespace telemetryhub::gateway;
 using namespace telemetryhub::device;
@@ -23,32 +31,78 @@ struct StressTestConfig {
     std::chrono::seconds duration{60};
     size_t queue_capacity = 1000;  // Bounded queue
     size_t samples_per_producer = 1000000;  // Target samples per producer
+    QueueBackend backend = QueueBackend::Mutex;
+    bool sweep = false;   // Run the backend x producer/consumer matrix
+    bool quiet = false;   // Suppress per-thread and monitor output
+    // Pin thread i (producers first, then consumers) to cpus[i % size];
+    // empty = unpinned
+    std::vector<int> cpus;
+    bool pin_compare = false; // Run unpinned, then pinned to cpus
+};
+
+struct StressTestResult {
+    uint64_t produced{0};
+    uint64_t consumed{0};
+    uint64_t errors{0};
+    double seconds{0.0};
+    uint64_t migrations{0}; // times a thread was seen on a different CPU than before
 };
 
 // Global counters for statistics
 std::atomic<uint64_t> g_produced{0};
 std::atomic<uint64_t> g_consumed{0};
 std::atomic<uint64_t> g_errors{0};
+std::atomic<uint64_t> g_migrations{0};
+
+// Names and pins the calling stress thread; returns the CPU it starts on
+int place_thread(const char* role, size_t global_index, const StressTestConfig& config)
+{
+    const std::string name = std::string("stress-") + role + "-" + std::to_string(global_index);
+    set_current_thread_name(name.c_str());
+    if (!config.cpus.empty()) {
+        pin_current_thread({config.cpus[global_index % config.cpus.size()]});
+    }
+    return current_cpu();
+}
+
+// Samples the current CPU every 4096 operations and counts changes
+struct MigrationCounter {
+    int cpu;
+    uint64_t seen{0};
+    void tick(uint64_t n)
+    {
+        if ((n & 4095) != 0) return;
+        const int now = current_cpu();
+        if (now != cpu) {
+            ++seen;
+            cpu = now;
+        }
+    }
+    ~MigrationCounter() { g_migrations.fetch_add(seen, std::memory_order_relaxed); }
+};
 
 // Producer thread function
 void producer_thread(TelemetryQueue& queue, size_t producer_id, 
                      const StressTestConfig& config, std::atomic<bool>& running)
 {
+    MigrationCounter migrations{place_thread("prod", producer_id, config)};
     uint64_t local_produced = 0;
     uint64_t seq_id = producer_id * 1000000;  // Unique sequence range per producer
+    const telemetryhub::device::Unit unit{"unit"};  // intern once, not per sample
     
     while (running.load() && local_produced < config.samples_per_producer)
     {
         TelemetrySample sample;
         sample.sequence_id = seq_id++;
         sample.value = static_cast<double>(producer_id) + 0.001 * local_produced;
-        sample.unit = "unit";
-        sample.timestamp = std::chrono::system_clock::now();
+        sample.unit = unit;
+        sample.timestamp_ns = telemetryhub::device::wall_ns();
         
         try {
             queue.push(std::move(sample));  // Use move semantics for performance
             local_produced++;
             g_produced.fetch_add(1, std::memory_order_relaxed);
+            migrations.tick(local_produced);
         } catch (const std::exception& e) {
             g_errors.fetch_add(1, std::memory_order_relaxed);
         }
@@ -57,13 +111,17 @@ void producer_thread(TelemetryQueue& queue, size_t producer_id,
         // std::this_thread::sleep_for(std::chrono::microseconds(10));
     }
     
-    std::cout << "[Producer " << producer_id << "] Finished, produced " 
-              << local_produced << " samples\n";
+    if (!config.quiet) {
+        std::cout << "[Producer " << producer_id << "] Finished, produced "
+                  << local_produced << " samples\n";
+    }
 }
 
 // Consumer thread function
-void consumer_thread(TelemetryQueue& queue, size_t consumer_id, std::atomic<bool>& running)
+void consumer_thread(TelemetryQueue& queue, size_t consumer_id,
+                     const StressTestConfig& config, std::atomic<bool>& running)
 {
+    MigrationCounter migrations{place_thread("cons", config.num_producers + consumer_id, config)};
     uint64_t local_consumed = 0;
     
     while (running.load())
@@ -76,14 +134,17 @@ void consumer_thread(TelemetryQueue& queue, size_t consumer_id, std::atomic<bool
         
         local_consumed++;
         g_consumed.fetch_add(1, std::memory_order_relaxed);
+        migrations.tick(local_consumed);
         
         // Simulate minimal processing
         volatile double dummy = sample->value * 1.001;
         (void)dummy;
     }
     
-    std::cout << "[Consumer " << consumer_id << "] Finished, consumed " 
-              << local_consumed << " samples\n";
+    if (!config.quiet) {
+        std::cout << "[Consumer " << consumer_id << "] Finished, consumed "
+                  << local_consumed << " samples\n";
+    }
 }
 
 // Monitor thread to print statistics
@@ -143,6 +204,24 @@ void parse_args(int argc, char* argv[], StressTestConfig& config)
         else if (arg == "--samples" && i + 1 < argc) {
             config.samples_per_producer = std::stoul(argv[++i]);
         }
+        else if (arg == "--backend" && i + 1 < argc) {
+            if (!parse_queue_backend(argv[++i], config.backend)) {
+                std::cerr << "Unknown backend '" << argv[i] << "' (mutex|spsc|mpmc)\n";
+                exit(2);
+            }
+        }
+        else if (arg == "--sweep") {
+            config.sweep = true;
+        }
+        else if (arg == "--pin" && i + 1 < argc) {
+            if (!parse_cpu_list(argv[++i], config.cpus)) {
+                std::cerr << "Bad CPU list '" << argv[i] << "' (e.g. 0-3,8)\n";
+                exit(2);
+            }
+        }
+        else if (arg == "--pin-compare") {
+            config.pin_compare = true;
+        }
         else if (arg == "--help" || arg == "-h") {
             std::cout << "Usage: stress_test [OPTIONS]\n"
                       << "Options:\n"
@@ -151,34 +230,38 @@ void parse_args(int argc, char* argv[], StressTestConfig& config)
                       << "  --consumers <count>      Number of consumer threads (default: 5)\n"
                       << "  --queue-capacity <size>  Bounded queue size (default: 1000)\n"
                       << "  --samples <count>        Samples per producer (default: 1000000)\n"
+                      << "  --backend <name>         Queue backend: mutex | spsc | mpmc (default: mutex)\n"
+                      << "  --sweep                  Compare mutex/mpmc (and spsc at 1x1) across\n"
+                      << "                           producer/consumer counts; --duration is per cell\n"
+                      << "  --pin <cpus>             Pin producers, then consumers, one CPU each\n"
+                      << "                           round-robin over a list like 0-3,8\n"
+                      << "  --pin-compare            Run unpinned, then pinned (--pin, default: all\n"
+                      << "                           CPUs), and compare; --duration is per run\n"
                       << "  --help, -h               Show this help\n";
             exit(0);
         }
     }
 }
 
-int main(int argc, char* argv[])
+// One timed run with the given configuration; resets the global counters.
+StressTestResult run_stress(const StressTestConfig& config)
 {
-    StressTestConfig config;
-    parse_args(argc, argv, config);
-    
-    std::cout << "=== TelemetryQueue Stress Test ===\n";
-    std::cout << "Configuration:\n";
-    std::cout << "  Producers: " << config.num_producers << "\n";
-    std::cout << "  Consumers: " << config.num_consumers << "\n";
-    std::cout << "  Duration: " << config.duration.count() << "s\n";
-    std::cout << "  Queue Capacity: " << config.queue_capacity << " (bounded)\n";
-    std::cout << "  Samples per Producer: " << config.samples_per_producer << "\n";
-    std::cout << "==================================\n\n";
-    
+    g_produced = 0;
+    g_consumed = 0;
+    g_errors = 0;
+    g_migrations = 0;
+
     // Create queue with bounded capacity
-    TelemetryQueue queue(config.queue_capacity);
+    TelemetryQueue queue(config.queue_capacity, config.backend);
     
     // Control flag
     std::atomic<bool> running{true};
     
     // Start monitor thread
-    std::thread monitor(monitor_thread, std::cref(running), std::cref(config));
+    std::thread monitor;
+    if (!config.quiet) {
+        monitor = std::thread(monitor_thread, std::cref(running), std::cref(config));
+    }
     
     // Launch producer threads
     std::vector<std::thread> producers;
@@ -192,7 +275,8 @@ int main(int argc, char* argv[])
     std::vector<std::thread> consumers;
     consumers.reserve(config.num_consumers);
     for (size_t i = 0; i < config.num_consumers; ++i) {
-        consumers.emplace_back(consumer_thread, std::ref(queue), i, std::ref(running));
+        consumers.emplace_back(consumer_thread, std::ref(queue), i,
+                               std::cref(config), std::ref(running));
     }
     
     auto start = std::chrono::steady_clock::now();
@@ -210,10 +294,11 @@ int main(int argc, char* argv[])
         }
     }
     
-    std::cout << "\n[Main] All producers finished. Waiting for consumers to drain queue...\n";
-    
-    // Wait a bit for consumers to drain the queue
-    std::this_thread::sleep_for(2s);
+    if (!config.quiet) {
+        std::cout << "\n[Main] All producers finished. Waiting for consumers to drain queue...\n";
+        // Wait a bit for consumers to drain the queue
+        std::this_thread::sleep_for(2s);
+    }
     
     // Shutdown queue to unblock consumers
     queue.shutdown();
@@ -231,12 +316,130 @@ int main(int argc, char* argv[])
     }
     
     auto end = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(end - start);
+
+    StressTestResult r;
+    r.produced = g_produced.load();
+    r.consumed = g_consumed.load();
+    r.errors = g_errors.load();
+    r.migrations = g_migrations.load();
+    r.seconds = std::chrono::duration<double>(end - start).count();
+    return r;
+}
+
+// Backend x producer/consumer matrix. Prints consumed ops/sec per cell.
+int run_sweep(StressTestConfig config)
+{
+    const std::pair<size_t, size_t> shapes[] = {{1, 1}, {2, 2}, {4, 4}, {10, 5}, {16, 8}};
+    const QueueBackend backends[] = {QueueBackend::Mutex, QueueBackend::Mpmc, QueueBackend::Spsc};
+    config.quiet = true;
+    // Cells are time-bound; do not let the per-producer cap flatten the numbers
+    config.samples_per_producer = std::numeric_limits<size_t>::max();
+
+    std::cout << "=== TelemetryQueue Backend Sweep ===\n";
+    std::cout << "  Duration per cell: " << config.duration.count() << "s"
+              << " | Queue Capacity: " << config.queue_capacity << "\n\n";
+    std::cout << std::left << std::setw(10) << "backend" << std::setw(14) << "prod x cons"
+              << std::right << std::setw(16) << "produced/s" << std::setw(16) << "consumed/s"
+              << std::setw(10) << "lost %" << "\n";
+
+    for (auto backend : backends) {
+        for (auto [p, c] : shapes) {
+            // SPSC is only correct with a single producer and a single consumer
+            if (backend == QueueBackend::Spsc && (p != 1 || c != 1)) {
+                continue;
+            }
+            config.backend = backend;
+            config.num_producers = p;
+            config.num_consumers = c;
+            auto r = run_stress(config);
+            const double secs = std::max(1e-9, r.seconds);
+            const double lost = r.produced > 0
+                ? 100.0 * static_cast<double>(r.produced - r.consumed) / r.produced : 0.0;
+            std::cout << std::left << std::setw(10) << to_string(backend)
+                      << std::setw(14) << (std::to_string(p) + " x " + std::to_string(c))
+                      << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(16) << r.produced / secs
+                      << std::setw(16) << r.consumed / secs
+                      << std::setprecision(2) << std::setw(10) << lost << "\n";
+        }
+    }
+    return 0;
+}
+
+// Same shape unpinned, then pinned; prints throughput and observed migrations.
+int run_pin_compare(StressTestConfig config)
+{
+    if (config.cpus.empty()) {
+        const int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int c = 0; c < n; ++c) {
+            config.cpus.push_back(c);
+        }
+    }
+    const std::vector<int> pinned = config.cpus;
+    config.quiet = true;
+    config.samples_per_producer = std::numeric_limits<size_t>::max();
+
+    std::cout << "=== Pinned vs Unpinned ===\n";
+    std::cout << "  Backend: " << to_string(config.backend)
+              << " | " << config.num_producers << " x " << config.num_consumers
+              << " | Duration per run: " << config.duration.count() << "s"
+              << " | CPUs: " << format_cpu_list(pinned) << "\n\n";
+    std::cout << std::left << std::setw(10) << "mode"
+              << std::right << std::setw(16) << "produced/s" << std::setw(16) << "consumed/s"
+              << std::setw(10) << "lost %" << std::setw(12) << "migrations" << "\n";
+
+    for (bool pin : {false, true}) {
+        config.cpus = pin ? pinned : std::vector<int>{};
+        auto r = run_stress(config);
+        const double secs = std::max(1e-9, r.seconds);
+        const double lost = r.produced > 0
+            ? 100.0 * static_cast<double>(r.produced - r.consumed) / r.produced : 0.0;
+        std::cout << std::left << std::setw(10) << (pin ? "pinned" : "unpinned")
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(16) << r.produced / secs
+                  << std::setw(16) << r.consumed / secs
+                  << std::setprecision(2) << std::setw(10) << lost
+                  << std::setw(12) << r.migrations << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    StressTestConfig config;
+    parse_args(argc, argv, config);
+
+    if (config.sweep) {
+        return run_sweep(config);
+    }
+    if (config.pin_compare) {
+        return run_pin_compare(config);
+    }
+    
+    std::cout << "=== TelemetryQueue Stress Test ===\n";
+    std::cout << "Configuration:\n";
+    std::cout << "  Backend: " << to_string(config.backend) << "\n";
+    std::cout << "  Producers: " << config.num_producers << "\n";
+    std::cout << "  Consumers: " << config.num_consumers << "\n";
+    std::cout << "  Duration: " << config.duration.count() << "s\n";
+    std::cout << "  Queue Capacity: " << config.queue_capacity << " (bounded)\n";
+    std::cout << "  Samples per Producer: " << config.samples_per_producer << "\n";
+    std::cout << "  Pinned to CPUs: " << (config.cpus.empty() ? "no" : format_cpu_list(config.cpus)) << "\n";
+    std::cout << "==================================\n\n";
+
+    if (config.backend == QueueBackend::Spsc &&
+        (config.num_producers != 1 || config.num_consumers != 1)) {
+        std::cerr << "spsc backend requires --producers 1 --consumers 1\n";
+        return 2;
+    }
+
+    auto result = run_stress(config);
+    auto elapsed = std::chrono::seconds(static_cast<long long>(result.seconds));
     
     // Final statistics
-    uint64_t total_produced = g_produced.load();
-    uint64_t total_consumed = g_consumed.load();
-    uint64_t total_errors = g_errors.load();
+    uint64_t total_produced = result.produced;
+    uint64_t total_consumed = result.consumed;
+    uint64_t total_errors = result.errors;
     uint64_t lost = total_produced - total_consumed;
     
     std::cout << "\n=== Final Results ===\n";
@@ -247,6 +450,7 @@ int main(int argc, char* argv[])
               << (total_produced > 0 ? (100.0 * lost / total_produced) : 0.0) 
               << "%)\n";
     std::cout << "Errors: " << total_errors << "\n";
+    std::cout << "CPU migrations observed: " << result.migrations << "\n";
     std::cout << "\nThroughput:\n";
     std::cout << "  Produced: " << (total_produced / std::max(1.0, static_cast<double>(elapsed.count()))) 
               << " ops/sec\n";